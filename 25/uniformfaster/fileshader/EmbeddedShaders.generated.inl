@@ -0,0 +1,823 @@
+// generated by tools/embed_shaders.py from res/shaders, don't edit
+// included by EmbeddedShaders.h inside namespace EmbeddedShaders
+
+inline constexpr const char* Files0[] = { "res/shaders/AttribMesh.shader", "res/shaders/include/Lighting.glsl" };
+inline constexpr const char* Files1[] = { "res/shaders/Basic.shader" };
+inline constexpr const char* Files2[] = { "res/shaders/ColorQuad.shader" };
+inline constexpr const char* Files3[] = { "res/shaders/Culling.shader" };
+inline constexpr const char* Files4[] = { "res/shaders/Instanced.shader" };
+inline constexpr const char* Files5[] = { "res/shaders/Material.shader", "res/shaders/include/Lighting.glsl" };
+inline constexpr const char* Files6[] = { "res/shaders/Mesh.shader" };
+inline constexpr const char* Files7[] = { "res/shaders/MeshTextured.shader" };
+inline constexpr const char* Files8[] = { "res/shaders/Particle.shader" };
+inline constexpr const char* Files9[] = { "res/shaders/ParticleUpdate.shader" };
+inline constexpr const char* Files10[] = { "res/shaders/PulledMesh.shader", "res/shaders/include/Lighting.glsl" };
+inline constexpr const char* Files11[] = { "res/shaders/PulledMeshStorage.shader", "res/shaders/include/Lighting.glsl" };
+inline constexpr const char* Files12[] = { "res/shaders/Sprite.shader" };
+inline constexpr const char* Files13[] = { "res/shaders/SpriteSimulation.shader" };
+inline constexpr const char* Files14[] = { "res/shaders/Tilemap.shader" };
+inline constexpr const char* Files15[] = { "res/shaders/WaveImage.shader" };
+
+inline constexpr Entry Table[] = {
+	{
+		"res/shaders/AttribMesh.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 7 0\n"
+		"layout(location=0)in vec3 position;\n"
+		"layout(location=1)in vec3 normal;\n"
+		"layout(location=2)in vec4 color;\n"
+		"\n"
+		"\n"
+		"uniform samplerBuffer u_Instances;\n"
+		"\n"
+		"uniform int u_InstanceBase;\n"
+		"uniform mat4 u_ViewProjection;\n"
+		"\n"
+		"out vec3 v_Normal;\n"
+		"out vec4 v_Color;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"int instance=(u_InstanceBase+gl_InstanceID)*2;\n"
+		"vec4 positionScale=texelFetch(u_Instances,instance);\n"
+		"vec4 instanceColor=texelFetch(u_Instances,instance+1);\n"
+		"\n"
+		"gl_Position=u_ViewProjection*vec4(position*positionScale.w+positionScale.xyz,1.0);\n"
+		"v_Normal=normal;\n"
+		"v_Color=instanceColor*color;\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 3 1\n"
+		"const vec3 c_LightDirection=vec3(0.3,1.0,0.5);\n"
+		"#line 37 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec3 v_Normal;\n"
+		"in vec4 v_Color;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"color=vec4(vec3(vec3(v_Color.rgb)*(0.2+0.8*float(max(dot(normalize(vec3(vec3(v_Normal))),normalize(c_LightDirection)),0.0)))),1.0);\n"
+		"}\n",
+		"",
+		Files0, 2,
+		0xDCB5D569154E7D67ull
+	},
+	{
+		"res/shaders/Basic.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 4 0\n"
+		"layout(location=0)in vec2 position;\n"
+		"layout(location=1)in vec2 texCoord;\n"
+		"\n"
+		"out vec2 v_TexCoord;\n"
+		"\n"
+		"uniform mat4 u_MVP;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"gl_Position=u_MVP*vec4(position,0.0,1.0);\n"
+		"v_TexCoord=texCoord;\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 21 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec2 v_TexCoord;\n"
+		"\n"
+		"\n"
+		"uniform sampler2D u_Texture;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"vec4 texColor=texture(u_Texture,v_TexCoord);\n"
+		"color=texColor;\n"
+		"\n"
+		"}\n",
+		"",
+		Files1, 1,
+		0x8FCFA030CA4671A7ull
+	},
+	{
+		"res/shaders/ColorQuad.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 4 0\n"
+		"layout(location=0)in vec2 position;\n"
+		"layout(location=1)in vec2 texCoord;\n"
+		"\n"
+		"out vec2 v_TexCoord;\n"
+		"\n"
+		"uniform mat4 u_MVP;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"gl_Position=u_MVP*vec4(position,0.0,1.0);\n"
+		"v_TexCoord=texCoord;\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 21 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec2 v_TexCoord;\n"
+		"\n"
+		"uniform vec4 u_Color;\n"
+		"uniform sampler2D u_Texture;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"color=texture(u_Texture,v_TexCoord)*u_Color;\n"
+		"}\n",
+		"",
+		Files2, 1,
+		0x2222D924D30CAA65ull
+	},
+	{
+		"res/shaders/Culling.shader",
+		"",
+		"",
+		"#version 430 core\n"
+		"#pragma defines\n"
+		"#line 5 0\n"
+		"layout(local_size_x=256)in;\n"
+		"\n"
+		"struct Instance\n"
+		"{\n"
+		"vec4 positionScale;\n"
+		"vec4 color;\n"
+		"};\n"
+		"\n"
+		"struct SceneInstance\n"
+		"{\n"
+		"Instance instance;\n"
+		"uint mesh;\n"
+		"float radius;\n"
+		"};\n"
+		"\n"
+		"\n"
+		"struct DrawCommand\n"
+		"{\n"
+		"uint count;\n"
+		"uint instanceCount;\n"
+		"uint firstIndex;\n"
+		"int baseVertex;\n"
+		"uint baseInstance;\n"
+		"};\n"
+		"\n"
+		"layout(std430,binding=0)readonly buffer Instances\n"
+		"{\n"
+		"SceneInstance instances[];\n"
+		"};\n"
+		"\n"
+		"\n"
+		"layout(std430,binding=1)writeonly buffer Visible\n"
+		"{\n"
+		"Instance visible[];\n"
+		"};\n"
+		"\n"
+		"\n"
+		"layout(std430,binding=2)buffer Commands\n"
+		"{\n"
+		"DrawCommand commands[];\n"
+		"};\n"
+		"\n"
+		"uniform int u_Count;\n"
+		"\n"
+		"uniform vec4 u_Planes[6];\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"uint i=gl_GlobalInvocationID.x;\n"
+		"if(i>=uint(u_Count))\n"
+		"return;\n"
+		"\n"
+		"SceneInstance scene=instances[i];\n"
+		"vec3 center=scene.instance.positionScale.xyz;\n"
+		"for(int p=0;p<6;++p)\n"
+		"{\n"
+		"if(dot(u_Planes[p].xyz,center)+u_Planes[p].w<-scene.radius)\n"
+		"return;\n"
+		"}\n"
+		"\n"
+		"\n"
+		"uint slot=atomicAdd(commands[scene.mesh].instanceCount,1u);\n"
+		"visible[commands[scene.mesh].baseInstance+slot]=scene.instance;\n"
+		"}\n",
+		Files3, 1,
+		0xD6ADBB38AE90B73Eull
+	},
+	{
+		"res/shaders/Instanced.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 4 0\n"
+		"layout(location=0)in vec3 position;\n"
+		"layout(location=1)in vec3 normal;\n"
+		"\n"
+		"layout(location=2)in vec4 instancePositionScale;\n"
+		"layout(location=3)in vec4 instanceColor;\n"
+		"\n"
+		"out vec3 v_Normal;\n"
+		"out vec4 v_Color;\n"
+		"\n"
+		"uniform mat4 u_ViewProjection;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"vec3 world=position*instancePositionScale.w+instancePositionScale.xyz;\n"
+		"gl_Position=u_ViewProjection*vec4(world,1.0);\n"
+		"v_Normal=normal;\n"
+		"v_Color=instanceColor;\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 27 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec3 v_Normal;\n"
+		"in vec4 v_Color;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"float light=max(dot(normalize(v_Normal),normalize(vec3(0.3,1.0,0.5))),0.0);\n"
+		"color=vec4(v_Color.rgb*(0.25+0.75*light),1.0);\n"
+		"}\n",
+		"",
+		Files4, 1,
+		0x207DD671DE0A693Full
+	},
+	{
+		"res/shaders/Material.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 6 0\n"
+		"layout(location=0)in vec4 position;\n"
+		"layout(location=1)in vec3 normal;\n"
+		"layout(location=2)in vec2 texCoord;\n"
+		"layout(location=3)in vec4 color;\n"
+		"\n"
+		"out vec3 v_Normal;\n"
+		"out vec2 v_TexCoord;\n"
+		"out vec4 v_Color;\n"
+		"\n"
+		"uniform mat4 u_MVP;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"gl_Position=u_MVP*position;\n"
+		"v_Normal=normal;\n"
+		"v_TexCoord=texCoord;\n"
+		"#ifdef VERTEX_COLOR\n"
+		"v_Color=color;\n"
+		"#else\n"
+		"v_Color=vec4(1.0);\n"
+		"#endif\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 3 1\n"
+		"const vec3 c_LightDirection=vec3(0.3,1.0,0.5);\n"
+		"#line 35 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec3 v_Normal;\n"
+		"in vec2 v_TexCoord;\n"
+		"in vec4 v_Color;\n"
+		"\n"
+		"uniform vec4 u_Color;\n"
+		"#ifdef TEXTURED\n"
+		"uniform sampler2D u_Texture;\n"
+		"#endif\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"vec3 albedo=u_Color.rgb*v_Color.rgb;\n"
+		"#ifdef TEXTURED\n"
+		"albedo*=texture(u_Texture,v_TexCoord).rgb;\n"
+		"#endif\n"
+		"#ifdef CHECKER\n"
+		"albedo*=0.8+0.2*mod(floor(v_TexCoord.x*8.0)+floor(v_TexCoord.y*8.0),2.0);\n"
+		"#endif\n"
+		"#ifdef TINT\n"
+		"albedo*=TINT;\n"
+		"#endif\n"
+		"#ifdef LIT\n"
+		"albedo=vec3(vec3(albedo)*(0.2+0.8*float(max(dot(normalize(vec3(vec3(v_Normal))),normalize(c_LightDirection)),0.0))));\n"
+		"#endif\n"
+		"color=vec4(albedo,1.0);\n"
+		"}\n",
+		"",
+		Files5, 2,
+		0x087293E28EC784E9ull
+	},
+	{
+		"res/shaders/Mesh.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 4 0\n"
+		"layout(location=0)in vec4 position;\n"
+		"layout(location=1)in vec3 normal;\n"
+		"layout(location=2)in vec2 texCoord;\n"
+		"layout(location=3)in vec4 color;\n"
+		"\n"
+		"out vec3 v_Normal;\n"
+		"out vec2 v_TexCoord;\n"
+		"out vec4 v_Color;\n"
+		"\n"
+		"uniform mat4 u_MVP;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"gl_Position=u_MVP*position;\n"
+		"v_Normal=normal;\n"
+		"v_TexCoord=texCoord;\n"
+		"v_Color=color;\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 27 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec3 v_Normal;\n"
+		"in vec2 v_TexCoord;\n"
+		"in vec4 v_Color;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"float light=max(dot(normalize(v_Normal),normalize(vec3(0.3,1.0,0.5))),0.0);\n"
+		"float checker=mod(floor(v_TexCoord.x*32.0)+floor(v_TexCoord.y*32.0),2.0);\n"
+		"color=vec4(v_Color.rgb*(0.2+0.8*light)*(0.8+0.2*checker),1.0);\n"
+		"}\n",
+		"",
+		Files6, 1,
+		0x400AE4846FB5DB8Cull
+	},
+	{
+		"res/shaders/MeshTextured.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 4 0\n"
+		"layout(location=0)in vec4 position;\n"
+		"layout(location=1)in vec3 normal;\n"
+		"layout(location=2)in vec2 texCoord;\n"
+		"layout(location=3)in vec4 color;\n"
+		"\n"
+		"out vec3 v_Normal;\n"
+		"out vec2 v_TexCoord;\n"
+		"out vec4 v_Color;\n"
+		"\n"
+		"uniform mat4 u_MVP;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"gl_Position=u_MVP*position;\n"
+		"v_Normal=normal;\n"
+		"v_TexCoord=texCoord;\n"
+		"v_Color=color;\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 27 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec3 v_Normal;\n"
+		"in vec2 v_TexCoord;\n"
+		"in vec4 v_Color;\n"
+		"\n"
+		"uniform sampler2D u_Texture;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"float light=max(dot(normalize(v_Normal),normalize(vec3(0.3,1.0,0.5))),0.0);\n"
+		"vec4 texColor=texture(u_Texture,v_TexCoord);\n"
+		"color=vec4(v_Color.rgb*texColor.rgb*(0.2+0.8*light),1.0);\n"
+		"}\n",
+		"",
+		Files7, 1,
+		0xAE4E47FFE78CC366ull
+	},
+	{
+		"res/shaders/Particle.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 6 0\n"
+		"layout(location=0)in vec2 corner;\n"
+		"layout(location=1)in float positionX;\n"
+		"layout(location=2)in float positionY;\n"
+		"layout(location=3)in float life;\n"
+		"\n"
+		"out vec2 v_Corner;\n"
+		"out float v_Fade;\n"
+		"\n"
+		"uniform mat4 u_ViewProjection;\n"
+		"uniform float u_Size;\n"
+		"uniform float u_Lifetime;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"vec2 center=vec2(positionX,positionY);\n"
+		"gl_Position=u_ViewProjection*vec4(center+corner*u_Size,0.0,1.0);\n"
+		"v_Corner=corner;\n"
+		"v_Fade=clamp(life/u_Lifetime,0.0,1.0);\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 30 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec2 v_Corner;\n"
+		"in float v_Fade;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"float falloff=max(1.0-dot(v_Corner,v_Corner),0.0);\n"
+		"vec3 hot=mix(vec3(0.9,0.25,0.05),vec3(1.0,0.85,0.4),v_Fade);\n"
+		"\n"
+		"color=vec4(hot*falloff*v_Fade,0.0);\n"
+		"}\n",
+		"",
+		Files8, 1,
+		0xF3962467F1807FDBull
+	},
+	{
+		"res/shaders/ParticleUpdate.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 7 0\n"
+		"layout(location=0)in vec2 position;\n"
+		"layout(location=1)in vec2 velocity;\n"
+		"layout(location=2)in float life;\n"
+		"\n"
+		"out vec2 o_Position;\n"
+		"out vec2 o_Velocity;\n"
+		"out float o_Life;\n"
+		"\n"
+		"uniform float u_DeltaTime;\n"
+		"uniform vec2 u_Gravity;\n"
+		"uniform vec2 u_Emitter;\n"
+		"uniform float u_Speed;\n"
+		"uniform float u_Spread;\n"
+		"uniform float u_Lifetime;\n"
+		"uniform int u_Seed;\n"
+		"\n"
+		"uint Hash(uint x)\n"
+		"{\n"
+		"x^=x>>16;\n"
+		"x*=0x7FEB352Du;\n"
+		"x^=x>>15;\n"
+		"x*=0x846CA68Bu;\n"
+		"x^=x>>16;\n"
+		"return x;\n"
+		"}\n"
+		"\n"
+		"\n"
+		"float Random(uint x)\n"
+		"{\n"
+		"return float(Hash(x)>>8)*5.960464477539063e-08;\n"
+		"}\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"vec2 v=velocity+u_Gravity*u_DeltaTime;\n"
+		"vec2 p=position+v*u_DeltaTime;\n"
+		"float l=life-u_DeltaTime;\n"
+		"if(l<=0.0)\n"
+		"{\n"
+		"uint seed=Hash(uint(gl_VertexID)^uint(u_Seed));\n"
+		"p=u_Emitter;\n"
+		"v=vec2((Random(seed)-0.5)*u_Spread,u_Speed*(0.5+0.5*Random(seed+1u)));\n"
+		"l=u_Lifetime*(0.5+0.5*Random(seed+2u));\n"
+		"}\n"
+		"o_Position=p;\n"
+		"o_Velocity=v;\n"
+		"o_Life=l;\n"
+		"}\n",
+		"",
+		"",
+		Files9, 1,
+		0x13E9C57CCE1884FAull
+	},
+	{
+		"res/shaders/PulledMesh.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 8 0\n"
+		"uniform usamplerBuffer u_Vertices;\n"
+		"\n"
+		"uniform usamplerBuffer u_Indices;\n"
+		"\n"
+		"uniform samplerBuffer u_Instances;\n"
+		"\n"
+		"uniform int u_InstanceBase;\n"
+		"uniform mat4 u_ViewProjection;\n"
+		"\n"
+		"out vec3 v_Normal;\n"
+		"out vec4 v_Color;\n"
+		"\n"
+		"vec4 UnpackColor(uint color)\n"
+		"{\n"
+		"return vec4(uvec4(color,color>>8,color>>16,color>>24)&0xFFu)/255.0;\n"
+		"}\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"int vertex=int(texelFetch(u_Indices,gl_VertexID).r)*2;\n"
+		"uvec4 a=texelFetch(u_Vertices,vertex);\n"
+		"uvec4 b=texelFetch(u_Vertices,vertex+1);\n"
+		"vec3 position=uintBitsToFloat(a.xyz);\n"
+		"vec3 normal=uintBitsToFloat(uvec3(a.w,b.xy));\n"
+		"\n"
+		"int instance=(u_InstanceBase+gl_InstanceID)*2;\n"
+		"vec4 positionScale=texelFetch(u_Instances,instance);\n"
+		"vec4 color=texelFetch(u_Instances,instance+1);\n"
+		"\n"
+		"gl_Position=u_ViewProjection*vec4(position*positionScale.w+positionScale.xyz,1.0);\n"
+		"v_Normal=normal;\n"
+		"v_Color=color*UnpackColor(b.z);\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 3 1\n"
+		"const vec3 c_LightDirection=vec3(0.3,1.0,0.5);\n"
+		"#line 48 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec3 v_Normal;\n"
+		"in vec4 v_Color;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"color=vec4(vec3(vec3(v_Color.rgb)*(0.2+0.8*float(max(dot(normalize(vec3(vec3(v_Normal))),normalize(c_LightDirection)),0.0)))),1.0);\n"
+		"}\n",
+		"",
+		Files10, 2,
+		0x65E0A4F159827277ull
+	},
+	{
+		"res/shaders/PulledMeshStorage.shader",
+		"#version 430 core\n"
+		"#pragma defines\n"
+		"#line 7 0\n"
+		"layout(std430,binding=0)readonly buffer Vertices\n"
+		"{\n"
+		"uvec4 vertices[];\n"
+		"};\n"
+		"\n"
+		"layout(std430,binding=1)readonly buffer Indices\n"
+		"{\n"
+		"uint indices[];\n"
+		"};\n"
+		"\n"
+		"layout(std430,binding=2)readonly buffer Instances\n"
+		"{\n"
+		"vec4 instances[];\n"
+		"};\n"
+		"\n"
+		"uniform int u_InstanceBase;\n"
+		"uniform mat4 u_ViewProjection;\n"
+		"\n"
+		"out vec3 v_Normal;\n"
+		"out vec4 v_Color;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"uint vertex=indices[gl_VertexID]*2u;\n"
+		"uvec4 a=vertices[vertex];\n"
+		"uvec4 b=vertices[vertex+1u];\n"
+		"vec3 position=uintBitsToFloat(a.xyz);\n"
+		"vec3 normal=uintBitsToFloat(uvec3(a.w,b.xy));\n"
+		"\n"
+		"int instance=(u_InstanceBase+gl_InstanceID)*2;\n"
+		"vec4 positionScale=instances[instance];\n"
+		"vec4 color=instances[instance+1];\n"
+		"\n"
+		"gl_Position=u_ViewProjection*vec4(position*positionScale.w+positionScale.xyz,1.0);\n"
+		"v_Normal=normal;\n"
+		"v_Color=color*unpackUnorm4x8(b.z);\n"
+		"}\n",
+		"#version 430 core\n"
+		"#pragma defines\n"
+		"#line 3 1\n"
+		"const vec3 c_LightDirection=vec3(0.3,1.0,0.5);\n"
+		"#line 51 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec3 v_Normal;\n"
+		"in vec4 v_Color;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"color=vec4(vec3(vec3(v_Color.rgb)*(0.2+0.8*float(max(dot(normalize(vec3(vec3(v_Normal))),normalize(c_LightDirection)),0.0)))),1.0);\n"
+		"}\n",
+		"",
+		Files11, 2,
+		0x3B8C90C1B9E8494Full
+	},
+	{
+		"res/shaders/Sprite.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 4 0\n"
+		"layout(location=0)in vec4 position;\n"
+		"layout(location=1)in vec2 texCoord;\n"
+		"layout(location=2)in float blend;\n"
+		"\n"
+		"out vec2 v_TexCoord;\n"
+		"out float v_Blend;\n"
+		"\n"
+		"uniform mat4 u_MVP;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"gl_Position=u_MVP*position;\n"
+		"v_TexCoord=texCoord;\n"
+		"v_Blend=blend;\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 24 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec2 v_TexCoord;\n"
+		"in float v_Blend;\n"
+		"\n"
+		"uniform sampler2D u_Texture;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"#line 36 0\n"
+		"vec4 texColor=texture(u_Texture,v_TexCoord);\n"
+		"color=vec4(texColor.rgb,texColor.a*v_Blend);\n"
+		"}\n",
+		"",
+		Files12, 1,
+		0x26C70A81C01A53CEull
+	},
+	{
+		"res/shaders/SpriteSimulation.shader",
+		"",
+		"",
+		"#version 430 core\n"
+		"#pragma defines\n"
+		"#line 5 0\n"
+		"layout(local_size_x=256)in;\n"
+		"\n"
+		"struct Sprite\n"
+		"{\n"
+		"vec2 position;\n"
+		"vec2 velocity;\n"
+		"};\n"
+		"\n"
+		"\n"
+		"struct SpriteVertex\n"
+		"{\n"
+		"vec2 position;\n"
+		"vec2 texCoord;\n"
+		"};\n"
+		"\n"
+		"layout(std430,binding=0)buffer Sprites\n"
+		"{\n"
+		"Sprite sprites[];\n"
+		"};\n"
+		"\n"
+		"layout(std430,binding=1)writeonly buffer Vertices\n"
+		"{\n"
+		"SpriteVertex vertices[];\n"
+		"};\n"
+		"\n"
+		"uniform int u_Count;\n"
+		"uniform float u_DeltaTime;\n"
+		"uniform float u_Width;\n"
+		"uniform float u_Size;\n"
+		"\n"
+		"const float Gravity=300.0;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"uint i=gl_GlobalInvocationID.x;\n"
+		"if(i>=uint(u_Count))\n"
+		"return;\n"
+		"\n"
+		"\n"
+		"Sprite sprite=sprites[i];\n"
+		"sprite.velocity.y-=Gravity*u_DeltaTime;\n"
+		"sprite.position+=sprite.velocity*u_DeltaTime;\n"
+		"if(sprite.position.x<0.0||sprite.position.x>u_Width)\n"
+		"{\n"
+		"sprite.velocity.x=-sprite.velocity.x;\n"
+		"sprite.position.x=clamp(sprite.position.x,0.0,u_Width);\n"
+		"}\n"
+		"if(sprite.position.y<0.0)\n"
+		"{\n"
+		"sprite.velocity.y=abs(sprite.velocity.y);\n"
+		"sprite.position.y=0.0;\n"
+		"}\n"
+		"sprites[i]=sprite;\n"
+		"\n"
+		"float halfSize=u_Size*0.5;\n"
+		"uint v=i*4u;\n"
+		"vertices[v+0u]=SpriteVertex(sprite.position+vec2(-halfSize,-halfSize),vec2(0.0,0.0));\n"
+		"vertices[v+1u]=SpriteVertex(sprite.position+vec2(halfSize,-halfSize),vec2(1.0,0.0));\n"
+		"vertices[v+2u]=SpriteVertex(sprite.position+vec2(halfSize,halfSize),vec2(1.0,1.0));\n"
+		"vertices[v+3u]=SpriteVertex(sprite.position+vec2(-halfSize,halfSize),vec2(0.0,1.0));\n"
+		"}\n",
+		Files13, 1,
+		0x499A0C45267D1609ull
+	},
+	{
+		"res/shaders/Tilemap.shader",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 4 0\n"
+		"layout(location=0)in uvec2 corner;\n"
+		"layout(location=1)in uint tile;\n"
+		"\n"
+		"out vec2 v_TexCoord;\n"
+		"flat out int v_Tile;\n"
+		"\n"
+		"uniform mat4 u_MVP;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"\n"
+		"if(tile==0u)\n"
+		"{\n"
+		"gl_Position=vec4(2.0,2.0,2.0,1.0);\n"
+		"v_TexCoord=vec2(0.0);\n"
+		"v_Tile=0;\n"
+		"return;\n"
+		"}\n"
+		"gl_Position=u_MVP*vec4(vec2(corner),0.0,1.0);\n"
+		"\n"
+		"\n"
+		"int c=gl_VertexID&3;\n"
+		"v_TexCoord=vec2(c==1||c==2?1.0:0.0,c>=2?1.0:0.0);\n"
+		"v_Tile=int(tile)-1;\n"
+		"}\n",
+		"#version 330 core\n"
+		"#pragma defines\n"
+		"#line 34 0\n"
+		"layout(location=0)out vec4 color;\n"
+		"\n"
+		"in vec2 v_TexCoord;\n"
+		"flat in int v_Tile;\n"
+		"\n"
+		"uniform sampler2D u_Atlas;\n"
+		"uniform sampler2DArray u_TileArray;\n"
+		"uniform int u_UseArray;\n"
+		"uniform int u_AtlasColumns;\n"
+		"uniform int u_AtlasRows;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"if(u_UseArray!=0)\n"
+		"{\n"
+		"color=texture(u_TileArray,vec3(v_TexCoord,float(v_Tile)));\n"
+		"return;\n"
+		"}\n"
+		"\n"
+		"\n"
+		"vec2 grid=vec2(u_AtlasColumns,u_AtlasRows);\n"
+		"vec2 cell=vec2(v_Tile%u_AtlasColumns,v_Tile/u_AtlasColumns);\n"
+		"vec2 halfTexel=0.5/vec2(textureSize(u_Atlas,0));\n"
+		"vec2 uv=clamp((cell+v_TexCoord)/grid,cell/grid+halfTexel,(cell+1.0)/grid-halfTexel);\n"
+		"color=texture(u_Atlas,uv);\n"
+		"}\n",
+		"",
+		Files14, 1,
+		0xB5821A80557E08B2ull
+	},
+	{
+		"res/shaders/WaveImage.shader",
+		"",
+		"",
+		"#version 430 core\n"
+		"#pragma defines\n"
+		"#line 5 0\n"
+		"layout(local_size_x=16,local_size_y=16)in;\n"
+		"\n"
+		"layout(rgba8,binding=0)writeonly uniform image2D u_Image;\n"
+		"\n"
+		"uniform float u_Time;\n"
+		"\n"
+		"void main()\n"
+		"{\n"
+		"ivec2 texel=ivec2(gl_GlobalInvocationID.xy);\n"
+		"ivec2 size=imageSize(u_Image);\n"
+		"if(any(greaterThanEqual(texel,size)))\n"
+		"return;\n"
+		"\n"
+		"vec2 uv=vec2(texel)/vec2(size);\n"
+		"float wave=sin(uv.x*12.0+u_Time)*cos(uv.y*9.0-u_Time*0.7);\n"
+		"vec3 color=mix(vec3(0.05,0.07,0.15),vec3(0.1,0.2,0.35),0.5+0.5*wave);\n"
+		"imageStore(u_Image,texel,vec4(color,1.0));\n"
+		"}\n",
+		Files15, 1,
+		0xFFA730DAD07A1F42ull
+	},
+};
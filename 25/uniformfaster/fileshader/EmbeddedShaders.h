@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// The .shader files compiled into the executable. tools/embed_shaders.py
+// runs as the pre-build event and writes EmbeddedShaders.generated.inl from
+// res/shaders: split per stage with the includes resolved and optimized by
+// tools/glsl_optimizer.py (dead code and unused uniforms removed, constants
+// folded, small functions inlined, minified), defines still to come.
+// ShaderPreprocessor::Process takes them from here, so loading a shader
+// reads no files and works from any working directory.
+namespace EmbeddedShaders
+{
+	struct Entry
+	{
+		// the path Shader is given, "res/shaders/Basic.shader"
+		const char* Path;
+		const char* VertexSource;
+		const char* FragmentSource;
+		const char* ComputeSource;
+		// for #line, see ShaderProgramSources::Files
+		const char* const* Files;
+		unsigned int FileCount;
+		// ShaderPreprocessor::Hash of the files before optimizing, without
+		// defines. tells whether a file changed since the build
+		uint64_t SourceHash;
+	};
+
+#include "EmbeddedShaders.generated.inl"
+
+	inline constexpr unsigned int Count = sizeof(Table) / sizeof(Table[0]);
+
+	// nullptr when the path wasn't embedded
+	constexpr const Entry* Find(std::string_view path)
+	{
+		for (const Entry& entry : Table)
+		{
+			if (path == entry.Path)
+				return &entry;
+		}
+		return nullptr;
+	}
+}
+
+// the entry for a path looked up at compile time, a shader that isn't
+// embedded is a compile error instead of a missing file at runtime
+#define EMBEDDED_SHADER(path)                                                      \
+	(*[] {                                                                         \
+		constexpr const EmbeddedShaders::Entry* entry = EmbeddedShaders::Find(path); \
+		static_assert(entry != nullptr, "shader " path " is not embedded");          \
+		return entry;                                                              \
+	}())
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+// The six planes of a view projection matrix, for culling bounding
+// volumes on the CPU. Planes point inwards and are normalized.
+struct Frustum
+{
+	glm::vec4 planes[6]; // left, right, bottom, top, near, far
+
+	Frustum(const glm::mat4& viewProjection);
+
+	bool IsBoxVisible(const glm::vec3& min, const glm::vec3& max) const;
+	bool IsSphereVisible(const glm::vec3& center, float radius) const;
+};
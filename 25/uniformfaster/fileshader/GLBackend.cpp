@@ -0,0 +1,75 @@
+#include "Renderer.h"
+#include "GLBackend.h"
+
+static bool s_DSAEnabled = true;
+static unsigned int s_Binds = 0;
+static unsigned int s_SavedBinds = 0;
+static unsigned int s_FrameBinds = 0;
+static unsigned int s_FrameSavedBinds = 0;
+static unsigned int s_UniformUploads = 0;
+static unsigned int s_SkippedUniformUploads = 0;
+static unsigned int s_FrameUniformUploads = 0;
+static unsigned int s_FrameSkippedUniformUploads = 0;
+
+bool GLBackend::HasDSA()
+{
+	return GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access;
+}
+bool GLBackend::UseDSA()
+{
+	return s_DSAEnabled && HasDSA();
+}
+void GLBackend::SetDSAEnabled(bool enabled)
+{
+	s_DSAEnabled = enabled;
+}
+bool GLBackend::IsDSAEnabled()
+{
+	return s_DSAEnabled;
+}
+
+void GLBackend::CountBinds(unsigned int count)
+{
+	s_Binds += count;
+}
+void GLBackend::CountSavedBinds(unsigned int count)
+{
+	s_SavedBinds += count;
+}
+
+void GLBackend::CountUniformUploads(unsigned int count)
+{
+	s_UniformUploads += count;
+}
+void GLBackend::CountSkippedUniformUploads(unsigned int count)
+{
+	s_SkippedUniformUploads += count;
+}
+
+void GLBackend::NewFrame()
+{
+	s_FrameBinds = s_Binds;
+	s_FrameSavedBinds = s_SavedBinds;
+	s_FrameUniformUploads = s_UniformUploads;
+	s_FrameSkippedUniformUploads = s_SkippedUniformUploads;
+	s_Binds = 0;
+	s_SavedBinds = 0;
+	s_UniformUploads = 0;
+	s_SkippedUniformUploads = 0;
+}
+unsigned int GLBackend::GetFrameBinds()
+{
+	return s_FrameBinds;
+}
+unsigned int GLBackend::GetFrameSavedBinds()
+{
+	return s_FrameSavedBinds;
+}
+unsigned int GLBackend::GetFrameUniformUploads()
+{
+	return s_FrameUniformUploads;
+}
+unsigned int GLBackend::GetFrameSkippedUniformUploads()
+{
+	return s_FrameSkippedUniformUploads;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// Picks how the wrappers talk to GL. With GL 4.5 or ARB_direct_state_access
+// objects are created and edited by name (glCreateBuffers, glNamedBufferData,
+// glTextureSubImage2D, glVertexArrayVertexBuffer, ...) and nothing has to be
+// bound just to change it. Otherwise the 3.3 bind-to-edit path is used.
+//
+// Binds are counted per frame: the ones actually issued, and the ones the
+// DSA path skipped where the classic path would have bound something.
+// Uniform uploads the same way, issued and skipped because the program
+// already held the value.
+class GLBackend
+{
+public:
+	// context supports DSA
+	static bool HasDSA();
+	// supported and not switched off
+	static bool UseDSA();
+	// for comparing both paths, only affects what is created or edited afterwards
+	static void SetDSAEnabled(bool enabled);
+	static bool IsDSAEnabled();
+
+	static void CountBinds(unsigned int count = 1);
+	static void CountSavedBinds(unsigned int count = 1);
+	static void CountUniformUploads(unsigned int count = 1);
+	static void CountSkippedUniformUploads(unsigned int count = 1);
+
+	// once at the start of every frame, the last frame's counts stay readable
+	static void NewFrame();
+	static unsigned int GetFrameBinds();
+	static unsigned int GetFrameSavedBinds();
+	static unsigned int GetFrameUniformUploads();
+	static unsigned int GetFrameSkippedUniformUploads();
+};
@@ -0,0 +1,610 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <utility>
+
+#include "Renderer.h"
+#include "VertexBufferLayout.h"
+#include "MappedFile.h"
+#include "GltfModel.h"
+
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+// just enough JSON for the glTF header chunk
+struct JsonValue
+{
+	enum Type { Null, Bool, Number, String, Array, Object };
+
+	Type type = Null;
+	bool boolean = false;
+	double number = 0.0;
+	std::string string;
+	std::vector<JsonValue> items;
+	std::vector<std::pair<std::string, JsonValue>> members;
+
+	const JsonValue& operator[](const char* key) const
+	{
+		static const JsonValue null;
+		for (const auto& member : members)
+			if (member.first == key)
+				return member.second;
+		return null;
+	}
+	const JsonValue& operator[](size_t index) const
+	{
+		static const JsonValue null;
+		return index < items.size() ? items[index] : null;
+	}
+	size_t Size() const { return items.size(); }
+	bool IsNull() const { return type == Null; }
+	int AsInt(int fallback = 0) const { return type == Number ? (int)number : fallback; }
+	// byte offsets and lengths, files can be over 2 GB
+	size_t AsSize(size_t fallback = 0) const { return type == Number ? (size_t)number : fallback; }
+	float AsFloat(float fallback = 0.0f) const { return type == Number ? (float)number : fallback; }
+	bool AsBool(bool fallback = false) const { return type == Bool ? boolean : fallback; }
+};
+
+class JsonParser
+{
+private:
+	// glTF itself nests less than 10 deep, this only stops a broken or
+	// hostile file from running the recursion off the stack
+	static const int MaxDepth = 64;
+
+	const char* m_Pos;
+	const char* m_End;
+	int m_Depth;
+	bool m_Error;
+
+public:
+	JsonParser(const char* text, size_t length) :
+		m_Pos(text), m_End(text + length), m_Depth(0), m_Error(false) {}
+
+	bool Parse(JsonValue& value)
+	{
+		ParseValue(value);
+		SkipSpace();
+		return !m_Error;
+	}
+
+private:
+	void SkipSpace()
+	{
+		while (m_Pos < m_End && (*m_Pos == ' ' || *m_Pos == '\t' || *m_Pos == '\n' || *m_Pos == '\r'))
+			++m_Pos;
+	}
+	bool Expect(char c)
+	{
+		SkipSpace();
+		if (m_Pos < m_End && *m_Pos == c)
+		{
+			++m_Pos;
+			return true;
+		}
+		m_Error = true;
+		return false;
+	}
+	bool Literal(const char* word)
+	{
+		size_t length = strlen(word);
+		if ((size_t)(m_End - m_Pos) >= length && memcmp(m_Pos, word, length) == 0)
+		{
+			m_Pos += length;
+			return true;
+		}
+		m_Error = true;
+		return false;
+	}
+
+	void ParseString(std::string& out)
+	{
+		if (!Expect('"'))
+			return;
+		while (m_Pos < m_End && *m_Pos != '"')
+		{
+			char c = *m_Pos++;
+			if (c != '\\')
+			{
+				out += c;
+				continue;
+			}
+			if (m_Pos >= m_End)
+				break;
+			c = *m_Pos++;
+			switch (c)
+			{
+			case 'b': out += '\b'; break;
+			case 'f': out += '\f'; break;
+			case 'n': out += '\n'; break;
+			case 'r': out += '\r'; break;
+			case 't': out += '\t'; break;
+			case 'u':
+			{
+				// names in glTF are rarely anything but ascii, keep the
+				// basic plane and replace the rest
+				if (m_End - m_Pos < 4)
+				{
+					m_Error = true;
+					return;
+				}
+				unsigned int code = (unsigned int)strtoul(std::string(m_Pos, 4).c_str(), nullptr, 16);
+				m_Pos += 4;
+				if (code < 0x80)
+					out += (char)code;
+				else if (code < 0x800)
+				{
+					out += (char)(0xC0 | (code >> 6));
+					out += (char)(0x80 | (code & 0x3F));
+				}
+				else if (code < 0xD800 || code > 0xDFFF)
+				{
+					out += (char)(0xE0 | (code >> 12));
+					out += (char)(0x80 | ((code >> 6) & 0x3F));
+					out += (char)(0x80 | (code & 0x3F));
+				}
+				else
+					out += '?';
+				break;
+			}
+			default: out += c; break;
+			}
+		}
+		if (m_Pos >= m_End)
+		{
+			m_Error = true;
+			return;
+		}
+		++m_Pos;
+	}
+
+	void ParseValue(JsonValue& value)
+	{
+		SkipSpace();
+		if (m_Pos >= m_End || m_Depth >= MaxDepth)
+		{
+			m_Error = true;
+			return;
+		}
+		++m_Depth;
+		ParseNested(value);
+		--m_Depth;
+	}
+	void ParseNested(JsonValue& value)
+	{
+		switch (*m_Pos)
+		{
+		case '{':
+			value.type = JsonValue::Object;
+			++m_Pos;
+			SkipSpace();
+			if (m_Pos < m_End && *m_Pos == '}')
+			{
+				++m_Pos;
+				return;
+			}
+			while (!m_Error)
+			{
+				value.members.emplace_back();
+				ParseString(value.members.back().first);
+				Expect(':');
+				ParseValue(value.members.back().second);
+				SkipSpace();
+				if (m_Pos < m_End && *m_Pos == ',')
+				{
+					++m_Pos;
+					continue;
+				}
+				Expect('}');
+				break;
+			}
+			break;
+		case '[':
+			value.type = JsonValue::Array;
+			++m_Pos;
+			SkipSpace();
+			if (m_Pos < m_End && *m_Pos == ']')
+			{
+				++m_Pos;
+				return;
+			}
+			while (!m_Error)
+			{
+				value.items.emplace_back();
+				ParseValue(value.items.back());
+				SkipSpace();
+				if (m_Pos < m_End && *m_Pos == ',')
+				{
+					++m_Pos;
+					continue;
+				}
+				Expect(']');
+				break;
+			}
+			break;
+		case '"':
+			value.type = JsonValue::String;
+			ParseString(value.string);
+			break;
+		case 't':
+			value.type = JsonValue::Bool;
+			value.boolean = Literal("true");
+			break;
+		case 'f':
+			value.type = JsonValue::Bool;
+			Literal("false");
+			break;
+		case 'n':
+			Literal("null");
+			break;
+		default:
+		{
+			// strtod needs a terminated string, numbers are short
+			const char* start = m_Pos;
+			while (m_Pos < m_End && strchr("+-0123456789.eE", *m_Pos))
+				++m_Pos;
+			if (m_Pos == start)
+			{
+				m_Error = true;
+				return;
+			}
+			value.type = JsonValue::Number;
+			value.number = strtod(std::string(start, m_Pos).c_str(), nullptr);
+			break;
+		}
+		}
+	}
+};
+
+// what a worker thread finds out about a primitive, GL objects are made
+// from it on the main thread
+struct AttributeDesc
+{
+	unsigned int location;
+	int view;
+	VertexBufferElement element;
+	unsigned int stride;
+};
+struct PrimitiveDesc
+{
+	bool ok;
+	std::vector<AttributeDesc> attributes;
+	const unsigned char* indices;
+	unsigned int indexType;
+	unsigned int indexCount;
+	unsigned int mode;
+	bool hasNormals;
+	bool hasColors;
+	glm::vec3 min, max;
+};
+struct MeshDesc
+{
+	std::string name;
+	std::vector<PrimitiveDesc> primitives;
+};
+
+static unsigned int GetComponentCount(const std::string& type)
+{
+	if (type == "SCALAR") return 1;
+	if (type == "VEC2") return 2;
+	if (type == "VEC3") return 3;
+	if (type == "VEC4") return 4;
+	return 0;
+}
+
+static bool IsComponentType(int type)
+{
+	// glTF uses the GL enums
+	return type == GL_BYTE || type == GL_UNSIGNED_BYTE || type == GL_SHORT ||
+		type == GL_UNSIGNED_SHORT || type == GL_UNSIGNED_INT || type == GL_FLOAT;
+}
+
+// indices past the vertex count make the draw read outside the buffers
+static unsigned int GetMaxIndex(const unsigned char* indices, unsigned int type, unsigned int count)
+{
+	unsigned int max = 0;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int index;
+		if (type == GL_UNSIGNED_BYTE)
+			index = indices[i];
+		else if (type == GL_UNSIGNED_SHORT)
+			index = ((const unsigned short*)indices)[i];
+		else
+			index = ((const unsigned int*)indices)[i];
+		max = std::max(max, index);
+	}
+	return max;
+}
+
+// byte range of accessor inside its buffer view, false if it doesn't fit
+static bool ResolveAccessor(const JsonValue& gltf, int accessorIndex, size_t binSize,
+	int& view, VertexBufferElement& element, unsigned int& stride, unsigned int& count, size_t& begin, size_t& end)
+{
+	const JsonValue& accessor = gltf["accessors"][accessorIndex];
+	view = accessor["bufferView"].AsInt(-1);
+	const JsonValue& bufferView = gltf["bufferViews"][view];
+	if (accessor.IsNull() || bufferView.IsNull() || bufferView["buffer"].AsInt() != 0 || !accessor["sparse"].IsNull())
+		return false;
+
+	int componentType = accessor["componentType"].AsInt();
+	unsigned int components = GetComponentCount(accessor["type"].string);
+	if (!IsComponentType(componentType) || components == 0)
+		return false;
+
+	element = { (unsigned int)componentType, components, (unsigned char)(accessor["normalized"].AsBool() ? GL_TRUE : GL_FALSE),
+		(unsigned int)accessor["byteOffset"].AsSize(), GL_FALSE };
+	unsigned int size = element.GetSize();
+	stride = bufferView["byteStride"].AsInt(0);
+	if (stride == 0)
+		stride = size;
+	count = accessor["count"].AsInt();
+
+	size_t viewOffset = bufferView["byteOffset"].AsSize();
+	size_t viewLength = bufferView["byteLength"].AsSize();
+	if (viewOffset + viewLength > binSize || count == 0)
+		return false;
+	begin = viewOffset + element.offset;
+	end = begin + (size_t)stride * (count - 1) + size;
+	return end <= viewOffset + viewLength;
+}
+
+static void DecodeMesh(const JsonValue& gltf, const JsonValue& mesh, const MappedFile& file, size_t binOffset, size_t binSize, MeshDesc& desc)
+{
+	static const char* AttributeNames[] = { "POSITION", "NORMAL", "TEXCOORD_0", "COLOR_0" };
+	const unsigned char* bin = file.GetData() + binOffset;
+
+	desc.name = mesh["name"].string;
+	const JsonValue& primitives = mesh["primitives"];
+	desc.primitives.resize(primitives.Size());
+	for (size_t p = 0; p < primitives.Size(); ++p)
+	{
+		const JsonValue& primitive = primitives[p];
+		PrimitiveDesc& out = desc.primitives[p];
+		out.ok = false;
+		out.mode = primitive["mode"].AsInt(GL_TRIANGLES);
+		out.hasNormals = false;
+		out.hasColors = false;
+		out.min = out.max = glm::vec3(0.0f);
+
+		unsigned int vertexCount = 0;
+		bool ok = true;
+		for (unsigned int location = 0; location < 4; ++location)
+		{
+			const JsonValue& index = primitive["attributes"][AttributeNames[location]];
+			if (index.IsNull())
+				continue;
+
+			AttributeDesc attribute;
+			attribute.location = location;
+			unsigned int count;
+			size_t begin, end;
+			if (!ResolveAccessor(gltf, index.AsInt(), binSize, attribute.view, attribute.element, attribute.stride, count, begin, end))
+			{
+				ok = false;
+				break;
+			}
+			// every attribute has to cover the vertices POSITION has
+			if (location > 0 && count < vertexCount)
+			{
+				ok = false;
+				break;
+			}
+			// the element offset is relative to the view the buffer is made from
+			file.Prefetch(binOffset + begin, end - begin);
+			out.attributes.push_back(attribute);
+			vertexCount = location == 0 ? count : vertexCount;
+			out.hasNormals |= location == 1;
+			out.hasColors |= location == 3;
+
+			if (location == 0)
+			{
+				const JsonValue& accessor = gltf["accessors"][index.AsInt()];
+				for (int i = 0; i < 3; ++i)
+				{
+					out.min[i] = accessor["min"][i].AsFloat();
+					out.max[i] = accessor["max"][i].AsFloat();
+				}
+			}
+		}
+
+		const JsonValue& indices = primitive["indices"];
+		if (!ok || vertexCount == 0 || indices.IsNull())
+		{
+			std::cerr << "glTF: skipping primitive " << p << " of mesh '" << desc.name << "'"
+				<< (indices.IsNull() ? " (no indices)" : "") << std::endl;
+			continue;
+		}
+
+		int view;
+		VertexBufferElement element;
+		unsigned int stride, count;
+		size_t begin, end;
+		if (!ResolveAccessor(gltf, indices.AsInt(), binSize, view, element, stride, count, begin, end) ||
+			element.count != 1 || stride != element.GetSize() ||
+			(element.type != GL_UNSIGNED_BYTE && element.type != GL_UNSIGNED_SHORT && element.type != GL_UNSIGNED_INT))
+		{
+			std::cerr << "glTF: bad indices in mesh '" << desc.name << "'" << std::endl;
+			continue;
+		}
+		// checked on the worker, the upload needs the pages anyway
+		file.Prefetch(binOffset + begin, end - begin);
+		if (GetMaxIndex(bin + begin, element.type, count) >= vertexCount)
+		{
+			std::cerr << "glTF: indices past the vertices in mesh '" << desc.name << "'" << std::endl;
+			continue;
+		}
+		out.indices = bin + begin;
+		out.indexType = element.type;
+		out.indexCount = count;
+		out.ok = true;
+	}
+}
+
+GltfModel::GltfModel(const std::string& filepath, unsigned int threadCount) :
+	m_Stats{}
+{
+	Clock::time_point start = Clock::now();
+	MappedFile file(filepath);
+	m_Stats.mapMs = Milliseconds(Clock::now() - start).count();
+	if (!file.IsOpen())
+		return;
+	m_Stats.fileBytes = file.GetSize();
+
+	// 12 byte header, then a JSON chunk and an optional BIN chunk
+	const unsigned char* data = file.GetData();
+	size_t size = file.GetSize();
+	unsigned int header[3];
+	unsigned int jsonChunk[2];
+	if (size < 20)
+	{
+		std::cerr << "'" << filepath << "' is not a .glb file" << std::endl;
+		return;
+	}
+	memcpy(header, data, sizeof(header));
+	memcpy(jsonChunk, data + 12, sizeof(jsonChunk));
+	if (header[0] != 0x46546C67 || header[1] != 2 || jsonChunk[1] != 0x4E4F534A || 20 + (size_t)jsonChunk[0] > size)
+	{
+		std::cerr << "'" << filepath << "' is not a glTF 2.0 .glb file" << std::endl;
+		return;
+	}
+	size_t binOffset = 0, binSize = 0;
+	size_t binChunkOffset = 20 + (size_t)jsonChunk[0];
+	if (binChunkOffset + 8 <= size)
+	{
+		unsigned int binChunk[2];
+		memcpy(binChunk, data + binChunkOffset, sizeof(binChunk));
+		if (binChunk[1] == 0x004E4942 && binChunkOffset + 8 + binChunk[0] <= size)
+		{
+			binOffset = binChunkOffset + 8;
+			binSize = binChunk[0];
+		}
+	}
+
+	start = Clock::now();
+	JsonValue gltf;
+	JsonParser parser((const char*)data + 20, jsonChunk[0]);
+	if (!parser.Parse(gltf))
+	{
+		std::cerr << "'" << filepath << "' has broken JSON" << std::endl;
+		return;
+	}
+	m_Stats.parseMs = Milliseconds(Clock::now() - start).count();
+
+	// meshes are independent, workers take the next one until none are left
+	start = Clock::now();
+	const JsonValue& meshes = gltf["meshes"];
+	std::vector<MeshDesc> descs(meshes.Size());
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 4;
+	threadCount = std::min(threadCount, (unsigned int)descs.size());
+	m_Stats.threads = threadCount;
+	std::atomic<unsigned int> next(0);
+	auto worker = [&]() {
+		for (unsigned int m = next++; m < descs.size(); m = next++)
+			DecodeMesh(gltf, meshes[m], file, binOffset, binSize, descs[m]);
+	};
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < threadCount; ++i)
+		workers.emplace_back(worker);
+	worker();
+	for (std::thread& thread : workers)
+		thread.join();
+	m_Stats.decodeMs = Milliseconds(Clock::now() - start).count();
+
+	// GL only on this thread. glBufferData reads straight out of the mapping
+	start = Clock::now();
+	const JsonValue& bufferViews = gltf["bufferViews"];
+	m_VertexBuffers.resize(bufferViews.Size());
+	for (const MeshDesc& desc : descs)
+	{
+		for (const PrimitiveDesc& primitive : desc.primitives)
+		{
+			if (!primitive.ok)
+				continue;
+			for (const AttributeDesc& attribute : primitive.attributes)
+			{
+				std::unique_ptr<VertexBuffer>& buffer = m_VertexBuffers[attribute.view];
+				if (buffer)
+					continue;
+				const JsonValue& view = bufferViews[attribute.view];
+				unsigned int length = (unsigned int)view["byteLength"].AsSize();
+				buffer = std::make_unique<VertexBuffer>(data + binOffset + view["byteOffset"].AsSize(), length);
+				m_Stats.uploadedBytes += length;
+			}
+		}
+	}
+
+	m_Meshes.resize(descs.size());
+	for (size_t m = 0; m < descs.size(); ++m)
+	{
+		m_Meshes[m].name = descs[m].name;
+		for (const PrimitiveDesc& desc : descs[m].primitives)
+		{
+			if (!desc.ok)
+				continue;
+			Primitive primitive;
+			primitive.vao = std::make_unique<VertexArray>();
+			for (const AttributeDesc& attribute : desc.attributes)
+				primitive.vao->AddBuffer(*m_VertexBuffers[attribute.view], &attribute.element, 1, attribute.stride, attribute.location);
+
+			if (desc.indexType == GL_UNSIGNED_BYTE)
+				primitive.indexBuffer = std::make_unique<IndexBuffer>(desc.indices, desc.indexCount);
+			else if (desc.indexType == GL_UNSIGNED_SHORT)
+				primitive.indexBuffer = std::make_unique<IndexBuffer>((const unsigned short*)desc.indices, desc.indexCount);
+			else
+				primitive.indexBuffer = std::make_unique<IndexBuffer>((const unsigned int*)desc.indices, desc.indexCount);
+			m_Stats.uploadedBytes += desc.indexCount * VertexBufferElement::GetSizeOfType(desc.indexType);
+
+			primitive.mode = desc.mode;
+			primitive.hasNormals = desc.hasNormals;
+			primitive.hasColors = desc.hasColors;
+			primitive.min = desc.min;
+			primitive.max = desc.max;
+			m_Meshes[m].primitives.push_back(std::move(primitive));
+		}
+	}
+	// the mapping goes away with file, make sure GL has everything
+	CALLGL(glFinish());
+	m_Stats.uploadMs = Milliseconds(Clock::now() - start).count();
+}
+GltfModel::~GltfModel()
+{}
+
+unsigned int GltfModel::GetTriangleCount() const
+{
+	unsigned int triangles = 0;
+	for (const Mesh& mesh : m_Meshes)
+	{
+		for (const Primitive& primitive : mesh.primitives)
+		{
+			unsigned int count = primitive.indexBuffer->GetCount();
+			if (primitive.mode == GL_TRIANGLES)
+				triangles += count / 3;
+			else if (primitive.mode == GL_TRIANGLE_STRIP || primitive.mode == GL_TRIANGLE_FAN)
+				triangles += count > 2 ? count - 2 : 0;
+		}
+	}
+	return triangles;
+}
+
+void GltfModel::Draw(const Renderer& renderer, const Shader& shader) const
+{
+	for (const Mesh& mesh : m_Meshes)
+	{
+		for (const Primitive& primitive : mesh.primitives)
+		{
+			// missing attributes read the generic value instead
+			if (!primitive.hasNormals)
+				CALLGL(glVertexAttrib3f(1, 0.0f, 0.0f, 1.0f));
+			if (!primitive.hasColors)
+				CALLGL(glVertexAttrib4f(3, 1.0f, 1.0f, 1.0f, 1.0f));
+			renderer.Draw(*primitive.vao, *primitive.indexBuffer, shader, primitive.mode);
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+
+class Renderer;
+class Shader;
+
+// Meshes from a binary glTF 2.0 file (.glb).
+//
+// The file is memory mapped and every buffer view holding vertex data goes
+// to the GPU as one VertexBuffer, straight from the mapping. Accessors become
+// VertexBufferElements with the view's stride, so interleaved and separate
+// attribute layouts both work without touching the data. Indices are
+// uploaded from the mapping as well (32 bit ones narrowed when they fit).
+//
+// Attribute locations match Mesh.shader: POSITION 0, NORMAL 1, TEXCOORD_0 2,
+// COLOR_0 3. Primitives without indices, sparse accessors and external or
+// embedded-URI buffers are not supported.
+class GltfModel
+{
+public:
+	struct Primitive
+	{
+		std::unique_ptr<VertexArray> vao;
+		std::unique_ptr<IndexBuffer> indexBuffer;
+		unsigned int mode; // GL_TRIANGLES, GL_TRIANGLE_STRIP, ...
+		bool hasNormals;
+		bool hasColors;
+		glm::vec3 min, max;
+	};
+	struct Mesh
+	{
+		std::string name;
+		std::vector<Primitive> primitives;
+	};
+
+	struct LoadStats
+	{
+		size_t fileBytes;
+		size_t uploadedBytes;
+		double mapMs;
+		double parseMs;
+		// resolving accessors and paging the data in, on worker threads
+		double decodeMs;
+		double uploadMs;
+		unsigned int threads;
+	};
+
+private:
+	std::vector<std::unique_ptr<VertexBuffer>> m_VertexBuffers; // one per buffer view, shared by primitives
+	std::vector<Mesh> m_Meshes;
+	LoadStats m_Stats;
+
+public:
+	// threadCount 0 is one per core
+	GltfModel(const std::string& filepath, unsigned int threadCount = 0);
+	~GltfModel();
+
+	bool IsLoaded() const { return !m_Meshes.empty(); }
+	const std::vector<Mesh>& GetMeshes() const { return m_Meshes; }
+	const LoadStats& GetStats() const { return m_Stats; }
+	unsigned int GetTriangleCount() const;
+
+	// every primitive with the current uniforms of shader
+	void Draw(const Renderer& renderer, const Shader& shader) const;
+};
@@ -0,0 +1,49 @@
+#include "GpuTimer.h"
+
+#include "Renderer.h"
+
+GpuTimer::GpuTimer() :
+	m_Query(0),
+	m_Pending(false),
+	m_Running(false),
+	m_Ms(0.0)
+{
+	CALLGL(glGenQueries(1, &m_Query));
+}
+
+GpuTimer::~GpuTimer()
+{
+	CALLGL(glDeleteQueries(1, &m_Query));
+}
+
+bool GpuTimer::Poll()
+{
+	if (!m_Pending)
+		return false;
+	GLint available = 0;
+	CALLGL(glGetQueryObjectiv(m_Query, GL_QUERY_RESULT_AVAILABLE, &available));
+	if (!available)
+		return false;
+	GLuint64 ns = 0;
+	CALLGL(glGetQueryObjectui64v(m_Query, GL_QUERY_RESULT, &ns));
+	m_Ms = ns / 1000000.0;
+	m_Pending = false;
+	return true;
+}
+
+void GpuTimer::Begin()
+{
+	if (m_Pending || m_Running)
+		return;
+	CALLGL(glBeginQuery(GL_TIME_ELAPSED, m_Query));
+	m_Running = true;
+}
+
+void GpuTimer::End()
+{
+	if (!m_Running)
+		return;
+	CALLGL(glEndQuery(GL_TIME_ELAPSED));
+	m_Running = false;
+	m_Pending = true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// GPU time of everything between Begin and End, from a GL_TIME_ELAPSED
+// query that is read a frame or more later so nothing stalls. While a
+// result is still on its way Begin and End do nothing, one query in flight.
+//
+//   timer.Poll();    // takes a finished result
+//   timer.Begin();
+//   ...draws...
+//   timer.End();
+//   ImGui::Text("%.3f ms GPU", timer.GetMs());
+class GpuTimer
+{
+private:
+	unsigned int m_Query;
+	bool m_Pending;
+	bool m_Running;
+	double m_Ms;
+
+public:
+	GpuTimer();
+	~GpuTimer();
+	GpuTimer(const GpuTimer&) = delete;
+	GpuTimer& operator=(const GpuTimer&) = delete;
+
+	// true when a new result came in, GetMs has it
+	bool Poll();
+	void Begin();
+	void End();
+
+	// the last result, 0 until one came in
+	double GetMs() const { return m_Ms; }
+};
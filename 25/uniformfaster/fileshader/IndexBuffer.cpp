@@ -1,27 +1,153 @@
 
+#include <vector>
+
 #include "Renderer.h"
 #include "IndexBuffer.h"
+#include "GLBackend.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define INDEXBUFFER_USE_SSE2
+#endif
+
+unsigned int IndexBuffer::FindMaxIndex(const unsigned int* data, unsigned int count, bool primitiveRestart)
+{
+    unsigned int i = 0;
+    unsigned int result = 0;
+#ifdef INDEXBUFFER_USE_SSE2
+    // SSE2 has no unsigned 32 bit max, flipping the sign bit makes the
+    // signed compare order them the same way
+    const __m128i signBit = _mm_set1_epi32((int)0x80000000u);
+    const __m128i restart = _mm_set1_epi32(-1);
+    __m128i max = signBit; // 0
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+        if (primitiveRestart)
+            v = _mm_andnot_si128(_mm_cmpeq_epi32(v, restart), v);
+        v = _mm_xor_si128(v, signBit);
+        __m128i greater = _mm_cmpgt_epi32(v, max);
+        max = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, max));
+    }
+    alignas(16) unsigned int lanes[4];
+    _mm_store_si128((__m128i*)lanes, _mm_xor_si128(max, signBit));
+    for (unsigned int lane : lanes)
+        result = lane > result ? lane : result;
+#endif
+    for (; i < count; ++i)
+    {
+        if (primitiveRestart && data[i] == 0xFFFFFFFF)
+            continue;
+        result = data[i] > result ? data[i] : result;
+    }
+    return result;
+}
+
+void IndexBuffer::NarrowTo16(const unsigned int* src, unsigned short* dst, unsigned int count)
+{
+    unsigned int i = 0;
+#ifdef INDEXBUFFER_USE_SSE2
+    for (; i + 8 <= count; i += 8)
+    {
+        // sign extend the low 16 bits so the saturating pack keeps them as they are
+        __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 4));
+        a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+        b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = (unsigned short)src[i];
+}
+
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count, bool primitiveRestart) :
+    m_RenderID(0),
+    m_Count(count),
+    m_Type(GL_UNSIGNED_INT),
+    m_PrimitiveRestart(primitiveRestart)
+{
+    // 0xFFFF is either the restart index or reserved for it
+    if (FindMaxIndex(data, count, primitiveRestart) < 0xFFFF)
+    {
+        std::vector<unsigned short> narrow(count);
+        NarrowTo16(data, narrow.data(), count);
+        Create(narrow.data(), GL_UNSIGNED_SHORT);
+    }
+    else
+    {
+        Create(data, GL_UNSIGNED_INT);
+    }
+}
+IndexBuffer::IndexBuffer(const unsigned short* data, unsigned int count, bool primitiveRestart) :
+    m_RenderID(0),
+    m_Count(count),
+    m_Type(GL_UNSIGNED_SHORT),
+    m_PrimitiveRestart(primitiveRestart)
+{
+    Create(data, GL_UNSIGNED_SHORT);
+}
+IndexBuffer::IndexBuffer(const unsigned char* data, unsigned int count, bool primitiveRestart) :
+    m_RenderID(0),
+    m_Count(count),
+    m_Type(GL_UNSIGNED_BYTE),
+    m_PrimitiveRestart(primitiveRestart)
+{
+    Create(data, GL_UNSIGNED_BYTE);
+}
+IndexBuffer::~IndexBuffer()
+{
+    CALLGL(glDeleteBuffers(1, &m_RenderID));
+}
 
-IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count) :
-    m_Count(count)
+void IndexBuffer::Create(const void* data, unsigned int type)
 {
+    m_Type = type;
+    if (GLBackend::UseDSA())
+    {
+        CALLGL(glCreateBuffers(1, &m_RenderID));
+        CALLGL(glNamedBufferStorage(m_RenderID, GetSizeInBytes(), data, 0));
+        GLBackend::CountSavedBinds();
+        return;
+    }
+
+    // this also changes the index buffer of whatever VAO is bound
     CALLGL(glGenBuffers(1, &m_RenderID));
     CALLGL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RenderID));
+    GLBackend::CountBinds();
     CALLGL(glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        count * sizeof(unsigned int), //_countof(positions) * sizeof(float),  // 6 * 2 * sizeof(float)
+        GetSizeInBytes(), //_countof(positions) * sizeof(float),  // 6 * 2 * sizeof(float)
         data,
         GL_STATIC_DRAW));
 }
-IndexBuffer::~IndexBuffer()
+
+unsigned int IndexBuffer::GetIndexSize() const
 {
-    CALLGL(glDeleteBuffers(1, &m_RenderID));
+    switch (m_Type)
+    {
+    case GL_UNSIGNED_BYTE: return 1;
+    case GL_UNSIGNED_SHORT: return 2;
+    case GL_UNSIGNED_INT: return 4;
+    }
+    ASSERT_GL(false);
+    return 0;
+}
+unsigned int IndexBuffer::GetRestartIndex() const
+{
+    switch (m_Type)
+    {
+    case GL_UNSIGNED_BYTE: return 0xFF;
+    case GL_UNSIGNED_SHORT: return 0xFFFF;
+    }
+    return 0xFFFFFFFF;
 }
 
 void IndexBuffer::Bind() const
 {
     CALLGL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RenderID));
+    GLBackend::CountBinds();
 }
 void IndexBuffer::Unbind() const
 {
     CALLGL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-}
\ No newline at end of file
+}
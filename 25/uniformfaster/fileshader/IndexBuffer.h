@@ -4,8 +4,16 @@ class IndexBuffer {
 private:
 	unsigned int m_RenderID;
 	unsigned int m_Count;
+	unsigned int m_Type; // GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	bool m_PrimitiveRestart;
 public:
-	IndexBuffer(const unsigned int* data, unsigned int count);
+	// 32 bit indices are stored with the narrowest type that holds them
+	// (16 bit when every index is below 65535). with primitiveRestart the
+	// largest value of the type (0xFFFFFFFF in data) restarts the strip
+	IndexBuffer(const unsigned int* data, unsigned int count, bool primitiveRestart = false);
+	IndexBuffer(const unsigned short* data, unsigned int count, bool primitiveRestart = false);
+	// 8 bit indices are slow on some GPUs, so only used when asked for
+	IndexBuffer(const unsigned char* data, unsigned int count, bool primitiveRestart = false);
 	~IndexBuffer();
 
 	void Bind() const ;
@@ -14,4 +22,23 @@ public:
 	unsigned int GetCount() const {
 		return m_Count;
 	}
-};
\ No newline at end of file
+	unsigned int GetType() const {
+		return m_Type;
+	}
+	unsigned int GetIndexSize() const;
+	unsigned int GetSizeInBytes() const {
+		return m_Count * GetIndexSize();
+	}
+	bool HasPrimitiveRestart() const {
+		return m_PrimitiveRestart;
+	}
+	unsigned int GetRestartIndex() const;
+
+	// largest index in data, restart indices don't count
+	static unsigned int FindMaxIndex(const unsigned int* data, unsigned int count, bool primitiveRestart);
+	// keeps the low 16 bits, so 0xFFFFFFFF becomes the 16 bit restart index
+	static void NarrowTo16(const unsigned int* src, unsigned short* dst, unsigned int count);
+
+private:
+	void Create(const void* data, unsigned int type);
+};
@@ -0,0 +1,156 @@
+#include "IndirectScene.h"
+
+#include <algorithm>
+
+#include "Shader.h"
+#include "Frustum.h"
+
+IndirectScene::IndirectScene() :
+	m_VisibleCount(0)
+{
+}
+
+IndirectScene::~IndirectScene()
+{
+}
+
+unsigned int IndirectScene::AddMesh(const Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+	ASSERT_GL(!m_VAO);
+	Mesh mesh;
+	mesh.vertices.assign(vertices, vertices + vertexCount);
+	mesh.indices.assign(indices, indices + indexCount);
+	mesh.radius = 0.0f;
+	for (const Vertex& vertex : mesh.vertices)
+		mesh.radius = std::max(mesh.radius, glm::length(vertex.position));
+	m_Meshes.push_back(std::move(mesh));
+	return (unsigned int)m_Meshes.size() - 1;
+}
+
+void IndirectScene::AddInstance(unsigned int mesh, const glm::vec3& position, float scale, const glm::vec4& color)
+{
+	ASSERT_GL(!m_VAO && mesh < m_Meshes.size());
+	m_Instances.push_back({ { glm::vec4(position, scale), color }, mesh, m_Meshes[mesh].radius * scale, { 0, 0 } });
+}
+
+void IndirectScene::Build()
+{
+	// a mesh's instances have to be contiguous, its command draws a range of them
+	std::stable_sort(m_Instances.begin(), m_Instances.end(),
+		[](const SceneInstance& a, const SceneInstance& b) { return a.mesh < b.mesh; });
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	m_EmptyCommands.clear();
+	unsigned int firstInstance = 0;
+	for (unsigned int i = 0; i < m_Meshes.size(); ++i)
+	{
+		const Mesh& mesh = m_Meshes[i];
+		unsigned int instanceCount = 0;
+		while (firstInstance + instanceCount < m_Instances.size() && m_Instances[firstInstance + instanceCount].mesh == i)
+			++instanceCount;
+		m_EmptyCommands.push_back({ (unsigned int)mesh.indices.size(), 0, (unsigned int)indices.size(), (int)vertices.size(), firstInstance });
+		vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+		indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
+		firstInstance += instanceCount;
+	}
+	m_Commands = m_EmptyCommands;
+	m_Visible.resize(m_Instances.size());
+
+	unsigned int instanceCount = std::max((unsigned int)m_Instances.size(), 1u);
+	m_VertexBuffer = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(Vertex)));
+	m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+	// rewritten every cull, by glBufferSubData or by the compute shader
+	m_VisibleBuffer = std::make_unique<VertexBuffer>(nullptr, instanceCount * (unsigned int)sizeof(Instance), GL_DYNAMIC_DRAW);
+	m_VAO = std::make_unique<VertexArray>();
+	m_VAO->AddBuffer<Vertex>(*m_VertexBuffer);
+	unsigned int instances = m_VAO->AddBuffer<Instance>(*m_VisibleBuffer);
+	m_VAO->SetDivisor(instances, 1);
+	// only multi draw indirect reads it, and GL_SHADER_STORAGE_BUFFER
+	// doesn't exist on the drivers the per mesh fallback is for
+	if (Renderer::HasMultiDrawIndirect())
+	{
+		m_CommandBuffer = std::make_unique<StorageBuffer>(m_EmptyCommands.data(),
+			(unsigned int)(m_EmptyCommands.size() * sizeof(DrawElementsIndirectCommand)), GL_DYNAMIC_DRAW, GL_DRAW_INDIRECT_BUFFER);
+	}
+
+	if (Shader::HasCompute() && m_CommandBuffer)
+	{
+		m_InstanceBuffer = std::make_unique<StorageBuffer>(m_Instances.data(), instanceCount * (unsigned int)sizeof(SceneInstance), GL_STATIC_DRAW);
+		m_Culling = std::make_unique<Shader>("res/shaders/Culling.shader");
+	}
+}
+
+void IndirectScene::CullCpu(const Frustum& frustum)
+{
+	m_Commands = m_EmptyCommands;
+	m_VisibleCount = 0;
+	for (const SceneInstance& scene : m_Instances)
+	{
+		if (!frustum.IsSphereVisible(glm::vec3(scene.instance.positionScale), scene.radius))
+			continue;
+		DrawElementsIndirectCommand& command = m_Commands[scene.mesh];
+		m_Visible[command.baseInstance + command.instanceCount++] = scene.instance;
+		++m_VisibleCount;
+	}
+
+	// only the used part of each mesh's range
+	for (const DrawElementsIndirectCommand& command : m_Commands)
+	{
+		if (command.instanceCount)
+			m_VisibleBuffer->Update(&m_Visible[command.baseInstance], command.instanceCount * (unsigned int)sizeof(Instance),
+				command.baseInstance * (unsigned int)sizeof(Instance));
+	}
+	if (Renderer::HasMultiDrawIndirect())
+		m_CommandBuffer->Update(m_Commands.data(), (unsigned int)(m_Commands.size() * sizeof(DrawElementsIndirectCommand)));
+}
+
+void IndirectScene::CullGpu(const Renderer& renderer, const Frustum& frustum)
+{
+	ASSERT_GL(CanCullOnGpu());
+	if (m_Instances.empty())
+		return;
+
+	// the shader counts up from 0
+	m_CommandBuffer->Update(m_EmptyCommands.data(), (unsigned int)(m_EmptyCommands.size() * sizeof(DrawElementsIndirectCommand)));
+
+	m_Culling->Bind();
+	m_Culling->SetUniform1i("u_Count", (int)m_Instances.size());
+	static const char* PlaneNames[6] = { "u_Planes[0]", "u_Planes[1]", "u_Planes[2]", "u_Planes[3]", "u_Planes[4]", "u_Planes[5]" };
+	for (int i = 0; i < 6; ++i)
+	{
+		const glm::vec4& plane = frustum.planes[i];
+		m_Culling->SetUniform4f(PlaneNames[i], plane.x, plane.y, plane.z, plane.w);
+	}
+	m_InstanceBuffer->BindBase(0);
+	m_VisibleBuffer->BindBase(1);
+	m_CommandBuffer->BindBase(2);
+	renderer.Dispatch(*m_Culling, Renderer::GetGroupCount((unsigned int)m_Instances.size(), m_Culling->GetWorkGroupSize().x));
+	// the draw reads the counts as commands and the instances as attributes
+	renderer.Barrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+void IndirectScene::Draw(const Renderer& renderer, const Shader& shader) const
+{
+	if (Renderer::HasMultiDrawIndirect())
+	{
+		renderer.DrawIndirect(*m_VAO, *m_IndexBuffer, shader, *m_CommandBuffer, (unsigned int)m_Commands.size());
+		return;
+	}
+
+	// GL 3.3, no base instance either, so the instanced stream is moved to
+	// the mesh's range before each draw
+	shader.Bind();
+	shader.FlushUniforms();
+	m_VAO->Bind();
+	m_IndexBuffer->Bind();
+	for (unsigned int i = 0; i < m_Commands.size(); ++i)
+	{
+		const DrawElementsIndirectCommand& command = m_Commands[i];
+		if (!command.instanceCount)
+			continue;
+		m_VAO->SetBuffer(1, *m_VisibleBuffer, command.baseInstance * (unsigned int)sizeof(Instance));
+		CALLGL(glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.count, m_IndexBuffer->GetType(),
+			(const void*)(size_t)(command.firstIndex * m_IndexBuffer->GetIndexSize()), command.instanceCount, command.baseVertex));
+	}
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "IndexBuffer.h"
+#include "StorageBuffer.h"
+
+struct Frustum;
+
+// Lots of instances of a few meshes, drawn with one indirect draw per mesh
+// however many instances there are. The meshes share one vertex and index
+// buffer and the instances are grouped by mesh. Each frame the instances
+// are culled against the frustum (bounding spheres), the visible ones of a
+// mesh are packed into its range of an instanced stream and the instance
+// counts of the DrawElementsIndirectCommands are written.
+//
+// CullCpu does that on the CPU and uploads the result, CullGpu does it in
+// Culling.shader without anything crossing the bus (Shader::HasCompute and
+// Renderer::HasMultiDrawIndirect).
+// Draw submits the commands with one Renderer::DrawIndirect, without
+// multi draw indirect it falls back to an instanced draw per mesh, which
+// only works after CullCpu.
+//
+//   IndirectScene scene;
+//   unsigned int cube = scene.AddMesh(vertices, vertexCount, indices, indexCount);
+//   scene.AddInstance(cube, position, scale, color);
+//   ...
+//   scene.Build();
+//   scene.CullGpu(renderer, frustum);
+//   scene.Draw(renderer, shader);
+class IndirectScene
+{
+public:
+	struct Vertex
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+	};
+
+	// the instanced stream, struct Instance in Culling.shader
+	struct Instance
+	{
+		glm::vec4 positionScale; // xyz position, w uniform scale
+		glm::vec4 color;
+	};
+
+private:
+	// std430 struct SceneInstance in Culling.shader, 48 bytes
+	struct SceneInstance
+	{
+		Instance instance;
+		unsigned int mesh;
+		float radius; // bounding sphere around positionScale.xyz
+		unsigned int padding[2];
+	};
+
+	struct Mesh
+	{
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+		float radius; // around the origin
+	};
+
+	std::vector<Mesh> m_Meshes;
+	std::vector<SceneInstance> m_Instances;
+	// instanceCount 0, what every cull starts from
+	std::vector<DrawElementsIndirectCommand> m_EmptyCommands;
+	// last CullCpu, the fallback draws read them
+	std::vector<DrawElementsIndirectCommand> m_Commands;
+	std::vector<Instance> m_Visible;
+	unsigned int m_VisibleCount;
+
+	std::unique_ptr<VertexBuffer> m_VertexBuffer;
+	std::unique_ptr<IndexBuffer> m_IndexBuffer;
+	std::unique_ptr<VertexBuffer> m_VisibleBuffer;
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<StorageBuffer> m_CommandBuffer;
+	std::unique_ptr<StorageBuffer> m_InstanceBuffer;
+	std::unique_ptr<Shader> m_Culling;
+
+public:
+	IndirectScene();
+	~IndirectScene();
+
+	// returns the mesh index AddInstance takes
+	unsigned int AddMesh(const Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+	void AddInstance(unsigned int mesh, const glm::vec3& position, float scale, const glm::vec4& color);
+	// creates the buffers, meshes and instances can't be added afterwards
+	void Build();
+
+	void CullCpu(const Frustum& frustum);
+	// needs CanCullOnGpu, commands and instances stay on the GPU
+	void CullGpu(const Renderer& renderer, const Frustum& frustum);
+	bool CanCullOnGpu() const { return m_Culling && m_Culling->IsLinked(); }
+
+	// shader gets the instance as attributes 2 and 3, u_ViewProjection is up to the caller
+	void Draw(const Renderer& renderer, const Shader& shader) const;
+
+	unsigned int GetMeshCount() const { return (unsigned int)m_Meshes.size(); }
+	unsigned int GetInstanceCount() const { return (unsigned int)m_Instances.size(); }
+	// instances that passed the last CullCpu, GPU results aren't read back
+	unsigned int GetVisibleCount() const { return m_VisibleCount; }
+};
+
+VERTEX_LAYOUT(IndirectScene::Vertex,
+	VERTEX_ATTRIB(position),
+	VERTEX_ATTRIB(normal));
+
+VERTEX_LAYOUT(IndirectScene::Instance,
+	VERTEX_ATTRIB(positionScale),
+	VERTEX_ATTRIB(color));
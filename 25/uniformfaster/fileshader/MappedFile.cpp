@@ -0,0 +1,90 @@
+#include <iostream>
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& filepath) :
+	m_Data(nullptr),
+	m_Size(0),
+	m_File(INVALID_HANDLE_VALUE),
+	m_Mapping(nullptr)
+{
+	m_File = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	LARGE_INTEGER size;
+	if (m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_File, &size) || size.QuadPart == 0)
+	{
+		std::cerr << "Failed to open '" << filepath << "'" << std::endl;
+		return;
+	}
+	m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_Mapping)
+		m_Data = (const unsigned char*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!m_Data)
+	{
+		std::cerr << "Failed to map '" << filepath << "'" << std::endl;
+		return;
+	}
+	m_Size = (size_t)size.QuadPart;
+}
+MappedFile::~MappedFile()
+{
+	if (m_Data)
+		UnmapViewOfFile(m_Data);
+	if (m_Mapping)
+		CloseHandle(m_Mapping);
+	if (m_File != INVALID_HANDLE_VALUE)
+		CloseHandle(m_File);
+}
+#else
+MappedFile::MappedFile(const std::string& filepath) :
+	m_Data(nullptr),
+	m_Size(0),
+	m_File(-1)
+{
+	m_File = open(filepath.c_str(), O_RDONLY);
+	struct stat info;
+	if (m_File < 0 || fstat(m_File, &info) != 0 || info.st_size == 0)
+	{
+		std::cerr << "Failed to open '" << filepath << "'" << std::endl;
+		return;
+	}
+	void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, m_File, 0);
+	if (data == MAP_FAILED)
+	{
+		std::cerr << "Failed to map '" << filepath << "'" << std::endl;
+		return;
+	}
+	m_Data = (const unsigned char*)data;
+	m_Size = (size_t)info.st_size;
+}
+MappedFile::~MappedFile()
+{
+	if (m_Data)
+		munmap((void*)m_Data, m_Size);
+	if (m_File >= 0)
+		close(m_File);
+}
+#endif
+
+void MappedFile::Prefetch(size_t offset, size_t size) const
+{
+	if (!m_Data || offset >= m_Size)
+		return;
+	size_t end = offset + size < m_Size ? offset + size : m_Size;
+	volatile unsigned char sink = 0;
+	for (size_t i = offset; i < end; i += 4096)
+		sink += m_Data[i];
+	if (end > offset)
+		sink += m_Data[end - 1];
+}
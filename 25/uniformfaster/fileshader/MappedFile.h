@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// A whole file mapped read-only into memory, pages are read from disk
+// the first time they're touched
+class MappedFile
+{
+private:
+	const unsigned char* m_Data;
+	size_t m_Size;
+#ifdef _WIN32
+	void* m_File;
+	void* m_Mapping;
+#else
+	int m_File;
+#endif
+
+public:
+	MappedFile(const std::string& filepath);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool IsOpen() const { return m_Data != nullptr; }
+	const unsigned char* GetData() const { return m_Data; }
+	size_t GetSize() const { return m_Size; }
+
+	// reads one byte of every page in [offset, offset + size) so the
+	// disk reads happen on the calling thread instead of whoever uses the data
+	void Prefetch(size_t offset, size_t size) const;
+};
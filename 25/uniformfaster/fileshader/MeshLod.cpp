@@ -0,0 +1,57 @@
+#include <algorithm>
+
+#include "MeshLod.h"
+#include "MeshOptimizer.h"
+
+MeshLod::MeshLod(const unsigned int* indices, unsigned int indexCount, const glm::vec3* positions, unsigned int vertexCount,
+	unsigned int maxLevels, float reduction, float maxError) :
+	m_Center(0.0f),
+	m_Radius(0.0f)
+{
+	glm::vec3 low(1e30f), high(-1e30f);
+	for (unsigned int i = 0; i < indexCount; ++i)
+	{
+		low = glm::min(low, positions[indices[i]]);
+		high = glm::max(high, positions[indices[i]]);
+	}
+	m_Center = (low + high) * 0.5f;
+	for (unsigned int i = 0; i < indexCount; ++i)
+		m_Radius = std::max(m_Radius, glm::length(positions[indices[i]] - m_Center));
+
+	m_Levels.push_back({ std::make_unique<IndexBuffer>(indices, indexCount), indexCount / 3, 0.0f });
+
+	// every level starts from the full mesh, so its error is measured against
+	// the original surface rather than the level before
+	std::vector<unsigned int> lod(indexCount);
+	unsigned int target = indexCount;
+	for (unsigned int level = 1; level < maxLevels; ++level)
+	{
+		target = (unsigned int)(target * reduction) / 3 * 3;
+		float error = 0.0f;
+		unsigned int count = MeshOptimizer::Simplify(lod.data(), indices, indexCount, positions, vertexCount, target, maxError, &error);
+		// hit the error limit, nothing coarser to get
+		if (count == 0 || count >= m_Levels.back().triangleCount * 3)
+			break;
+		MeshOptimizer::OptimizeVertexCache(lod.data(), lod.data(), count, vertexCount);
+		m_Levels.push_back({ std::make_unique<IndexBuffer>(lod.data(), count), count / 3, std::max(error, m_Levels.back().error) });
+		if (count > target + target / 4)
+			break;
+	}
+}
+MeshLod::~MeshLod()
+{}
+
+unsigned int MeshLod::SelectLevel(float distance, float pixelsPerUnit, float maxPixelError, unsigned int currentLevel, float hysteresis) const
+{
+	// inside the bounding sphere everything is close
+	float scale = pixelsPerUnit / std::max(distance - m_Radius, 1e-3f);
+	unsigned int level = std::min(currentLevel, (unsigned int)m_Levels.size() - 1);
+
+	// too coarse now, go finer right away
+	while (level > 0 && m_Levels[level].error * scale > maxPixelError)
+		--level;
+	// coarser only with some margin
+	while (level + 1 < m_Levels.size() && m_Levels[level + 1].error * scale < maxPixelError * (1.0f - hysteresis))
+		++level;
+	return level;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "IndexBuffer.h"
+
+// Levels of detail for one mesh: index buffers of decreasing triangle count
+// that all index the mesh's single vertex buffer, made with
+// MeshOptimizer::Simplify when the mesh is loaded.
+//
+// SelectLevel picks a level from how big the mesh is on screen: the
+// coarsest one whose simplification error stays below maxPixelError
+// pixels. Every instance keeps its current level and only moves to a
+// coarser one once that is clearly good enough, so meshes right at a
+// threshold don't pop back and forth every frame.
+class MeshLod
+{
+private:
+	struct Level
+	{
+		std::unique_ptr<IndexBuffer> indexBuffer;
+		unsigned int triangleCount;
+		float error; // world units
+	};
+
+	std::vector<Level> m_Levels;
+	glm::vec3 m_Center;
+	float m_Radius;
+
+public:
+	// level 0 is the full mesh, every next one has reduction times the
+	// triangles of the one before. stops early when the mesh can't be
+	// simplified further without moving more than maxError (relative)
+	MeshLod(const unsigned int* indices, unsigned int indexCount, const glm::vec3* positions, unsigned int vertexCount,
+		unsigned int maxLevels = 6, float reduction = 0.5f, float maxError = 0.05f);
+	~MeshLod();
+
+	// pixelsPerUnit is how many pixels one world unit covers at distance 1:
+	// viewportHeight / 2 * projection[1][1]. hysteresis 0.25 means a coarser
+	// level has to be 25% under the limit before switching to it
+	unsigned int SelectLevel(float distance, float pixelsPerUnit, float maxPixelError, unsigned int currentLevel, float hysteresis = 0.25f) const;
+
+	unsigned int GetLevelCount() const { return (unsigned int)m_Levels.size(); }
+	const IndexBuffer& GetIndexBuffer(unsigned int level) const { return *m_Levels[level].indexBuffer; }
+	unsigned int GetTriangleCount(unsigned int level) const { return m_Levels[level].triangleCount; }
+	float GetError(unsigned int level) const { return m_Levels[level].error; }
+
+	// bounding sphere of the mesh, for distances
+	const glm::vec3& GetCenter() const { return m_Center; }
+	float GetRadius() const { return m_Radius; }
+};
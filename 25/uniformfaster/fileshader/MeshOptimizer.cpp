@@ -0,0 +1,437 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "MeshOptimizer.h"
+
+namespace MeshOptimizer {
+
+	VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize)
+	{
+		// a vertex is in the cache while fewer than cacheSize misses happened
+		// since it was loaded. loadedAt counts from 1, 0 is never loaded
+		std::vector<unsigned int> loadedAt(vertexCount, 0);
+		unsigned int misses = 0;
+		for (unsigned int i = 0; i < indexCount; ++i)
+		{
+			unsigned int v = indices[i];
+			if (loadedAt[v] == 0 || misses - loadedAt[v] >= cacheSize)
+			{
+				++misses;
+				loadedAt[v] = misses;
+			}
+		}
+
+		VertexCacheStats stats;
+		stats.misses = misses;
+		stats.acmr = indexCount >= 3 ? (float)misses / (indexCount / 3) : 0.0f;
+		stats.atvr = vertexCount ? (float)misses / vertexCount : 0.0f;
+		return stats;
+	}
+
+	struct Adjacency
+	{
+		std::vector<unsigned int> offsets; // vertexCount + 1
+		std::vector<unsigned int> triangles;
+	};
+
+	static void BuildAdjacency(Adjacency& adjacency, const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount)
+	{
+		adjacency.offsets.assign(vertexCount + 1, 0);
+		for (unsigned int i = 0; i < indexCount; ++i)
+			++adjacency.offsets[indices[i] + 1];
+		for (unsigned int v = 0; v < vertexCount; ++v)
+			adjacency.offsets[v + 1] += adjacency.offsets[v];
+
+		adjacency.triangles.resize(indexCount);
+		std::vector<unsigned int> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+		for (unsigned int i = 0; i < indexCount; ++i)
+			adjacency.triangles[fill[indices[i]]++] = i / 3;
+	}
+
+	void OptimizeVertexCache(unsigned int* dst, const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize)
+	{
+		if (indexCount == 0 || vertexCount == 0)
+			return;
+
+		// dst may alias indices
+		std::vector<unsigned int> source(indices, indices + indexCount);
+		Adjacency adjacency;
+		BuildAdjacency(adjacency, source.data(), indexCount, vertexCount);
+
+		std::vector<unsigned int> liveTriangles(vertexCount);
+		for (unsigned int v = 0; v < vertexCount; ++v)
+			liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+		std::vector<unsigned int> cacheTime(vertexCount, 0);
+		std::vector<bool> emitted(indexCount / 3, false);
+		std::vector<unsigned int> deadEnd;
+		std::vector<unsigned int> candidates;
+		deadEnd.reserve(indexCount);
+
+		unsigned int time = cacheSize + 1;
+		unsigned int cursor = 0;
+		unsigned int out = 0;
+		int fan = 0;
+
+		while (fan >= 0)
+		{
+			// emit every remaining triangle around the fanning vertex
+			candidates.clear();
+			for (unsigned int a = adjacency.offsets[fan]; a < adjacency.offsets[fan + 1]; ++a)
+			{
+				unsigned int t = adjacency.triangles[a];
+				if (emitted[t])
+					continue;
+				emitted[t] = true;
+				for (int k = 0; k < 3; ++k)
+				{
+					unsigned int v = source[t * 3 + k];
+					dst[out++] = v;
+					deadEnd.push_back(v);
+					candidates.push_back(v);
+					--liveTriangles[v];
+					if (time - cacheTime[v] > cacheSize)
+						cacheTime[v] = time++;
+				}
+			}
+
+			// next fan: the candidate that stays in the cache after its own
+			// triangles are emitted and was loaded the longest time ago
+			fan = -1;
+			int best = -1;
+			for (unsigned int v : candidates)
+			{
+				if (liveTriangles[v] == 0)
+					continue;
+				int priority = 0;
+				if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize)
+					priority = time - cacheTime[v];
+				if (priority > best)
+				{
+					best = priority;
+					fan = v;
+				}
+			}
+
+			if (fan < 0)
+			{
+				// dead end, go back to a recently used vertex, or the next one in input order
+				while (!deadEnd.empty() && fan < 0)
+				{
+					unsigned int v = deadEnd.back();
+					deadEnd.pop_back();
+					if (liveTriangles[v] > 0)
+						fan = v;
+				}
+				while (fan < 0 && cursor < vertexCount)
+				{
+					if (liveTriangles[cursor] > 0)
+						fan = cursor;
+					++cursor;
+				}
+			}
+		}
+	}
+
+	void OptimizeOverdraw(unsigned int* dst, const unsigned int* indices, unsigned int indexCount,
+		const glm::vec3* positions, unsigned int vertexCount, unsigned int cacheSize, float threshold)
+	{
+		unsigned int triangleCount = indexCount / 3;
+		if (triangleCount == 0)
+			return;
+		std::vector<unsigned int> source(indices, indices + indexCount);
+
+		// hard boundaries where all 3 vertices of a triangle miss, reordering
+		// there costs nothing. a cluster only ends at one if its ACMR is below
+		// threshold times the mesh's, otherwise it keeps going
+		float limit = AnalyzeVertexCache(source.data(), indexCount, vertexCount, cacheSize).acmr * threshold;
+		std::vector<unsigned int> clusters; // first triangle of each
+		{
+			std::vector<unsigned int> loadedAt(vertexCount, 0);
+			unsigned int misses = 0;
+			unsigned int clusterStart = 0;
+			unsigned int clusterMisses = 0;
+			for (unsigned int t = 0; t < triangleCount; ++t)
+			{
+				unsigned int triangleMisses = 0;
+				for (int k = 0; k < 3; ++k)
+				{
+					unsigned int v = source[t * 3 + k];
+					if (loadedAt[v] == 0 || misses - loadedAt[v] >= cacheSize)
+					{
+						++misses;
+						++triangleMisses;
+						loadedAt[v] = misses;
+					}
+				}
+				if (t == 0 || (triangleMisses == 3 && (float)clusterMisses / (t - clusterStart) <= limit))
+				{
+					clusters.push_back(t);
+					clusterStart = t;
+					clusterMisses = 0;
+				}
+				clusterMisses += triangleMisses;
+			}
+		}
+		clusters.push_back(triangleCount);
+
+		glm::vec3 meshCenter(0.0f);
+		for (unsigned int i = 0; i < indexCount; ++i)
+			meshCenter += positions[source[i]];
+		meshCenter /= (float)indexCount;
+
+		// how much a cluster faces away from the middle of the mesh
+		struct Cluster
+		{
+			unsigned int first;
+			unsigned int end;
+			float key;
+		};
+		std::vector<Cluster> sorted(clusters.size() - 1);
+		for (unsigned int c = 0; c + 1 < clusters.size(); ++c)
+		{
+			glm::vec3 center(0.0f), normal(0.0f);
+			float area = 0.0f;
+			for (unsigned int t = clusters[c]; t < clusters[c + 1]; ++t)
+			{
+				const glm::vec3& a = positions[source[t * 3 + 0]];
+				const glm::vec3& b = positions[source[t * 3 + 1]];
+				const glm::vec3& d = positions[source[t * 3 + 2]];
+				glm::vec3 n = glm::cross(b - a, d - a); // length is twice the area
+				float triangleArea = glm::length(n);
+				center += (a + b + d) * (triangleArea / 3.0f);
+				normal += n;
+				area += triangleArea;
+			}
+			if (area > 0.0f)
+				center /= area;
+			float normalLength = glm::length(normal);
+			sorted[c] = { clusters[c], clusters[c + 1],
+				normalLength > 0.0f ? glm::dot(center - meshCenter, normal / normalLength) : 0.0f };
+		}
+		std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) { return a.key > b.key; });
+
+		unsigned int out = 0;
+		for (const Cluster& cluster : sorted)
+		{
+			memcpy(dst + out, source.data() + cluster.first * 3, (cluster.end - cluster.first) * 3 * sizeof(unsigned int));
+			out += (cluster.end - cluster.first) * 3;
+		}
+	}
+
+	unsigned int OptimizeVertexFetch(void* dstVertices, unsigned int* indices, unsigned int indexCount,
+		const void* vertices, unsigned int vertexCount, unsigned int vertexSize)
+	{
+		const unsigned int unused = 0xFFFFFFFF;
+		std::vector<unsigned int> remap(vertexCount, unused);
+		unsigned int next = 0;
+		for (unsigned int i = 0; i < indexCount; ++i)
+		{
+			unsigned int& slot = remap[indices[i]];
+			if (slot == unused)
+			{
+				slot = next++;
+				memcpy((unsigned char*)dstVertices + slot * vertexSize,
+					(const unsigned char*)vertices + indices[i] * vertexSize, vertexSize);
+			}
+			indices[i] = slot;
+		}
+		return next;
+	}
+
+	// symmetric 4x4 matrix of the squared distance to a set of planes,
+	// weighted by triangle area. Error divides the weight out again
+	struct Quadric
+	{
+		float a00, a01, a02, a03;
+		float a11, a12, a13;
+		float a22, a23;
+		float a33;
+		float weight;
+
+		void AddPlane(const glm::vec3& n, float d, float weight)
+		{
+			a00 += weight * n.x * n.x; a01 += weight * n.x * n.y; a02 += weight * n.x * n.z; a03 += weight * n.x * d;
+			a11 += weight * n.y * n.y; a12 += weight * n.y * n.z; a13 += weight * n.y * d;
+			a22 += weight * n.z * n.z; a23 += weight * n.z * d;
+			a33 += weight * d * d;
+			this->weight += weight;
+		}
+		void Add(const Quadric& q)
+		{
+			a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+			a11 += q.a11; a12 += q.a12; a13 += q.a13;
+			a22 += q.a22; a23 += q.a23;
+			a33 += q.a33;
+			weight += q.weight;
+		}
+		float Error(const glm::vec3& p) const
+		{
+			float e = a00 * p.x * p.x + 2.0f * a01 * p.x * p.y + 2.0f * a02 * p.x * p.z + 2.0f * a03 * p.x
+				+ a11 * p.y * p.y + 2.0f * a12 * p.y * p.z + 2.0f * a13 * p.y
+				+ a22 * p.z * p.z + 2.0f * a23 * p.z
+				+ a33;
+			return e > 0.0f && weight > 0.0f ? e / weight : 0.0f;
+		}
+	};
+
+	struct Collapse
+	{
+		unsigned int from;
+		unsigned int to;
+		float cost;
+	};
+
+	// moving from onto to must not turn any of from's other triangles over
+	static bool FlipsTriangle(const Adjacency& adjacency, const std::vector<unsigned int>& indices,
+		const glm::vec3* positions, unsigned int from, unsigned int to)
+	{
+		for (unsigned int a = adjacency.offsets[from]; a < adjacency.offsets[from + 1]; ++a)
+		{
+			const unsigned int* t = &indices[adjacency.triangles[a] * 3];
+			if (t[0] == to || t[1] == to || t[2] == to)
+				continue; // collapses away
+			glm::vec3 p[3], q[3];
+			for (int k = 0; k < 3; ++k)
+			{
+				p[k] = positions[t[k]];
+				q[k] = positions[t[k] == from ? to : t[k]];
+			}
+			glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+			glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+			if (glm::dot(before, after) <= 0.0f)
+				return true;
+		}
+		return false;
+	}
+
+	unsigned int Simplify(unsigned int* dst, const unsigned int* indices, unsigned int indexCount,
+		const glm::vec3* positions, unsigned int vertexCount, unsigned int targetIndexCount,
+		float targetError, float* error)
+	{
+		std::vector<unsigned int> current(indices, indices + indexCount);
+		float maxError = 0.0f;
+
+		glm::vec3 low(1e30f), high(-1e30f);
+		for (unsigned int i = 0; i < indexCount; ++i)
+		{
+			low = glm::min(low, positions[current[i]]);
+			high = glm::max(high, positions[current[i]]);
+		}
+		float extent = glm::length(high - low);
+		float errorLimit = targetError * extent;
+
+		std::vector<Quadric> quadrics(vertexCount, Quadric{});
+		for (unsigned int i = 0; i < indexCount; i += 3)
+		{
+			const glm::vec3& a = positions[current[i]];
+			glm::vec3 n = glm::cross(positions[current[i + 1]] - a, positions[current[i + 2]] - a);
+			float area = glm::length(n);
+			if (area == 0.0f)
+				continue;
+			n /= area;
+			for (int k = 0; k < 3; ++k)
+				quadrics[current[i + k]].AddPlane(n, -glm::dot(n, a), area);
+		}
+
+		// a border edge is used by a single triangle, its vertices stay where they are
+		std::vector<bool> locked(vertexCount, false);
+		{
+			std::vector<std::pair<unsigned int, unsigned int>> edges;
+			edges.reserve(indexCount);
+			for (unsigned int i = 0; i < indexCount; i += 3)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					unsigned int a = current[i + k], b = current[i + (k + 1) % 3];
+					edges.push_back({ std::min(a, b), std::max(a, b) });
+				}
+			}
+			std::sort(edges.begin(), edges.end());
+			for (size_t e = 0; e < edges.size();)
+			{
+				size_t same = e + 1;
+				while (same < edges.size() && edges[same] == edges[e])
+					++same;
+				if (same - e == 1)
+					locked[edges[e].first] = locked[edges[e].second] = true;
+				e = same;
+			}
+		}
+
+		std::vector<Collapse> collapses;
+		std::vector<unsigned int> remap(vertexCount);
+		std::vector<bool> touched(vertexCount);
+		Adjacency adjacency;
+		while (current.size() > targetIndexCount)
+		{
+			// every edge in both directions, cost is the error at the vertex it keeps
+			collapses.clear();
+			for (size_t i = 0; i < current.size(); i += 3)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					unsigned int a = current[i + k], b = current[i + (k + 1) % 3];
+					Quadric q = quadrics[a];
+					q.Add(quadrics[b]);
+					if (!locked[a])
+						collapses.push_back({ a, b, q.Error(positions[b]) });
+					if (!locked[b])
+						collapses.push_back({ b, a, q.Error(positions[a]) });
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+			// as many independent collapses as fit in this pass, a collapse
+			// removes about two triangles
+			BuildAdjacency(adjacency, current.data(), (unsigned int)current.size(), vertexCount);
+			for (unsigned int v = 0; v < vertexCount; ++v)
+				remap[v] = v;
+			std::fill(touched.begin(), touched.end(), false);
+			size_t removable = (current.size() - targetIndexCount) / 6 + 1;
+			size_t applied = 0;
+			for (const Collapse& collapse : collapses)
+			{
+				if (applied >= removable || collapse.cost > errorLimit * errorLimit)
+					break;
+				if (touched[collapse.from] || touched[collapse.to])
+					continue;
+				if (FlipsTriangle(adjacency, current, positions, collapse.from, collapse.to))
+					continue;
+
+				// everything around from changes, leave it alone until the next pass
+				for (unsigned int a = adjacency.offsets[collapse.from]; a < adjacency.offsets[collapse.from + 1]; ++a)
+				{
+					const unsigned int* t = &current[adjacency.triangles[a] * 3];
+					touched[t[0]] = touched[t[1]] = touched[t[2]] = true;
+				}
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to].Add(quadrics[collapse.from]);
+				maxError = std::max(maxError, collapse.cost);
+				++applied;
+			}
+			if (applied == 0)
+				break;
+
+			size_t out = 0;
+			for (size_t i = 0; i < current.size(); i += 3)
+			{
+				unsigned int a = remap[current[i]], b = remap[current[i + 1]], c = remap[current[i + 2]];
+				if (a == b || b == c || c == a)
+					continue;
+				current[out++] = a;
+				current[out++] = b;
+				current[out++] = c;
+			}
+			current.resize(out);
+		}
+
+		if (error)
+			*error = std::sqrt(maxError);
+		memcpy(dst, current.data(), current.size() * sizeof(unsigned int));
+		return (unsigned int)current.size();
+	}
+
+} // namespace MeshOptimizer
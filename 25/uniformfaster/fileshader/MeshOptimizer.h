@@ -0,0 +1,52 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+// Reorders mesh data before it goes into VertexBuffer/IndexBuffer so the
+// GPU reuses more transformed vertices and shades fewer hidden pixels.
+// All index lists are triangle lists. dst may be the same array as indices.
+//
+// typical order:
+//   OptimizeVertexCache(indices, indices, indexCount, vertexCount);
+//   OptimizeOverdraw(indices, indices, indexCount, positions, vertexCount);
+//   vertexCount = OptimizeVertexFetch(optimized, indices, indexCount, vertices, vertexCount, sizeof(Vertex));
+namespace MeshOptimizer {
+
+	// post-transform cache simulation with a FIFO of cacheSize entries
+	struct VertexCacheStats
+	{
+		unsigned int misses;
+		// misses per triangle, 0.5 is the best a grid can do, 3 the worst
+		float acmr;
+		// misses per vertex, 1 is ideal
+		float atvr;
+	};
+	VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize = 16);
+
+	// Tipsify (Sander, Nehab, Barczak 2007): fans around the vertex that will
+	// stay in the cache longest, linear time
+	void OptimizeVertexCache(unsigned int* dst, const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize = 16);
+
+	// reorders clusters of cache optimized triangles so the ones facing out
+	// of the mesh come first, they tend to hide the rest. clusters start where
+	// the cache is cold anyway, so ACMR grows by at most threshold
+	void OptimizeOverdraw(unsigned int* dst, const unsigned int* indices, unsigned int indexCount,
+		const glm::vec3* positions, unsigned int vertexCount, unsigned int cacheSize = 16, float threshold = 1.05f);
+
+	// vertices in the order they are first used, indices rewritten to match.
+	// unused vertices are dropped, returns how many are left.
+	// dstVertices must not overlap vertices
+	unsigned int OptimizeVertexFetch(void* dstVertices, unsigned int* indices, unsigned int indexCount,
+		const void* vertices, unsigned int vertexCount, unsigned int vertexSize);
+
+	// quadric error edge collapse (Garland, Heckbert 1997) that only moves
+	// vertices onto existing ones, so every level of detail can index the
+	// same vertex buffer. stops at targetIndexCount or once a collapse would
+	// move the surface further than targetError (relative to the mesh
+	// extent). open borders are kept. returns the new index count, error gets
+	// the largest deviation in world units
+	unsigned int Simplify(unsigned int* dst, const unsigned int* indices, unsigned int indexCount,
+		const glm::vec3* positions, unsigned int vertexCount, unsigned int targetIndexCount,
+		float targetError = 0.01f, float* error = nullptr);
+
+} // namespace MeshOptimizer
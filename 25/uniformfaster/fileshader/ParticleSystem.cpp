@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "ParticleSystem.h"
+#include "ShaderPreprocessor.h"
+#include "VertexBufferLayout.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PARTICLES_USE_SSE2
+#endif
+
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+// below this a thread costs more to start than it saves
+static const unsigned int MinParticlesPerThread = 32768;
+
+static const VertexBufferElement FloatStream[] = { { GL_FLOAT, 1, GL_FALSE, 0, GL_FALSE } };
+static const VertexBufferElement Vec2Stream[] = { { GL_FLOAT, 2, GL_FALSE, 0, GL_FALSE } };
+// a vec2 buffer read as two floats, Particle.shader takes x and y apart
+static const VertexBufferElement SplitVec2Stream[] = { { GL_FLOAT, 1, GL_FALSE, 0, GL_FALSE }, { GL_FLOAT, 1, GL_FALSE, 4, GL_FALSE } };
+
+// the same as Hash and Random in ParticleUpdate.shader
+static unsigned int Hash(unsigned int x)
+{
+	x ^= x >> 16;
+	x *= 0x7FEB352Du;
+	x ^= x >> 15;
+	x *= 0x846CA68Bu;
+	x ^= x >> 16;
+	return x;
+}
+
+static float Random(unsigned int x)
+{
+	return (Hash(x) >> 8) * (1.0f / 16777216.0f);
+}
+
+static unsigned int GetFrameSeed(unsigned int frame)
+{
+	return frame * 0x9E3779B9u;
+}
+
+void ParticleStore::Resize(unsigned int count)
+{
+	positionX.resize(count);
+	positionY.resize(count);
+	velocityX.resize(count);
+	velocityY.resize(count);
+	life.resize(count);
+}
+
+ParticleSystem::ParticleSystem(unsigned int count, Backend backend, const ParticleEmitter& emitter) :
+	m_Backend(backend),
+	m_Emitter(emitter),
+	m_Count(count),
+	m_Frame(0),
+	m_ThreadCount(0),
+	m_Stats{},
+	m_Current(0)
+{
+	// all born at once would also die at once, start them part way through
+	m_Store.Resize(count);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		Respawn(i, 0);
+		m_Store.life[i] *= Random(Hash(i) + 3);
+	}
+
+	glm::vec2 corners[] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f } };
+	m_QuadBuffer = std::make_unique<VertexBuffer>(corners, (unsigned int)sizeof(corners));
+	m_DrawShader = std::make_unique<Shader>("res/shaders/Particle.shader");
+
+	unsigned int floats = count * (unsigned int)sizeof(float);
+	if (backend == Backend::Cpu)
+	{
+		m_PositionXBuffer = std::make_unique<VertexBuffer>(m_Store.positionX.data(), floats, GL_STREAM_DRAW);
+		m_PositionYBuffer = std::make_unique<VertexBuffer>(m_Store.positionY.data(), floats, GL_STREAM_DRAW);
+		m_LifeBuffer = std::make_unique<VertexBuffer>(m_Store.life.data(), floats, GL_STREAM_DRAW);
+		m_DrawVAO = std::make_unique<VertexArray>();
+		m_DrawVAO->AddBuffer(*m_QuadBuffer, Vec2Stream, 1, 8);
+		m_DrawVAO->SetDivisor(m_DrawVAO->AddBuffer(*m_PositionXBuffer, FloatStream, 1, 4), 1);
+		m_DrawVAO->SetDivisor(m_DrawVAO->AddBuffer(*m_PositionYBuffer, FloatStream, 1, 4), 1);
+		m_DrawVAO->SetDivisor(m_DrawVAO->AddBuffer(*m_LifeBuffer, FloatStream, 1, 4), 1);
+		return;
+	}
+
+	ShaderProgramSources sources;
+	if (ShaderPreprocessor::Process("res/shaders/ParticleUpdate.shader", {}, sources))
+	{
+		sources.FeedbackVaryings = { "o_Position", "o_Velocity", "o_Life" };
+		m_UpdateShader = std::make_unique<Shader>("res/shaders/ParticleUpdate.shader", sources);
+	}
+
+	std::vector<glm::vec2> positions(count), velocities(count);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		positions[i] = { m_Store.positionX[i], m_Store.positionY[i] };
+		velocities[i] = { m_Store.velocityX[i], m_Store.velocityY[i] };
+	}
+	for (int side = 0; side < 2; ++side)
+	{
+		// the second set is written by the first update
+		GpuState& state = m_Gpu[side];
+		state.position = std::make_unique<VertexBuffer>(side ? nullptr : positions.data(), 2 * floats, GL_DYNAMIC_COPY);
+		state.velocity = std::make_unique<VertexBuffer>(side ? nullptr : velocities.data(), 2 * floats, GL_DYNAMIC_COPY);
+		state.life = std::make_unique<VertexBuffer>(side ? nullptr : m_Store.life.data(), floats, GL_DYNAMIC_COPY);
+
+		state.updateVAO = std::make_unique<VertexArray>();
+		state.updateVAO->AddBuffer(*state.position, Vec2Stream, 1, 8);
+		state.updateVAO->AddBuffer(*state.velocity, Vec2Stream, 1, 8);
+		state.updateVAO->AddBuffer(*state.life, FloatStream, 1, 4);
+
+		state.drawVAO = std::make_unique<VertexArray>();
+		state.drawVAO->AddBuffer(*m_QuadBuffer, Vec2Stream, 1, 8);
+		state.drawVAO->SetDivisor(state.drawVAO->AddBuffer(*state.position, SplitVec2Stream, 2, 8), 1);
+		state.drawVAO->SetDivisor(state.drawVAO->AddBuffer(*state.life, FloatStream, 1, 4), 1);
+	}
+	m_Store = ParticleStore();
+}
+
+ParticleSystem::~ParticleSystem()
+{
+}
+
+bool ParticleSystem::IsValid() const
+{
+	return m_DrawShader->IsLinked() && (m_Backend == Backend::Cpu || (m_UpdateShader && m_UpdateShader->IsLinked()));
+}
+
+void ParticleSystem::Respawn(unsigned int index, unsigned int frame)
+{
+	unsigned int seed = Hash(index ^ GetFrameSeed(frame));
+	m_Store.positionX[index] = m_Emitter.position.x;
+	m_Store.positionY[index] = m_Emitter.position.y;
+	m_Store.velocityX[index] = (Random(seed) - 0.5f) * m_Emitter.spread;
+	m_Store.velocityY[index] = m_Emitter.speed * (0.5f + 0.5f * Random(seed + 1));
+	m_Store.life[index] = m_Emitter.lifetime * (0.5f + 0.5f * Random(seed + 2));
+}
+
+void ParticleSystem::UpdateRange(unsigned int begin, unsigned int end, float deltatime)
+{
+	float* positionX = m_Store.positionX.data();
+	float* positionY = m_Store.positionY.data();
+	float* velocityX = m_Store.velocityX.data();
+	float* velocityY = m_Store.velocityY.data();
+	float* life = m_Store.life.data();
+	float gravityX = m_Emitter.gravity.x * deltatime;
+	float gravityY = m_Emitter.gravity.y * deltatime;
+
+	unsigned int i = begin;
+#ifdef PARTICLES_USE_SSE2
+	const __m128 dt = _mm_set1_ps(deltatime);
+	const __m128 gx = _mm_set1_ps(gravityX);
+	const __m128 gy = _mm_set1_ps(gravityY);
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= end; i += 4)
+	{
+		__m128 vx = _mm_add_ps(_mm_loadu_ps(velocityX + i), gx);
+		__m128 vy = _mm_add_ps(_mm_loadu_ps(velocityY + i), gy);
+		_mm_storeu_ps(velocityX + i, vx);
+		_mm_storeu_ps(velocityY + i, vy);
+		_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(vx, dt)));
+		_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, dt)));
+		__m128 l = _mm_sub_ps(_mm_loadu_ps(life + i), dt);
+		_mm_storeu_ps(life + i, l);
+
+		// a few lanes a frame at most, scalar is fine for those
+		int dead = _mm_movemask_ps(_mm_cmple_ps(l, zero));
+		if (dead)
+		{
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				if (dead & (1 << lane))
+					Respawn(i + lane, m_Frame);
+			}
+		}
+	}
+#endif
+	for (; i < end; ++i)
+	{
+		velocityX[i] += gravityX;
+		velocityY[i] += gravityY;
+		positionX[i] += velocityX[i] * deltatime;
+		positionY[i] += velocityY[i] * deltatime;
+		life[i] -= deltatime;
+		if (life[i] <= 0.0f)
+			Respawn(i, m_Frame);
+	}
+}
+
+void ParticleSystem::UpdateCpu(float deltatime)
+{
+	Clock::time_point start = Clock::now();
+	unsigned int threads = m_ThreadCount;
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 4;
+	threads = std::max(1u, std::min(threads, m_Count / MinParticlesPerThread));
+	// multiples of 4, only the last range has a scalar tail. rounded up
+	// twice, so threads * chunk never falls short of m_Count
+	unsigned int chunk = ((m_Count + threads - 1) / threads + 3) & ~3u;
+
+	// every particle is written by exactly one thread, no locking
+	std::vector<std::thread> workers;
+	for (unsigned int t = 1; t < threads; ++t)
+	{
+		unsigned int begin = t * chunk;
+		if (begin < m_Count)
+			workers.emplace_back(&ParticleSystem::UpdateRange, this, begin, std::min(begin + chunk, m_Count), deltatime);
+	}
+	UpdateRange(0, std::min(chunk, m_Count), deltatime);
+	for (std::thread& worker : workers)
+		worker.join();
+	m_Stats.simulateMs = Milliseconds(Clock::now() - start).count();
+	m_Stats.threads = threads;
+
+	// the arrays go up as they are, one stream each
+	start = Clock::now();
+	unsigned int floats = m_Count * (unsigned int)sizeof(float);
+	m_PositionXBuffer->Update(m_Store.positionX.data(), floats);
+	m_PositionYBuffer->Update(m_Store.positionY.data(), floats);
+	m_LifeBuffer->Update(m_Store.life.data(), floats);
+	m_Stats.uploadMs = Milliseconds(Clock::now() - start).count();
+}
+
+void ParticleSystem::UpdateFeedback(const Renderer& renderer, float deltatime)
+{
+	if (!m_UpdateShader || !m_UpdateShader->IsLinked())
+		return;
+
+	Clock::time_point start = Clock::now();
+	const GpuState& source = m_Gpu[m_Current];
+	const GpuState& target = m_Gpu[1 - m_Current];
+
+	Shader& shader = *m_UpdateShader;
+	shader.Bind();
+	shader.SetUniform1f("u_DeltaTime", deltatime);
+	shader.SetUniform2f("u_Gravity", m_Emitter.gravity.x, m_Emitter.gravity.y);
+	shader.SetUniform2f("u_Emitter", m_Emitter.position.x, m_Emitter.position.y);
+	shader.SetUniform1f("u_Speed", m_Emitter.speed);
+	shader.SetUniform1f("u_Spread", m_Emitter.spread);
+	shader.SetUniform1f("u_Lifetime", m_Emitter.lifetime);
+	shader.SetUniform1i("u_Seed", (int)GetFrameSeed(m_Frame));
+
+	// in the order of FeedbackVaryings
+	CALLGL(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, target.position->GetRendererID()));
+	CALLGL(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 1, target.velocity->GetRendererID()));
+	CALLGL(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 2, target.life->GetRendererID()));
+	CALLGL(glEnable(GL_RASTERIZER_DISCARD));
+	CALLGL(glBeginTransformFeedback(GL_POINTS));
+	renderer.DrawArrays(*source.updateVAO, shader, 0, m_Count, 1, GL_POINTS);
+	CALLGL(glEndTransformFeedback());
+	CALLGL(glDisable(GL_RASTERIZER_DISCARD));
+	for (unsigned int i = 0; i < 3; ++i)
+		CALLGL(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, i, 0));
+
+	m_Current = 1 - m_Current;
+	m_Stats.simulateMs = Milliseconds(Clock::now() - start).count();
+	m_Stats.uploadMs = 0.0;
+	m_Stats.threads = 0;
+}
+
+void ParticleSystem::Update(const Renderer& renderer, float deltatime)
+{
+	++m_Frame;
+	if (m_Backend == Backend::Cpu)
+		UpdateCpu(deltatime);
+	else
+		UpdateFeedback(renderer, deltatime);
+}
+
+void ParticleSystem::Draw(const Renderer& renderer, const glm::mat4& viewProjection, float size) const
+{
+	Shader& shader = *m_DrawShader;
+	shader.Bind();
+	shader.SetUniformMat4f("u_ViewProjection", viewProjection);
+	shader.SetUniform1f("u_Size", size);
+	shader.SetUniform1f("u_Lifetime", m_Emitter.lifetime);
+	const VertexArray& va = m_Backend == Backend::Cpu ? *m_DrawVAO : *m_Gpu[m_Current].drawVAO;
+	renderer.DrawArrays(va, shader, 0, 4, m_Count, GL_TRIANGLE_STRIP);
+}
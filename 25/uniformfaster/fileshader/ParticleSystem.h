@@ -0,0 +1,119 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+// Particles as a structure of arrays, one array per field, so an update
+// streams through each of them four particles at a time and the render
+// streams upload without repacking.
+struct ParticleStore
+{
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> velocityX;
+	std::vector<float> velocityY;
+	// seconds left, the particle respawns at the emitter when it runs out
+	std::vector<float> life;
+
+	void Resize(unsigned int count);
+	unsigned int GetCount() const { return (unsigned int)life.size(); }
+};
+
+// a fountain, shared by both backends
+struct ParticleEmitter
+{
+	glm::vec2 position;
+	glm::vec2 gravity;
+	float speed;    // upwards, respawned particles get 50..100% of it
+	float spread;   // sideways velocity range
+	float lifetime; // respawned particles live 50..100% of it
+};
+
+// A fixed number of particles that die and respawn, drawn as instanced
+// quads with Particle.shader (additive, premultiplied).
+//
+// Cpu updates the ParticleStore with SSE2 on several threads and uploads
+// position and life every frame. TransformFeedback keeps the particles in
+// two sets of GPU buffers and runs ParticleUpdate.shader from one into the
+// other (GL 3.3), nothing is uploaded after the start. Respawns use the
+// same hash of particle index and frame on both, so they behave the same.
+//
+//   ParticleSystem particles(1000000, ParticleSystem::Backend::TransformFeedback, emitter);
+//   particles.Update(renderer, deltatime);
+//   particles.Draw(renderer, viewProj, 2.0f);
+class ParticleSystem
+{
+public:
+	enum class Backend { Cpu, TransformFeedback };
+
+	struct Stats
+	{
+		double simulateMs; // CPU update, or submitting the feedback pass
+		double uploadMs;   // CPU backend only
+		unsigned int threads;
+	};
+
+private:
+	struct GpuState
+	{
+		std::unique_ptr<VertexBuffer> position; // vec2
+		std::unique_ptr<VertexBuffer> velocity; // vec2
+		std::unique_ptr<VertexBuffer> life;     // float
+		std::unique_ptr<VertexArray> updateVAO;
+		std::unique_ptr<VertexArray> drawVAO;
+	};
+
+	Backend m_Backend;
+	ParticleEmitter m_Emitter;
+	// TransformFeedback lets go of it once the buffers have it
+	ParticleStore m_Store;
+	unsigned int m_Count;
+	unsigned int m_Frame;
+	unsigned int m_ThreadCount;
+	Stats m_Stats;
+
+	// corners of the quad, per vertex
+	std::unique_ptr<VertexBuffer> m_QuadBuffer;
+	std::unique_ptr<Shader> m_DrawShader;
+
+	// Cpu: the streams the store uploads into
+	std::unique_ptr<VertexBuffer> m_PositionXBuffer;
+	std::unique_ptr<VertexBuffer> m_PositionYBuffer;
+	std::unique_ptr<VertexBuffer> m_LifeBuffer;
+	std::unique_ptr<VertexArray> m_DrawVAO;
+
+	// TransformFeedback: read from m_Gpu[m_Current], write to the other
+	GpuState m_Gpu[2];
+	unsigned int m_Current;
+	std::unique_ptr<Shader> m_UpdateShader;
+
+public:
+	ParticleSystem(unsigned int count, Backend backend, const ParticleEmitter& emitter);
+	~ParticleSystem();
+
+	void SetEmitter(const ParticleEmitter& emitter) { m_Emitter = emitter; }
+	// Cpu backend, 0 for one per hardware thread
+	void SetThreadCount(unsigned int threads) { m_ThreadCount = threads; }
+
+	void Update(const Renderer& renderer, float deltatime);
+	// size is the quad's half width in world units
+	void Draw(const Renderer& renderer, const glm::mat4& viewProjection, float size) const;
+
+	Backend GetBackend() const { return m_Backend; }
+	unsigned int GetCount() const { return m_Count; }
+	const Stats& GetStats() const { return m_Stats; }
+	// the shaders linked, TransformFeedback needs no more than GL 3.3
+	bool IsValid() const;
+
+private:
+	void Respawn(unsigned int index, unsigned int frame);
+	void UpdateRange(unsigned int begin, unsigned int end, float deltatime);
+	void UpdateCpu(float deltatime);
+	void UpdateFeedback(const Renderer& renderer, float deltatime);
+};
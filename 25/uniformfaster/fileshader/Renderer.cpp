@@ -1,5 +1,6 @@
 #include <iostream>
 #include "Renderer.h"
+#include "ShaderReflection.h"
 
 void ClearGLError()
 {
@@ -22,21 +23,114 @@ bool LogGLCall(const char* funcname, const char* filename, int line)
     return true;
 }
 
+// attributes and shader inputs written by hand drift apart quietly, every
+// draw entry point looks once per vertex array and program in debug builds
+static void CheckVertexInputs(const VertexArray& va, const Shader& shader)
+{
+#ifdef _DEBUG
+    if (va.NeedsInputCheck(shader.GetRendererID()))
+    {
+        for (const std::string& problem : shader.GetReflection().CheckVertexArray(va))
+            std::cerr << "[vertex input] " << shader.GetFilePath() << " " << problem << std::endl;
+    }
+#endif
+}
+
 void Renderer::Clear() const
 {
     CALLGL(glClear(GL_COLOR_BUFFER_BIT));
 }
 
-void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const
+void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int mode) const
 {
     // Bind
     shader.Bind();
+    shader.FlushUniforms();
 
     va.Bind();
     ib.Bind();
+    CheckVertexInputs(va, shader);
 
-    CALLGL(glDrawElements(GL_TRIANGLES,
+    if (ib.HasPrimitiveRestart())
+    {
+        CALLGL(glEnable(GL_PRIMITIVE_RESTART));
+        CALLGL(glPrimitiveRestartIndex(ib.GetRestartIndex()));
+    }
+
+    CALLGL(glDrawElements(mode,
         ib.GetCount(),
-        GL_UNSIGNED_INT,
+        ib.GetType(),
         nullptr));
+
+    if (ib.HasPrimitiveRestart())
+        CALLGL(glDisable(GL_PRIMITIVE_RESTART));
+}
+
+void Renderer::DrawArrays(const VertexArray& va, const Shader& shader, unsigned int first, unsigned int count,
+    unsigned int instanceCount, unsigned int mode) const
+{
+    shader.Bind();
+    shader.FlushUniforms();
+    va.Bind();
+    CheckVertexInputs(va, shader);
+
+    if (instanceCount == 1)
+        CALLGL(glDrawArrays(mode, first, count));
+    else
+        CALLGL(glDrawArraysInstanced(mode, first, count, instanceCount));
+}
+
+void Renderer::DrawIndirect(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const StorageBuffer& commands,
+    unsigned int drawCount, unsigned int mode) const
+{
+    ASSERT_GL(HasMultiDrawIndirect());
+    shader.Bind();
+    shader.FlushUniforms();
+
+    va.Bind();
+    ib.Bind();
+    commands.Bind(GL_DRAW_INDIRECT_BUFFER);
+    CheckVertexInputs(va, shader);
+
+    if (ib.HasPrimitiveRestart())
+    {
+        CALLGL(glEnable(GL_PRIMITIVE_RESTART));
+        CALLGL(glPrimitiveRestartIndex(ib.GetRestartIndex()));
+    }
+
+    CALLGL(glMultiDrawElementsIndirect(mode, ib.GetType(), nullptr, drawCount, 0));
+
+    if (ib.HasPrimitiveRestart())
+        CALLGL(glDisable(GL_PRIMITIVE_RESTART));
+}
+
+bool Renderer::HasMultiDrawIndirect()
+{
+    return GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance);
+}
+
+void Renderer::Dispatch(const Shader& shader, unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) const
+{
+    ASSERT_GL(shader.IsCompute());
+    if (!shader.IsLinked())
+        return;
+    shader.Bind();
+    shader.FlushUniforms();
+    CALLGL(glDispatchCompute(groupsX, groupsY, groupsZ));
+}
+
+void Renderer::DispatchIndirect(const Shader& shader, const StorageBuffer& args, unsigned int offset) const
+{
+    ASSERT_GL(shader.IsCompute());
+    if (!shader.IsLinked())
+        return;
+    shader.Bind();
+    shader.FlushUniforms();
+    args.Bind(GL_DISPATCH_INDIRECT_BUFFER);
+    CALLGL(glDispatchComputeIndirect((GLintptr)offset));
+}
+
+void Renderer::Barrier(unsigned int bits) const
+{
+    CALLGL(glMemoryBarrier(bits));
 }
\ No newline at end of file
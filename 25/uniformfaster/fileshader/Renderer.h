@@ -6,6 +6,7 @@
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Shader.h"
+#include "StorageBuffer.h"
 
 #define ASSERT_GL(x) do { if(!(x)) { __debugbreak(); } } while(false)
 #define CALLGL(x) do {                                      \
@@ -19,9 +20,51 @@ std::string GetGLErrorString(GLenum error);
 bool LogGLCall(const char* funcname, const char* filename, int line);
 
 
+// one entry of the buffer glMultiDrawElementsIndirect reads, firstIndex
+// counts indices, baseInstance is where instanced streams start
+struct DrawElementsIndirectCommand
+{
+    unsigned int count;
+    unsigned int instanceCount;
+    unsigned int firstIndex;
+    int baseVertex;
+    unsigned int baseInstance;
+};
+
 class Renderer {
 public:
     void Clear() const;
-    void Draw(const VertexArray& va,const IndexBuffer& ib,const Shader& shader) const;
+    // mode is GL_TRIANGLES, GL_TRIANGLE_STRIP, ... restart only matters for strips and fans
+    void Draw(const VertexArray& va,const IndexBuffer& ib,const Shader& shader, unsigned int mode = GL_TRIANGLES) const;
+    // no index buffer, gl_VertexID runs from first to first + count - 1.
+    // vertex pulling draws this way with a vertex array without attributes
+    void DrawArrays(const VertexArray& va, const Shader& shader, unsigned int first, unsigned int count,
+        unsigned int instanceCount = 1, unsigned int mode = GL_TRIANGLES) const;
+
+    // drawCount DrawElementsIndirectCommands from commands, all from the same
+    // vertex array and index buffer, in one call. the commands may have been
+    // written by a dispatch (Barrier with GL_COMMAND_BARRIER_BIT first)
+    void DrawIndirect(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const StorageBuffer& commands,
+        unsigned int drawCount, unsigned int mode = GL_TRIANGLES) const;
+    // glMultiDrawElementsIndirect with base instances (GL 4.3)
+    static bool HasMultiDrawIndirect();
+
+    // runs a compute program (Shader::IsCompute) in groups of its work group size
+    void Dispatch(const Shader& shader, unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1) const;
+    // group counts are three uints at offset in args, written by an earlier dispatch
+    void DispatchIndirect(const Shader& shader, const StorageBuffer& args, unsigned int offset = 0) const;
+    // groups of groupSize that cover count items, the shader skips the ones past the end
+    static unsigned int GetGroupCount(unsigned int count, unsigned int groupSize) { return (count + groupSize - 1) / groupSize; }
+
+    // dispatches write memory the rest of GL doesn't see until a barrier.
+    // bits says how it is read next:
+    //   GL_SHADER_STORAGE_BARRIER_BIT      storage buffers in a later shader
+    //   GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT vertex buffers
+    //   GL_ELEMENT_ARRAY_BARRIER_BIT       index buffers
+    //   GL_COMMAND_BARRIER_BIT             indirect draw and dispatch arguments
+    //   GL_TEXTURE_FETCH_BARRIER_BIT       images sampled as textures
+    //   GL_SHADER_IMAGE_ACCESS_BARRIER_BIT images in a later shader
+    //   GL_BUFFER_UPDATE_BARRIER_BIT       reading back, StorageBuffer::Read
+    void Barrier(unsigned int bits) const;
 
 };
\ No newline at end of file
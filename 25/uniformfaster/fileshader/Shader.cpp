@@ -1,22 +1,32 @@
 
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 
 #include <GL/glew.h>
 
 #include "Renderer.h"
 
 #include "Shader.h"
+#include "ShaderPreprocessor.h"
+#include "ShaderReflection.h"
+#include "GLBackend.h"
 
+static bool s_UniformShadowing = true;
 
-
-Shader::Shader(const std::string& filepath)
-	:m_FilePath(filepath),m_RedererID(0)
+Shader::Shader(const std::string& filepath, const std::vector<std::string>& defines)
+	:m_FilePath(filepath),m_RedererID(0),m_SourceHash(0),m_Linked(false),m_Compute(false),m_WorkGroupSize(0),
+    m_ShadowBuilt(false),m_DeferUniforms(false)
 {
-    ShaderProgramSources source = ParseShader();
+    ShaderProgramSources source;
+    if (!ParseShader(defines, source))
+    {
+        // missing or unreadable, an empty program that never links, IsLinked tells
+        m_RedererID = glCreateProgram();
+        return;
+    }
     //std::cout << "VERTEX >>>>" << '\n';
     //std::cout << source.VertexSource << '\n';
     //std::cout << "<<<< VERTEX" << '\n';
@@ -25,49 +35,51 @@ Shader::Shader(const std::string& filepath)
     //std::cout << source.FragmentSource << '\n';
     //std::cout << "<<<< FRAGMENT" << '\n';
 
-    m_RedererID = CreateShader(source.VertexSource, source.FragmentSource);
+    m_SourceFiles = source.Files;
+    m_SourceHash = ShaderPreprocessor::Hash(source);
+    CreateShader(source);
+    Finish();
+}
+Shader::Shader(const std::string& name, const ShaderProgramSources& sources, bool wait)
+    :m_FilePath(name),m_RedererID(0),m_SourceFiles(sources.Files),m_SourceHash(ShaderPreprocessor::Hash(sources)),
+    m_Linked(false),m_Compute(false),m_WorkGroupSize(0),
+    m_ShadowBuilt(false),m_DeferUniforms(false)
+{
+    CreateShader(sources);
+    if (wait)
+        Finish();
 }
 Shader::~Shader()
 {
+    for (unsigned int stage : m_PendingStages)
+        CALLGL(glDeleteShader(stage));
     CALLGL(glDeleteProgram(m_RedererID));
 }
 
 
 
-ShaderProgramSources Shader::ParseShader()
+bool Shader::ParseShader(const std::vector<std::string>& defines, ShaderProgramSources& sources)
 {
-    std::ifstream stream(m_FilePath);
+    // #shader vertex / #shader fragment split, #include and defines
+    return ShaderPreprocessor::Process(m_FilePath, defines, sources);
+}
 
-    enum class ShaderType
-    {
-        NONE = -1,
-        VERTEX,
-        FRAGMENT,
-    };
+const ShaderReflection& Shader::GetReflection() const
+{
+    // a program that is still compiling makes the glGetActive* calls wait
+    if (!m_Reflection)
+        m_Reflection = std::make_unique<ShaderReflection>(m_RedererID);
+    return *m_Reflection;
+}
 
-    std::string line;
-    std::stringstream ss[2];
-    ShaderType type = ShaderType::NONE;
-    while (getline(stream, line))
-    {
-        if (line.find("#shader") != std::string::npos)
-        {
-            if (line.find("vertex") != std::string::npos)
-            {
-                type = ShaderType::VERTEX;
-            }
-            else if (line.find("fragment") != std::string::npos)
-            {
-                type = ShaderType::FRAGMENT;
-            }
-        }
-        else
-        {
-            ss[(int)type] << line << '\n';
-        }
-    }
+bool Shader::HasParallelCompile()
+{
+    return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+}
 
-    return { ss[0].str(), ss[1].str() };
+bool Shader::HasCompute()
+{
+    return GLEW_VERSION_4_3 || (GLEW_ARB_compute_shader && GLEW_ARB_shader_storage_buffer_object);
 }
 
 unsigned int Shader::CompileShader(GLenum type, const std::string& source)
@@ -79,8 +91,25 @@ unsigned int Shader::CompileShader(GLenum type, const std::string& source)
         &src,
         nullptr));
     CALLGL(glCompileShader(id));
+    // no status query here, that would wait for this compile before the next one starts
+    return id;
+}
 
-    // TODO: Error handling
+static const char* GetStageName(GLenum type)
+{
+    switch (type)
+    {
+    case GL_VERTEX_SHADER: return "vertex";
+    case GL_FRAGMENT_SHADER: return "fragment";
+    case GL_COMPUTE_SHADER: return "compute";
+    }
+    return "unknown";
+}
+
+bool Shader::CheckCompileStatus(unsigned int id)
+{
+    int type = 0;
+    CALLGL(glGetShaderiv(id, GL_SHADER_TYPE, &type));
     int result;
     CALLGL(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
     if (result != GL_TRUE)
@@ -90,33 +119,117 @@ unsigned int Shader::CompileShader(GLenum type, const std::string& source)
         std::vector<char> message;
         message.resize(length + 1);
         CALLGL(glGetShaderInfoLog(id, length, &length, &message[0]));
-        std::cerr << "Failed to compile" <<
-            (type == GL_VERTEX_SHADER ? "vertex" : "fragment") <<
-            " shader!" << '\n';
+        std::cerr << "Failed to compile " << GetStageName(type) << " shader!" << '\n';
         std::cerr << &message[0] << '\n';
+        // the second number of file(line) in the log
+        for (size_t i = 0; i < m_SourceFiles.size(); ++i)
+            std::cerr << "  " << i << ": " << m_SourceFiles[i] << '\n';
+        return false;
+    }
+    return true;
+}
 
-        CALLGL(glDeleteShader(id));
-        return 0;
+void Shader::CreateShader(const ShaderProgramSources& sources)
+{
+    // let the driver use as many threads as it likes, once
+    static bool threadsSet = false;
+    if (!threadsSet)
+    {
+        if (GLEW_KHR_parallel_shader_compile)
+            CALLGL(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+        else if (GLEW_ARB_parallel_shader_compile)
+            CALLGL(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+        threadsSet = true;
     }
-    return id;
+
+    // everything is submitted before anything is asked, so the driver
+    // can work on all stages and the link while we carry on
+    m_RedererID = glCreateProgram();
+    m_Compute = !sources.ComputeSource.empty();
+    if (m_Compute)
+    {
+        // an empty program that never links, IsLinked tells
+        if (!HasCompute())
+        {
+            std::cerr << m_FilePath << ": compute shaders need GL 4.3 or ARB_compute_shader" << std::endl;
+            return;
+        }
+        m_PendingStages.push_back(CompileShader(GL_COMPUTE_SHADER, sources.ComputeSource));
+    }
+    else
+    {
+        m_PendingStages.push_back(CompileShader(GL_VERTEX_SHADER, sources.VertexSource));
+        // nothing is rasterized while only capturing vertices
+        if (!sources.FragmentSource.empty() || sources.FeedbackVaryings.empty())
+            m_PendingStages.push_back(CompileShader(GL_FRAGMENT_SHADER, sources.FragmentSource));
+    }
+
+    for (unsigned int stage : m_PendingStages)
+        CALLGL(glAttachShader(m_RedererID, stage));
+
+    // only read at link time
+    if (!sources.FeedbackVaryings.empty())
+    {
+        std::vector<const char*> names;
+        for (const std::string& name : sources.FeedbackVaryings)
+            names.push_back(name.c_str());
+        CALLGL(glTransformFeedbackVaryings(m_RedererID, (GLsizei)names.size(), names.data(), GL_SEPARATE_ATTRIBS));
+    }
+
+    CALLGL(glLinkProgram(m_RedererID));
 }
 
-GLuint Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
+bool Shader::IsReady()
 {
-    GLuint program = glCreateProgram();
-    GLuint vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
-    GLuint fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+    if (m_PendingStages.empty())
+        return true;
+    if (!HasParallelCompile())
+        return false;
 
-    CALLGL(glAttachShader(program, vs));
-    CALLGL(glAttachShader(program, fs));
+    // GL_COMPLETION_STATUS_ARB has the same value
+    int done = GL_FALSE;
+    CALLGL(glGetProgramiv(m_RedererID, GL_COMPLETION_STATUS_KHR, &done));
+    if (!done)
+        return false;
+    Finish();
+    return true;
+}
 
-    CALLGL(glLinkProgram(program));
-    CALLGL(glValidateProgram(program));
+void Shader::Finish()
+{
+    if (m_PendingStages.empty())
+        return;
 
-    CALLGL(glDeleteShader(vs));
-    CALLGL(glDeleteShader(fs));
+    bool compiled = true;
+    for (unsigned int stage : m_PendingStages)
+        compiled = CheckCompileStatus(stage) && compiled;
 
-    return program;
+    int linked = GL_FALSE;
+    CALLGL(glGetProgramiv(m_RedererID, GL_LINK_STATUS, &linked));
+    if (compiled && linked != GL_TRUE)
+    {
+        int length;
+        CALLGL(glGetProgramiv(m_RedererID, GL_INFO_LOG_LENGTH, &length));
+        std::vector<char> message(length + 1);
+        CALLGL(glGetProgramInfoLog(m_RedererID, length, &length, &message[0]));
+        std::cerr << "Failed to link " << m_FilePath << '\n' << &message[0] << '\n';
+    }
+    m_Linked = compiled && linked == GL_TRUE;
+    if (m_Linked)
+        CALLGL(glValidateProgram(m_RedererID));
+    if (m_Linked && m_Compute)
+    {
+        int size[3];
+        CALLGL(glGetProgramiv(m_RedererID, GL_COMPUTE_WORK_GROUP_SIZE, size));
+        m_WorkGroupSize = glm::uvec3(size[0], size[1], size[2]);
+    }
+
+    for (unsigned int stage : m_PendingStages)
+    {
+        CALLGL(glDetachShader(m_RedererID, stage));
+        CALLGL(glDeleteShader(stage));
+    }
+    m_PendingStages.clear();
 }
 
 
@@ -132,15 +245,203 @@ void Shader::Unbind() const
 // set uniforms
 void Shader::SetUniform1i(const std::string& name, int value)
 {
-    CALLGL(glUniform1i(GetUniformLocation(name), value));
+    int location = GetUniformLocation(name);
+    if (StoreUniform(location, &value, sizeof(value)))
+        CALLGL(glUniform1i(location, value));
+}
+void Shader::SetUniform1f(const std::string& name, float value)
+{
+    int location = GetUniformLocation(name);
+    if (StoreUniform(location, &value, sizeof(value)))
+        CALLGL(glUniform1f(location, value));
+}
+void Shader::SetUniform2f(const std::string& name, float v0, float v1)
+{
+    int location = GetUniformLocation(name);
+    float value[] = { v0, v1 };
+    if (StoreUniform(location, value, sizeof(value)))
+        CALLGL(glUniform2f(location, v0, v1));
 }
 void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
 {
-    CALLGL(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
+    int location = GetUniformLocation(name);
+    float value[] = { v0, v1, v2, v3 };
+    if (StoreUniform(location, value, sizeof(value)))
+        CALLGL(glUniform4f(location, v0, v1, v2, v3));
 }
 void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
 {
-    CALLGL(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
+    int location = GetUniformLocation(name);
+    if (StoreUniform(location, &matrix[0][0], sizeof(matrix)))
+        CALLGL(glUniformMatrix4fv(location, 1, GL_FALSE, &matrix[0][0]));
+}
+
+void Shader::SetUniformShadowing(bool enabled)
+{
+    s_UniformShadowing = enabled;
+}
+bool Shader::IsUniformShadowing()
+{
+    return s_UniformShadowing;
+}
+
+void Shader::BuildUniformShadow()
+{
+    m_ShadowBuilt = true;
+    unsigned int offset = 0;
+    for (const ShaderUniform& uniform : GetReflection().GetUniforms())
+    {
+        if (uniform.location < 0)
+            continue;
+        // samplers, images and bools are set as ints, everything is 4 bytes a component
+        unsigned int size = 4 * ShaderReflection::GetComponentCount(uniform.type) *
+            ShaderReflection::GetLocationCount(uniform.type) * uniform.arraySize;
+        // the elements of an array have consecutive locations
+        unsigned int arraySize = std::max(uniform.arraySize, 1);
+        if (uniform.location + (int)arraySize > (int)m_SlotByLocation.size())
+            m_SlotByLocation.resize(uniform.location + arraySize, -1);
+        for (unsigned int element = 0; element < arraySize; ++element)
+            m_SlotByLocation[uniform.location + element] = (int)m_UniformSlots.size();
+        m_UniformSlots.push_back({ uniform.location, uniform.type, offset, size, arraySize, false, false });
+        offset += size;
+    }
+    m_UniformData.resize(offset);
+
+    // an array is uploaded whole, the elements nobody set have to keep
+    // what the program holds
+    for (UniformSlot& slot : m_UniformSlots)
+    {
+        if (slot.arraySize == 1)
+            continue;
+        unsigned int elementSize = slot.size / slot.arraySize;
+        unsigned int componentType = ShaderReflection::GetComponentType(slot.type);
+        for (unsigned int element = 0; element < slot.arraySize; ++element)
+        {
+            void* data = &m_UniformData[slot.offset + element * elementSize];
+            int location = slot.location + (int)element;
+            if (componentType == GL_FLOAT)
+                CALLGL(glGetUniformfv(m_RedererID, location, (float*)data));
+            else if (componentType == GL_UNSIGNED_INT)
+                CALLGL(glGetUniformuiv(m_RedererID, location, (GLuint*)data));
+            else
+                CALLGL(glGetUniformiv(m_RedererID, location, (int*)data));
+        }
+        slot.known = true;
+    }
+}
+
+bool Shader::StoreUniform(int location, const void* value, unsigned int size)
+{
+    // same as glUniform* with -1, nothing happens
+    if (location < 0)
+        return false;
+    if (!m_ShadowBuilt)
+        BuildUniformShadow();
+    int index = location < (int)m_SlotByLocation.size() ? m_SlotByLocation[location] : -1;
+    if (index < 0)
+    {
+        // not in the reflection, so nowhere to keep it. deferred it mustn't
+        // go to whatever program is bound either
+        if (m_DeferUniforms)
+            return false;
+        GLBackend::CountUniformUploads();
+        return true;
+    }
+
+    UniformSlot& slot = m_UniformSlots[index];
+    unsigned int elementSize = slot.size / slot.arraySize;
+    unsigned int elementOffset = (unsigned int)(location - slot.location) * elementSize;
+    size = std::min(size, slot.size - elementOffset);
+    unsigned char* data = &m_UniformData[slot.offset + elementOffset];
+    // shadowing off only skips the comparison, the shadow still follows
+    // the program so it is right when shadowing is turned back on
+    if (s_UniformShadowing && slot.known && std::memcmp(data, value, size) == 0)
+    {
+        GLBackend::CountSkippedUniformUploads();
+        return false;
+    }
+    std::memcpy(data, value, size);
+    slot.known = true;
+
+    if (m_DeferUniforms)
+    {
+        if (!slot.dirty)
+        {
+            slot.dirty = true;
+            m_DirtySlots.push_back(index);
+        }
+        return false;
+    }
+    // a flush would upload the same value again, unless other elements of
+    // the array are still waiting
+    if (slot.arraySize == 1)
+        slot.dirty = false;
+    GLBackend::CountUniformUploads();
+    return true;
+}
+
+void Shader::FlushUniforms() const
+{
+    for (unsigned int index : m_DirtySlots)
+    {
+        UniformSlot& slot = m_UniformSlots[index];
+        if (!slot.dirty)
+            continue;
+        UploadUniform(slot);
+        GLBackend::CountUniformUploads();
+        slot.dirty = false;
+    }
+    m_DirtySlots.clear();
+}
+
+void Shader::UploadUniform(const UniformSlot& slot) const
+{
+    // the whole array from the first element's location
+    const void* data = &m_UniformData[slot.offset];
+    const float* f = (const float*)data;
+    const int* i = (const int*)data;
+    unsigned int components = ShaderReflection::GetComponentCount(slot.type);
+    unsigned int locations = ShaderReflection::GetLocationCount(slot.type);
+    unsigned int componentType = ShaderReflection::GetComponentType(slot.type);
+
+    if (locations == 4 && components == 4)
+        CALLGL(glUniformMatrix4fv(slot.location, slot.arraySize, GL_FALSE, f));
+    else if (locations == 3 && components == 3)
+        CALLGL(glUniformMatrix3fv(slot.location, slot.arraySize, GL_FALSE, f));
+    else if (locations == 2 && components == 2)
+        CALLGL(glUniformMatrix2fv(slot.location, slot.arraySize, GL_FALSE, f));
+    else if (componentType == GL_FLOAT)
+    {
+        switch (components)
+        {
+        case 1: CALLGL(glUniform1fv(slot.location, slot.arraySize, f)); break;
+        case 2: CALLGL(glUniform2fv(slot.location, slot.arraySize, f)); break;
+        case 3: CALLGL(glUniform3fv(slot.location, slot.arraySize, f)); break;
+        case 4: CALLGL(glUniform4fv(slot.location, slot.arraySize, f)); break;
+        }
+    }
+    else if (componentType == GL_UNSIGNED_INT)
+    {
+        const GLuint* u = (const GLuint*)data;
+        switch (components)
+        {
+        case 1: CALLGL(glUniform1uiv(slot.location, slot.arraySize, u)); break;
+        case 2: CALLGL(glUniform2uiv(slot.location, slot.arraySize, u)); break;
+        case 3: CALLGL(glUniform3uiv(slot.location, slot.arraySize, u)); break;
+        case 4: CALLGL(glUniform4uiv(slot.location, slot.arraySize, u)); break;
+        }
+    }
+    else
+    {
+        // ints, bools, samplers and images
+        switch (components)
+        {
+        case 1: CALLGL(glUniform1iv(slot.location, slot.arraySize, i)); break;
+        case 2: CALLGL(glUniform2iv(slot.location, slot.arraySize, i)); break;
+        case 3: CALLGL(glUniform3iv(slot.location, slot.arraySize, i)); break;
+        case 4: CALLGL(glUniform4iv(slot.location, slot.arraySize, i)); break;
+        }
+    }
 }
 int Shader::GetUniformLocation(const std::string& name)
 {
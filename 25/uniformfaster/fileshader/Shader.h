@@ -1,40 +1,135 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include <GL/glew.h>
 #include "glm/glm.hpp"
 
 struct ShaderProgramSources
 {
 	std::string VertexSource;
 	std::string FragmentSource;
+	// a compute program has only this stage, see Renderer::Dispatch
+	std::string ComputeSource;
+	// the .shader file and everything it included, in #line numbering
+	std::vector<std::string> Files;
+	// the defines that made it into the sources
+	std::vector<std::string> Defines;
+	// vertex outputs transform feedback captures, one buffer each
+	// (GL_SEPARATE_ATTRIBS) in this order. set before creating the Shader,
+	// the fragment stage may be left out then
+	std::vector<std::string> FeedbackVaryings;
 };
 
+class ShaderReflection;
+
 class Shader
 {
 private:
 	std::string m_FilePath;
 	unsigned int m_RedererID;
+	std::vector<std::string> m_SourceFiles;
+	uint64_t m_SourceHash;
+	mutable std::unique_ptr<ShaderReflection> m_Reflection;
+
+	// the values the program holds, every uniform of the default block
+	// at its own offset in one block of memory. arrays are one slot that
+	// every element's location leads to
+	struct UniformSlot
+	{
+		int location;
+		unsigned int type;
+		unsigned int offset;
+		unsigned int size; // of the whole array
+		unsigned int arraySize; // elements take the locations after location
+		bool known; // set at least once or read back (arrays), before that the program's value is unknown
+		bool dirty; // deferred and not uploaded yet
+	};
+	std::vector<unsigned char> m_UniformData;
+	// dirty flags are cleared by FlushUniforms
+	mutable std::vector<UniformSlot> m_UniformSlots;
+	std::vector<int> m_SlotByLocation;
+	mutable std::vector<unsigned int> m_DirtySlots;
+	// stages still compiling, empty once Finish has looked at them
+	std::vector<unsigned int> m_PendingStages;
+	bool m_Linked;
+	bool m_Compute;
+	glm::uvec3 m_WorkGroupSize;
+	bool m_ShadowBuilt;
+	bool m_DeferUniforms;
 	using LocationCache = std::unordered_map<std::string, int>;
 	LocationCache m_UniformLocationCache;
 
 public:
-	Shader(const std::string& filepath);
+	// defines are names or NAME=value, see ShaderPreprocessor
+	Shader(const std::string& filepath, const std::vector<std::string>& defines = {});
+	// already preprocessed, name is only for messages. without wait the
+	// compile and link are only submitted, see IsReady
+	Shader(const std::string& name, const ShaderProgramSources& sources, bool wait = true);
 	~Shader();
 
+	// compiled and linked, never blocks. with KHR/ARB_parallel_shader_compile
+	// it asks the driver (GL_COMPLETION_STATUS_KHR), without it a program
+	// only becomes ready through Finish
+	bool IsReady();
+	// waits for the driver and reports compile and link errors
+	void Finish();
+	// ready and without errors
+	bool IsLinked() const { return m_Linked; }
+
+	// the driver compiles on its own threads, programs can be polled
+	static bool HasParallelCompile();
+
+	// made from a #shader compute stage, run with Renderer::Dispatch
+	bool IsCompute() const { return m_Compute; }
+	// layout(local_size_x = ...) of a linked compute program
+	const glm::uvec3& GetWorkGroupSize() const { return m_WorkGroupSize; }
+	// compute programs, storage buffers and image load/store (GL 4.3)
+	static bool HasCompute();
+
 	void Bind() const;
 	void Unbind() const;
 
-	// set uniforms
+	// set uniforms. values the program already holds aren't uploaded again,
+	// otherwise the program has to be bound unless uploads are deferred
 	void SetUniform1i(const std::string& name, int value);
+	void SetUniform1f(const std::string& name, float value);
+	void SetUniform2f(const std::string& name, float v0, float v1);
 	void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
 	void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
 
+	// keep changed values and upload them in FlushUniforms, which
+	// Renderer::Draw calls after binding the program
+	void SetDeferredUniforms(bool defer) { m_DeferUniforms = defer; }
+	bool HasDeferredUniforms() const { return m_DeferUniforms; }
+	// the program has to be bound
+	void FlushUniforms() const;
+
+	// off uploads every value like before, for comparing
+	static void SetUniformShadowing(bool enabled);
+	static bool IsUniformShadowing();
+
+	// active attributes, uniforms and blocks, read the first time it's asked for
+	const ShaderReflection& GetReflection() const;
+
+	unsigned int GetRendererID() const { return m_RedererID; }
+	const std::string& GetFilePath() const { return m_FilePath; }
+	// ShaderPreprocessor::Hash of what was compiled
+	uint64_t GetSourceHash() const { return m_SourceHash; }
+
 private:
-	ShaderProgramSources ParseShader();
+	bool ParseShader(const std::vector<std::string>& defines, ShaderProgramSources& sources);
 	unsigned int CompileShader(GLenum type, const std::string& source);
-	GLuint CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
+	bool CheckCompileStatus(unsigned int id);
+	void CreateShader(const ShaderProgramSources& sources);
 
 	int GetUniformLocation(const std::string& name);
+	void BuildUniformShadow();
+	// copies value into the shadow, true when it has to be uploaded right away
+	bool StoreUniform(int location, const void* value, unsigned int size);
+	void UploadUniform(const UniformSlot& slot) const;
 };
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "ShaderCompileQueue.h"
+
+#include <algorithm>
+
+ShaderCompileQueue::ShaderCompileQueue(unsigned int waitBudget) :
+	m_WaitBudget(waitBudget)
+{
+}
+
+void ShaderCompileQueue::Add(Shader& shader)
+{
+	m_Pending.push_back(&shader);
+}
+
+unsigned int ShaderCompileQueue::Update()
+{
+	size_t pending = m_Pending.size();
+	if (Shader::HasParallelCompile())
+	{
+		m_Pending.erase(std::remove_if(m_Pending.begin(), m_Pending.end(),
+			[](Shader* shader) { return shader->IsReady(); }), m_Pending.end());
+	}
+	else
+	{
+		// oldest first, they had the most time
+		size_t count = std::min<size_t>(m_WaitBudget, m_Pending.size());
+		for (size_t i = 0; i < count; ++i)
+			m_Pending[i]->Finish();
+		m_Pending.erase(m_Pending.begin(), m_Pending.begin() + count);
+	}
+	return (unsigned int)(pending - m_Pending.size());
+}
+
+void ShaderCompileQueue::FinishAll()
+{
+	for (Shader* shader : m_Pending)
+		shader->Finish();
+	m_Pending.clear();
+}
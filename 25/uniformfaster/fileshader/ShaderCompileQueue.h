@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include "Shader.h"
+
+// Finishes programs created with Shader(name, sources, false) over the next
+// frames, so startup doesn't wait for every compile and link in a row.
+// Draw with a fallback until shader.IsReady().
+//
+// With parallel shader compile Update only polls, the driver's threads do
+// the work. Without it Update waits for up to waitBudget programs a frame,
+// which spreads the stall over several frames.
+class ShaderCompileQueue
+{
+private:
+	std::vector<Shader*> m_Pending;
+	unsigned int m_WaitBudget;
+
+public:
+	ShaderCompileQueue(unsigned int waitBudget = 1);
+
+	// the queue doesn't own the shader, it has to outlive it or be finished first
+	void Add(Shader& shader);
+	// once a frame, returns how many programs became ready
+	unsigned int Update();
+	void FinishAll();
+
+	void SetWaitBudget(unsigned int programs) { m_WaitBudget = programs; }
+	unsigned int GetPendingCount() const { return (unsigned int)m_Pending.size(); }
+	bool IsIdle() const { return m_Pending.empty(); }
+};
@@ -0,0 +1,270 @@
+#include "ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#include "EmbeddedShaders.h"
+
+namespace ShaderPreprocessor
+{
+	// stands in for the defines until we know which ones are used
+	static const char* DefinesMarker = "#pragma defines\n";
+	static const int MaxIncludeDepth = 32;
+
+#ifdef _DEBUG
+	static bool s_FileOverride = true;
+#else
+	static bool s_FileOverride = false;
+#endif
+
+	void SetFileOverride(bool enabled)
+	{
+		s_FileOverride = enabled;
+	}
+
+	bool HasFileOverride()
+	{
+		return s_FileOverride;
+	}
+
+	static std::string GetDirectory(const std::string& path)
+	{
+		size_t slash = path.find_last_of("/\\");
+		return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+	}
+
+	static std::string TrimLeft(const std::string& line)
+	{
+		size_t start = line.find_first_not_of(" \t");
+		return start == std::string::npos ? std::string() : line.substr(start);
+	}
+
+	// the path of an #include "path" line, empty when it isn't one
+	static std::string GetIncludePath(const std::string& line)
+	{
+		std::string trimmed = TrimLeft(line);
+		if (trimmed.compare(0, 8, "#include") != 0)
+			return std::string();
+		size_t open = trimmed.find('"');
+		size_t close = open == std::string::npos ? open : trimmed.find('"', open + 1);
+		if (close == std::string::npos)
+			return std::string();
+		return trimmed.substr(open + 1, close - open - 1);
+	}
+
+	static int GetFileIndex(std::vector<std::string>& files, const std::string& path)
+	{
+		auto it = std::find(files.begin(), files.end(), path);
+		if (it != files.end())
+			return (int)(it - files.begin());
+		files.push_back(path);
+		return (int)files.size() - 1;
+	}
+
+	static bool AppendInclude(const std::string& path, std::ostringstream& out, std::set<std::string>& included,
+		std::vector<std::string>& files, int depth)
+	{
+		if (!included.insert(path).second)
+			return true;
+		if (depth > MaxIncludeDepth)
+		{
+			std::cerr << "Shader includes nested too deep at '" << path << "'" << std::endl;
+			return false;
+		}
+		std::ifstream stream(path);
+		if (!stream)
+		{
+			std::cerr << "Shader include '" << path << "' not found" << std::endl;
+			return false;
+		}
+
+		int fileIndex = GetFileIndex(files, path);
+		out << "#line 1 " << fileIndex << '\n';
+		std::string line;
+		int lineNumber = 0;
+		while (getline(stream, line))
+		{
+			++lineNumber;
+			std::string include = GetIncludePath(line);
+			if (include.empty())
+			{
+				out << line << '\n';
+				continue;
+			}
+			if (!AppendInclude(GetDirectory(path) + include, out, included, files, depth + 1))
+				return false;
+			out << "#line " << lineNumber + 1 << ' ' << fileIndex << '\n';
+		}
+		return true;
+	}
+
+	static bool ContainsWord(const std::string& text, const std::string& word)
+	{
+		auto isIdentifier = [](char c) { return isalnum((unsigned char)c) || c == '_'; };
+		for (size_t at = text.find(word); at != std::string::npos; at = text.find(word, at + 1))
+		{
+			size_t end = at + word.size();
+			if ((at == 0 || !isIdentifier(text[at - 1])) && (end == text.size() || !isIdentifier(text[end])))
+				return true;
+		}
+		return false;
+	}
+
+	// both stages with the defines marker, what embed_shaders.py stores
+	static bool ReadFile(const std::string& filepath, ShaderProgramSources& sources)
+	{
+		std::ifstream stream(filepath);
+		if (!stream)
+		{
+			std::cerr << "Shader '" << filepath << "' not found" << std::endl;
+			return false;
+		}
+		sources.Files.push_back(filepath);
+
+		enum class ShaderType
+		{
+			NONE = -1,
+			VERTEX,
+			FRAGMENT,
+			COMPUTE,
+		};
+
+		std::string line;
+		std::ostringstream ss[3];
+		std::set<std::string> included[3];
+		ShaderType type = ShaderType::NONE;
+		int lineNumber = 0;
+		while (getline(stream, line))
+		{
+			++lineNumber;
+			if (line.find("#shader") != std::string::npos)
+			{
+				if (line.find("vertex") != std::string::npos)
+					type = ShaderType::VERTEX;
+				else if (line.find("fragment") != std::string::npos)
+					type = ShaderType::FRAGMENT;
+				else if (line.find("compute") != std::string::npos)
+					type = ShaderType::COMPUTE;
+				continue;
+			}
+			if (type == ShaderType::NONE)
+				continue;
+
+			std::ostringstream& out = ss[(int)type];
+			std::string include = GetIncludePath(line);
+			if (!include.empty())
+			{
+				if (!AppendInclude(GetDirectory(filepath) + include, out, included[(int)type], sources.Files, 1))
+					return false;
+				out << "#line " << lineNumber + 1 << " 0\n";
+			}
+			else if (TrimLeft(line).compare(0, 8, "#version") == 0)
+			{
+				// nothing but comments may come before #version
+				out << line << '\n' << DefinesMarker << "#line " << lineNumber + 1 << " 0\n";
+			}
+			else
+			{
+				out << line << '\n';
+			}
+		}
+		sources.VertexSource = ss[0].str();
+		sources.FragmentSource = ss[1].str();
+		sources.ComputeSource = ss[2].str();
+		return true;
+	}
+
+	static void ReadEmbedded(const EmbeddedShaders::Entry& entry, ShaderProgramSources& sources)
+	{
+		sources.VertexSource = entry.VertexSource;
+		sources.FragmentSource = entry.FragmentSource;
+		sources.ComputeSource = entry.ComputeSource;
+		sources.Files.assign(entry.Files, entry.Files + entry.FileCount);
+	}
+
+	static void AddDefines(const std::vector<std::string>& defines, ShaderProgramSources& sources)
+	{
+		// a define nothing looks at would only make another copy of the same program
+		std::string defineLines;
+		for (const std::string& define : defines)
+		{
+			size_t equals = define.find('=');
+			std::string name = define.substr(0, equals);
+			if (name.empty() || (!ContainsWord(sources.VertexSource, name) && !ContainsWord(sources.FragmentSource, name) &&
+				!ContainsWord(sources.ComputeSource, name)))
+				continue;
+			defineLines += "#define " + name + ' ' + (equals == std::string::npos ? std::string("1") : define.substr(equals + 1)) + '\n';
+			sources.Defines.push_back(define);
+		}
+		for (std::string* source : { &sources.VertexSource, &sources.FragmentSource, &sources.ComputeSource })
+		{
+			size_t marker = source->find(DefinesMarker);
+			if (marker != std::string::npos)
+				source->replace(marker, strlen(DefinesMarker), defineLines);
+		}
+	}
+
+	bool Process(const std::string& filepath, const std::vector<std::string>& defines, ShaderProgramSources& sources)
+	{
+		sources = ShaderProgramSources();
+		const EmbeddedShaders::Entry* embedded = EmbeddedShaders::Find(filepath);
+		if (embedded && !(s_FileOverride && std::ifstream(filepath)))
+			ReadEmbedded(*embedded, sources);
+		else if (!ReadFile(filepath, sources))
+			return false;
+		AddDefines(defines, sources);
+		return true;
+	}
+
+	bool ProcessFile(const std::string& filepath, const std::vector<std::string>& defines, ShaderProgramSources& sources)
+	{
+		sources = ShaderProgramSources();
+		if (!ReadFile(filepath, sources))
+			return false;
+		AddDefines(defines, sources);
+		return true;
+	}
+
+	std::vector<std::string> ParseDefines(const std::string& flags)
+	{
+		std::vector<std::string> defines;
+		std::istringstream stream(flags);
+		std::string define;
+		while (getline(stream, define, '|'))
+		{
+			size_t start = define.find_first_not_of(" \t");
+			size_t end = define.find_last_not_of(" \t");
+			if (start != std::string::npos)
+				defines.push_back(define.substr(start, end - start + 1));
+		}
+		std::sort(defines.begin(), defines.end());
+		defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+		return defines;
+	}
+
+	uint64_t Hash(const ShaderProgramSources& sources)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		auto add = [&hash](const std::string& text) {
+			for (char c : text)
+			{
+				hash ^= (unsigned char)c;
+				hash *= 1099511628211ull;
+			}
+			// stage separator, so text can't move between stages unnoticed
+			hash ^= 0xFF;
+			hash *= 1099511628211ull;
+		};
+		add(sources.VertexSource);
+		add(sources.FragmentSource);
+		// only when there is one, graphics programs keep the hashes they had
+		if (!sources.ComputeSource.empty())
+			add(sources.ComputeSource);
+		return hash;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Shader.h"
+
+// Turns a .shader file into the sources that get compiled:
+//
+//   - splits it on #shader vertex / #shader fragment / #shader compute
+//   - replaces #include "path" lines (relative to the including file) with
+//     the file's contents. a file is included once per stage, like #pragma once
+//   - adds #define lines right after #version, one per define the sources
+//     actually mention. "LIGHTS=4" becomes #define LIGHTS 4
+//
+// #line directives keep compile errors pointing at the right line, the
+// second number is the index into ShaderProgramSources::Files.
+//
+// Shaders in EmbeddedShaders come out of the executable already split and
+// included, only the defines are added. The files are read for paths that
+// weren't embedded, or first of all with the file override on.
+namespace ShaderPreprocessor
+{
+	// false (and a message on std::cerr) when a file can't be read
+	bool Process(const std::string& filepath, const std::vector<std::string>& defines, ShaderProgramSources& sources);
+	// the file only, never the embedded copy, false when it isn't there
+	bool ProcessFile(const std::string& filepath, const std::vector<std::string>& defines, ShaderProgramSources& sources);
+
+	// read res/shaders instead of the embedded copies where the file is there,
+	// edits show up without a rebuild. on in debug builds
+	void SetFileOverride(bool enabled);
+	bool HasFileOverride();
+
+	// "TEXTURED|VERTEX_COLOR" -> sorted, without duplicates or empty names
+	std::vector<std::string> ParseDefines(const std::string& flags);
+
+	// FNV-1a of both stages, identical programs hash the same
+	uint64_t Hash(const ShaderProgramSources& sources);
+}
@@ -0,0 +1,314 @@
+#include "ShaderReflection.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "VertexBufferLayout.h"
+
+ShaderReflection::ShaderReflection(unsigned int program)
+{
+	int count = 0;
+	int maxLength = 0;
+	std::vector<char> name;
+
+	CALLGL(glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count));
+	CALLGL(glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength));
+	name.resize(maxLength + 1);
+	for (int i = 0; i < count; ++i)
+	{
+		int length = 0, size = 0;
+		GLenum type = 0;
+		CALLGL(glGetActiveAttrib(program, i, (int)name.size(), &length, &size, &type, name.data()));
+		std::string attribute(name.data(), length);
+		// gl_VertexID and friends aren't fed by the vertex array
+		if (attribute.compare(0, 3, "gl_") == 0)
+			continue;
+		m_Attributes.push_back({ attribute, glGetAttribLocation(program, attribute.c_str()), type, size });
+	}
+	std::sort(m_Attributes.begin(), m_Attributes.end(),
+		[](const ShaderAttribute& a, const ShaderAttribute& b) { return a.location < b.location; });
+
+	CALLGL(glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count));
+	CALLGL(glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength));
+	name.resize(std::max<size_t>(name.size(), maxLength + 1));
+	for (int i = 0; i < count; ++i)
+	{
+		int length = 0, binding = 0, size = 0;
+		CALLGL(glGetActiveUniformBlockName(program, i, (int)name.size(), &length, name.data()));
+		CALLGL(glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_BINDING, &binding));
+		CALLGL(glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_DATA_SIZE, &size));
+		m_UniformBlocks.push_back({ std::string(name.data(), length), (unsigned int)i, binding, size });
+	}
+
+	CALLGL(glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count));
+	CALLGL(glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+	name.resize(std::max<size_t>(name.size(), maxLength + 1));
+	for (int i = 0; i < count; ++i)
+	{
+		int length = 0, size = 0;
+		GLenum type = 0;
+		CALLGL(glGetActiveUniform(program, i, (int)name.size(), &length, &size, &type, name.data()));
+		GLuint index = i;
+		int block = -1, offset = -1;
+		CALLGL(glGetActiveUniformsiv(program, 1, &index, GL_UNIFORM_BLOCK_INDEX, &block));
+		CALLGL(glGetActiveUniformsiv(program, 1, &index, GL_UNIFORM_OFFSET, &offset));
+		std::string uniform(name.data(), length);
+		int location = block == -1 ? glGetUniformLocation(program, uniform.c_str()) : -1;
+		m_Uniforms.push_back({ uniform, location, type, size, block, offset });
+	}
+}
+
+std::vector<ShaderUniform> ShaderReflection::GetSamplers() const
+{
+	std::vector<ShaderUniform> samplers;
+	for (const ShaderUniform& uniform : m_Uniforms)
+	{
+		if (IsSampler(uniform.type))
+			samplers.push_back(uniform);
+	}
+	return samplers;
+}
+
+const ShaderAttribute* ShaderReflection::FindAttribute(const std::string& name) const
+{
+	for (const ShaderAttribute& attribute : m_Attributes)
+	{
+		if (attribute.name == name)
+			return &attribute;
+	}
+	return nullptr;
+}
+
+const ShaderAttribute* ShaderReflection::FindAttribute(int location) const
+{
+	for (const ShaderAttribute& attribute : m_Attributes)
+	{
+		int locations = (int)(GetLocationCount(attribute.type) * attribute.arraySize);
+		if (location >= attribute.location && location < attribute.location + locations)
+			return &attribute;
+	}
+	return nullptr;
+}
+
+const ShaderUniform* ShaderReflection::FindUniform(const std::string& name) const
+{
+	for (const ShaderUniform& uniform : m_Uniforms)
+	{
+		if (uniform.name == name)
+			return &uniform;
+	}
+	return nullptr;
+}
+
+const ShaderUniformBlock* ShaderReflection::FindUniformBlock(const std::string& name) const
+{
+	for (const ShaderUniformBlock& block : m_UniformBlocks)
+	{
+		if (block.name == name)
+			return &block;
+	}
+	return nullptr;
+}
+
+bool ShaderReflection::MakeVertexLayout(VertexBufferLayout& layout) const
+{
+	int next = 0;
+	for (const ShaderAttribute& attribute : m_Attributes)
+	{
+		if (attribute.location != next)
+		{
+			std::cerr << "Can't make a vertex layout, nothing reads location " << next << std::endl;
+			return false;
+		}
+		unsigned int components = GetComponentCount(attribute.type);
+		unsigned int locations = GetLocationCount(attribute.type) * attribute.arraySize;
+		for (unsigned int i = 0; i < locations; ++i)
+		{
+			switch (GetComponentType(attribute.type))
+			{
+			case GL_FLOAT: layout.Push<float>(components); break;
+			case GL_INT: layout.PushInteger<int>(components); break;
+			case GL_UNSIGNED_INT: layout.PushInteger<unsigned int>(components); break;
+			default:
+				std::cerr << "Can't make a vertex layout for " << GetTypeName(attribute.type) << " " << attribute.name << std::endl;
+				return false;
+			}
+		}
+		next += locations;
+	}
+	return true;
+}
+
+std::vector<std::string> ShaderReflection::CheckVertexArray(const VertexArray& va) const
+{
+	std::vector<std::string> problems;
+	unsigned int end = va.GetAttribCount();
+	for (const ShaderAttribute& attribute : m_Attributes)
+		end = std::max(end, attribute.location + GetLocationCount(attribute.type) * attribute.arraySize);
+
+	for (unsigned int location = 0; location < end; ++location)
+	{
+		const VertexBufferElement* element = va.GetAttribute(location);
+		const ShaderAttribute* attribute = FindAttribute((int)location);
+		std::ostringstream problem;
+		problem << "location " << location << ": ";
+		if (!attribute && element)
+		{
+			problem << "fetched from the vertex array, but the shader doesn't read it";
+		}
+		else if (attribute && !element)
+		{
+			problem << GetTypeName(attribute->type) << " " << attribute->name << " isn't in the vertex array, it reads the constant generic value";
+		}
+		else if (attribute && element)
+		{
+			bool integerInput = GetComponentType(attribute->type) != GL_FLOAT && GetComponentType(attribute->type) != GL_DOUBLE;
+			unsigned int components = GetComponentCount(attribute->type);
+			if (integerInput != (bool)element->integer)
+				problem << GetTypeName(attribute->type) << " " << attribute->name << " is fed " << (element->integer ? "integer" : "float")
+					<< " data, the values come out undefined";
+			else if (element->count > components)
+				problem << GetTypeName(attribute->type) << " " << attribute->name << " fetches " << element->count
+					<< " components and uses " << components;
+			else
+				continue;
+		}
+		else
+		{
+			continue;
+		}
+		problems.push_back(problem.str());
+	}
+	return problems;
+}
+
+unsigned int ShaderReflection::GetComponentCount(unsigned int type)
+{
+	switch (type)
+	{
+	case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL: case GL_DOUBLE:
+		return 1;
+	case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2: case GL_DOUBLE_VEC2:
+	case GL_FLOAT_MAT2: case GL_FLOAT_MAT3x2: case GL_FLOAT_MAT4x2:
+		return 2;
+	case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3: case GL_DOUBLE_VEC3:
+	case GL_FLOAT_MAT3: case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT4x3:
+		return 3;
+	case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: case GL_DOUBLE_VEC4:
+	case GL_FLOAT_MAT4: case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT3x4:
+		return 4;
+	}
+	return 1;
+}
+
+unsigned int ShaderReflection::GetLocationCount(unsigned int type)
+{
+	switch (type)
+	{
+	case GL_FLOAT_MAT2: case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT2x4:
+		return 2;
+	case GL_FLOAT_MAT3: case GL_FLOAT_MAT3x2: case GL_FLOAT_MAT3x4:
+		return 3;
+	case GL_FLOAT_MAT4: case GL_FLOAT_MAT4x2: case GL_FLOAT_MAT4x3:
+		return 4;
+	}
+	return 1;
+}
+
+unsigned int ShaderReflection::GetComponentType(unsigned int type)
+{
+	switch (type)
+	{
+	case GL_INT: case GL_INT_VEC2: case GL_INT_VEC3: case GL_INT_VEC4:
+		return GL_INT;
+	case GL_UNSIGNED_INT: case GL_UNSIGNED_INT_VEC2: case GL_UNSIGNED_INT_VEC3: case GL_UNSIGNED_INT_VEC4:
+		return GL_UNSIGNED_INT;
+	case GL_BOOL: case GL_BOOL_VEC2: case GL_BOOL_VEC3: case GL_BOOL_VEC4:
+		return GL_BOOL;
+	case GL_DOUBLE: case GL_DOUBLE_VEC2: case GL_DOUBLE_VEC3: case GL_DOUBLE_VEC4:
+		return GL_DOUBLE;
+	}
+	// samplers and images are set like ints, but they aren't vertex inputs
+	return IsSampler(type) || IsImage(type) ? GL_INT : GL_FLOAT;
+}
+
+bool ShaderReflection::IsSampler(unsigned int type)
+{
+	switch (type)
+	{
+	case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+	case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_CUBE_SHADOW:
+	case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_1D_ARRAY_SHADOW: case GL_SAMPLER_2D_ARRAY_SHADOW:
+	case GL_SAMPLER_2D_RECT: case GL_SAMPLER_2D_RECT_SHADOW: case GL_SAMPLER_BUFFER:
+	case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+	case GL_SAMPLER_CUBE_MAP_ARRAY: case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+	case GL_INT_SAMPLER_1D: case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE:
+	case GL_INT_SAMPLER_1D_ARRAY: case GL_INT_SAMPLER_2D_ARRAY: case GL_INT_SAMPLER_2D_RECT: case GL_INT_SAMPLER_BUFFER:
+	case GL_INT_SAMPLER_2D_MULTISAMPLE: case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+	case GL_UNSIGNED_INT_SAMPLER_1D: case GL_UNSIGNED_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_3D: case GL_UNSIGNED_INT_SAMPLER_CUBE:
+	case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+	case GL_UNSIGNED_INT_SAMPLER_BUFFER: case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+	case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+		return true;
+	}
+	return false;
+}
+
+bool ShaderReflection::IsImage(unsigned int type)
+{
+	switch (type)
+	{
+	case GL_IMAGE_1D: case GL_IMAGE_2D: case GL_IMAGE_3D: case GL_IMAGE_2D_RECT: case GL_IMAGE_CUBE:
+	case GL_IMAGE_BUFFER: case GL_IMAGE_1D_ARRAY: case GL_IMAGE_2D_ARRAY: case GL_IMAGE_CUBE_MAP_ARRAY:
+	case GL_IMAGE_2D_MULTISAMPLE: case GL_IMAGE_2D_MULTISAMPLE_ARRAY:
+	case GL_INT_IMAGE_1D: case GL_INT_IMAGE_2D: case GL_INT_IMAGE_3D: case GL_INT_IMAGE_2D_RECT: case GL_INT_IMAGE_CUBE:
+	case GL_INT_IMAGE_BUFFER: case GL_INT_IMAGE_1D_ARRAY: case GL_INT_IMAGE_2D_ARRAY: case GL_INT_IMAGE_CUBE_MAP_ARRAY:
+	case GL_INT_IMAGE_2D_MULTISAMPLE: case GL_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+	case GL_UNSIGNED_INT_IMAGE_1D: case GL_UNSIGNED_INT_IMAGE_2D: case GL_UNSIGNED_INT_IMAGE_3D:
+	case GL_UNSIGNED_INT_IMAGE_2D_RECT: case GL_UNSIGNED_INT_IMAGE_CUBE: case GL_UNSIGNED_INT_IMAGE_BUFFER:
+	case GL_UNSIGNED_INT_IMAGE_1D_ARRAY: case GL_UNSIGNED_INT_IMAGE_2D_ARRAY: case GL_UNSIGNED_INT_IMAGE_CUBE_MAP_ARRAY:
+	case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE: case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+		return true;
+	}
+	return false;
+}
+
+const char* ShaderReflection::GetTypeName(unsigned int type)
+{
+	switch (type)
+	{
+	case GL_FLOAT: return "float";
+	case GL_FLOAT_VEC2: return "vec2";
+	case GL_FLOAT_VEC3: return "vec3";
+	case GL_FLOAT_VEC4: return "vec4";
+	case GL_INT: return "int";
+	case GL_INT_VEC2: return "ivec2";
+	case GL_INT_VEC3: return "ivec3";
+	case GL_INT_VEC4: return "ivec4";
+	case GL_UNSIGNED_INT: return "uint";
+	case GL_UNSIGNED_INT_VEC2: return "uvec2";
+	case GL_UNSIGNED_INT_VEC3: return "uvec3";
+	case GL_UNSIGNED_INT_VEC4: return "uvec4";
+	case GL_BOOL: return "bool";
+	case GL_FLOAT_MAT2: return "mat2";
+	case GL_FLOAT_MAT3: return "mat3";
+	case GL_FLOAT_MAT4: return "mat4";
+	case GL_DOUBLE: return "double";
+	case GL_SAMPLER_2D: return "sampler2D";
+	case GL_SAMPLER_2D_ARRAY: return "sampler2DArray";
+	case GL_SAMPLER_3D: return "sampler3D";
+	case GL_SAMPLER_CUBE: return "samplerCube";
+	case GL_SAMPLER_BUFFER: return "samplerBuffer";
+	case GL_SAMPLER_2D_SHADOW: return "sampler2DShadow";
+	case GL_INT_SAMPLER_2D: return "isampler2D";
+	case GL_UNSIGNED_INT_SAMPLER_2D: return "usampler2D";
+	case GL_UNSIGNED_INT_SAMPLER_BUFFER: return "usamplerBuffer";
+	case GL_IMAGE_2D: return "image2D";
+	case GL_INT_IMAGE_2D: return "iimage2D";
+	case GL_UNSIGNED_INT_IMAGE_2D: return "uimage2D";
+	}
+	return "?";
+}
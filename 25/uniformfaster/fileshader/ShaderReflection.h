@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class VertexArray;
+class VertexBufferLayout;
+
+struct ShaderAttribute
+{
+	std::string name;
+	int location;
+	unsigned int type; // GL_FLOAT_VEC3, GL_INT, GL_FLOAT_MAT4, ...
+	int arraySize;
+};
+
+struct ShaderUniform
+{
+	std::string name;
+	int location; // -1 inside a uniform block
+	unsigned int type;
+	int arraySize;
+	int block; // index into the uniform blocks, -1 for the default block
+	int offset; // bytes into the block
+};
+
+struct ShaderUniformBlock
+{
+	std::string name;
+	unsigned int index;
+	int binding;
+	int size; // bytes
+};
+
+// What a linked program actually uses, read once with glGetActive*.
+// Inputs the compiler optimized away aren't listed.
+class ShaderReflection
+{
+private:
+	std::vector<ShaderAttribute> m_Attributes; // by location
+	std::vector<ShaderUniform> m_Uniforms;
+	std::vector<ShaderUniformBlock> m_UniformBlocks;
+
+public:
+	explicit ShaderReflection(unsigned int program);
+
+	const std::vector<ShaderAttribute>& GetAttributes() const { return m_Attributes; }
+	const std::vector<ShaderUniform>& GetUniforms() const { return m_Uniforms; }
+	const std::vector<ShaderUniformBlock>& GetUniformBlocks() const { return m_UniformBlocks; }
+	// the sampler uniforms
+	std::vector<ShaderUniform> GetSamplers() const;
+
+	// null when the program doesn't use it
+	const ShaderAttribute* FindAttribute(const std::string& name) const;
+	const ShaderUniform* FindUniform(const std::string& name) const;
+	const ShaderUniformBlock* FindUniformBlock(const std::string& name) const;
+	// the attribute reading location, matrices cover several
+	const ShaderAttribute* FindAttribute(int location) const;
+
+	// one interleaved buffer with every input at full precision, float
+	// inputs as GL_FLOAT and int ones as GL_INT/GL_UNSIGNED_INT. false when
+	// the locations don't start at 0 or have gaps
+	bool MakeVertexLayout(VertexBufferLayout& layout) const;
+
+	// what doesn't fit between the arrays's attributes and the inputs:
+	// float data for an int input (or the other way round), attributes
+	// fetched but never read, inputs left on their constant value and
+	// components fetched only to be dropped. empty when they match
+	std::vector<std::string> CheckVertexArray(const VertexArray& va) const;
+
+	// components per location, 3 for vec3 and for every column of a mat3
+	static unsigned int GetComponentCount(unsigned int type);
+	// locations taken by one element, the columns of a matrix
+	static unsigned int GetLocationCount(unsigned int type);
+	// GL_FLOAT, GL_INT, GL_UNSIGNED_INT, GL_BOOL or GL_DOUBLE
+	static unsigned int GetComponentType(unsigned int type);
+	static bool IsSampler(unsigned int type);
+	// image2D and friends of image load/store
+	static bool IsImage(unsigned int type);
+	static const char* GetTypeName(unsigned int type);
+};
@@ -0,0 +1,80 @@
+#include "ShaderVariantCache.h"
+
+#include <chrono>
+
+#include "ShaderPreprocessor.h"
+
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+ShaderVariantCache::ShaderVariantCache() :
+	m_Requests(0),
+	m_Deduplicated(0),
+	m_PreprocessMs(0.0),
+	m_CompileMs(0.0)
+{
+}
+ShaderVariantCache::~ShaderVariantCache()
+{
+}
+
+ShaderVariantCache& ShaderVariantCache::Get()
+{
+	static ShaderVariantCache cache;
+	return cache;
+}
+
+std::string ShaderVariantCache::MakeKey(const std::string& filepath, const std::vector<std::string>& defines)
+{
+	std::string key = filepath;
+	for (const std::string& define : defines)
+		key += '|' + define;
+	return key;
+}
+
+Shader* ShaderVariantCache::GetVariant(const std::string& filepath, const std::string& features)
+{
+	++m_Requests;
+	std::vector<std::string> defines = ShaderPreprocessor::ParseDefines(features);
+	std::string key = MakeKey(filepath, defines);
+
+	auto variant = m_Variants.find(key);
+	if (variant != m_Variants.end())
+		return variant->second;
+
+	Clock::time_point start = Clock::now();
+	ShaderProgramSources sources;
+	if (!ShaderPreprocessor::Process(filepath, defines, sources))
+	{
+		m_PreprocessMs += Milliseconds(Clock::now() - start).count();
+		return nullptr;
+	}
+	uint64_t hash = ShaderPreprocessor::Hash(sources);
+	m_PreprocessMs += Milliseconds(Clock::now() - start).count();
+
+	std::unique_ptr<Shader>& program = m_Programs[hash];
+	if (program)
+	{
+		++m_Deduplicated;
+	}
+	else
+	{
+		start = Clock::now();
+		program = std::make_unique<Shader>(key, sources);
+		m_CompileMs += Milliseconds(Clock::now() - start).count();
+	}
+	m_Variants[key] = program.get();
+	return program.get();
+}
+
+Shader* ShaderVariantCache::FindVariant(const std::string& filepath, const std::string& features) const
+{
+	auto variant = m_Variants.find(MakeKey(filepath, ShaderPreprocessor::ParseDefines(features)));
+	return variant != m_Variants.end() ? variant->second : nullptr;
+}
+
+void ShaderVariantCache::Clear()
+{
+	m_Variants.clear();
+	m_Programs.clear();
+}
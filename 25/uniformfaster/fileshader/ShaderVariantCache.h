@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Shader.h"
+
+// Compiles permutations of a .shader file on first use and hands out the
+// same program afterwards. Features are | separated defines:
+//
+//   Shader* shader = ShaderVariantCache::Get().GetVariant("res/shaders/Material.shader", "TEXTURED|VERTEX_COLOR");
+//
+// The order of the features doesn't matter, and two requests whose
+// preprocessed sources come out identical (say a feature the shader never
+// checks) share one program through the source hash.
+class ShaderVariantCache
+{
+private:
+	// file + sorted features -> program
+	std::unordered_map<std::string, Shader*> m_Variants;
+	static std::string MakeKey(const std::string& filepath, const std::vector<std::string>& defines);
+	// ShaderPreprocessor::Hash -> program
+	std::unordered_map<uint64_t, std::unique_ptr<Shader>> m_Programs;
+
+	unsigned int m_Requests;
+	unsigned int m_Deduplicated;
+	double m_PreprocessMs;
+	double m_CompileMs;
+
+public:
+	ShaderVariantCache();
+	~ShaderVariantCache();
+
+	static ShaderVariantCache& Get();
+
+	// null when the file can't be read, nothing is cached then so a later
+	// request tries again
+	Shader* GetVariant(const std::string& filepath, const std::string& features = "");
+	// null when that variant wasn't requested yet, doesn't compile or count
+	Shader* FindVariant(const std::string& filepath, const std::string& features = "") const;
+
+	// deletes every program, call before the context goes away
+	void Clear();
+
+	unsigned int GetRequestCount() const { return m_Requests; }
+	unsigned int GetVariantCount() const { return (unsigned int)m_Variants.size(); }
+	unsigned int GetProgramCount() const { return (unsigned int)m_Programs.size(); }
+	// new feature sets that ended up with an existing program
+	unsigned int GetDeduplicatedCount() const { return m_Deduplicated; }
+	double GetPreprocessMs() const { return m_PreprocessMs; }
+	double GetCompileMs() const { return m_CompileMs; }
+};
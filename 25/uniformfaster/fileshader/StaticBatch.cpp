@@ -0,0 +1,159 @@
+#include "StaticBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <set>
+#include <tuple>
+
+#include "Shader.h"
+#include "Texture.h"
+#include "Frustum.h"
+
+// stays within 16 bit indices
+static const unsigned int MaxBatchVertices = 0xFFFF;
+
+StaticBatch::StaticBatch() :
+	m_Stats{}
+{
+}
+
+StaticBatch::~StaticBatch()
+{
+}
+
+void StaticBatch::Add(const Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount,
+	const glm::mat4& model, Shader& shader, const Texture* texture)
+{
+	unsigned int material = 0;
+	while (material < m_Materials.size() && (m_Materials[material].shader != &shader || m_Materials[material].texture != texture))
+		++material;
+	if (material == m_Materials.size())
+		m_Materials.push_back({ &shader, texture });
+
+	m_Objects.push_back({ vertices, vertexCount, indices, indexCount, model, material });
+}
+
+void StaticBatch::Build(float chunkSize)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	// material first so the draw order groups state changes, then the cell
+	// the object's center falls into
+	using Key = std::tuple<unsigned int, int, int, int>;
+	std::map<Key, std::vector<unsigned int>> chunks;
+	std::set<const Vertex*> sourceMeshes;
+	for (unsigned int i = 0; i < m_Objects.size(); ++i)
+	{
+		const Object& object = m_Objects[i];
+		glm::vec3 center = glm::vec3(object.model[3]);
+		if (object.vertexCount > 0)
+		{
+			glm::vec3 min(object.vertices[0].position), max(min);
+			for (unsigned int v = 1; v < object.vertexCount; ++v)
+			{
+				min = glm::min(min, object.vertices[v].position);
+				max = glm::max(max, object.vertices[v].position);
+			}
+			center = glm::vec3(object.model * glm::vec4((min + max) * 0.5f, 1.0f));
+		}
+		glm::ivec3 cell = glm::ivec3(glm::floor(center / chunkSize));
+		chunks[Key(object.material, cell.x, cell.y, cell.z)].push_back(i);
+
+		if (sourceMeshes.insert(object.vertices).second)
+			m_Stats.sourceBytes += object.vertexCount * sizeof(Vertex) + object.indexCount * sizeof(unsigned int);
+	}
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	for (const auto& chunk : chunks)
+	{
+		unsigned int material = std::get<0>(chunk.first);
+		const std::vector<unsigned int>& objects = chunk.second;
+		size_t next = 0;
+		while (next < objects.size())
+		{
+			vertices.clear();
+			indices.clear();
+			for (; next < objects.size(); ++next)
+			{
+				const Object& object = m_Objects[objects[next]];
+				// an object bigger than a batch still gets one of its own
+				if (!vertices.empty() && vertices.size() + object.vertexCount > MaxBatchVertices)
+					break;
+
+				glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(object.model)));
+				unsigned int base = (unsigned int)vertices.size();
+				for (unsigned int v = 0; v < object.vertexCount; ++v)
+				{
+					Vertex vertex = object.vertices[v];
+					vertex.position = glm::vec3(object.model * glm::vec4(vertex.position, 1.0f));
+					vertex.normal = glm::normalize(normalMatrix * vertex.normal);
+					vertices.push_back(vertex);
+				}
+				// mirrored transforms turn the winding around
+				bool flip = glm::determinant(glm::mat3(object.model)) < 0.0f;
+				for (unsigned int j = 0; j + 2 < object.indexCount; j += 3)
+				{
+					indices.push_back(base + object.indices[j]);
+					indices.push_back(base + object.indices[j + (flip ? 2 : 1)]);
+					indices.push_back(base + object.indices[j + (flip ? 1 : 2)]);
+				}
+			}
+			if (indices.empty())
+				continue;
+
+			Batch batch;
+			batch.material = material;
+			batch.min = batch.max = vertices[0].position;
+			for (const Vertex& vertex : vertices)
+			{
+				batch.min = glm::min(batch.min, vertex.position);
+				batch.max = glm::max(batch.max, vertex.position);
+			}
+			batch.vertexBuffer = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(Vertex)));
+			batch.indexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+			batch.vao = std::make_unique<VertexArray>();
+			batch.vao->AddBuffer<Vertex>(*batch.vertexBuffer);
+			m_Stats.batchBytes += batch.vertexBuffer->GetSize() + batch.indexBuffer->GetSizeInBytes();
+			m_Batches.push_back(std::move(batch));
+		}
+	}
+
+	m_Stats.objectCount += (unsigned int)m_Objects.size();
+	m_Stats.batchCount = (unsigned int)m_Batches.size();
+	m_Stats.buildMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	// the source meshes may go away now
+	m_Objects.clear();
+	m_Objects.shrink_to_fit();
+}
+
+unsigned int StaticBatch::Draw(const Renderer& renderer, const glm::mat4& viewProjection, const Frustum* frustum) const
+{
+	unsigned int draws = 0;
+	unsigned int boundMaterial = (unsigned int)-1;
+	for (const Batch& batch : m_Batches)
+	{
+		if (frustum && !frustum->IsBoxVisible(batch.min, batch.max))
+			continue;
+
+		Shader& shader = *m_Materials[batch.material].shader;
+		if (batch.material != boundMaterial)
+		{
+			const Texture* texture = m_Materials[batch.material].texture;
+			shader.Bind();
+			// vertices are already in world space
+			shader.SetUniformMat4f("u_MVP", viewProjection);
+			if (texture)
+			{
+				texture->Bind(0);
+				shader.SetUniform1i("u_Texture", 0);
+			}
+			boundMaterial = batch.material;
+		}
+		renderer.Draw(*batch.vao, *batch.indexBuffer, shader);
+		++draws;
+	}
+	return draws;
+}
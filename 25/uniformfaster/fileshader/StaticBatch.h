@@ -0,0 +1,108 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "IndexBuffer.h"
+
+class Texture;
+struct Frustum;
+
+// Static scenery merged at load time. Objects that share a shader and a
+// texture and sit in the same chunkSize cell of the world are transformed
+// on the CPU and appended to one vertex and index buffer, so a whole chunk
+// of them is one draw with one u_MVP upload instead of a draw per object.
+//
+// Chunks keep their world bounds so they can still be frustum culled, and
+// a chunk is cut into more batches once it passes 65535 vertices so the
+// index buffers stay 16 bit.
+//
+//   StaticBatch batch;
+//   batch.Add(vertices, vertexCount, indices, indexCount, model, shader, &texture);
+//   ...
+//   batch.Build(32.0f);
+//   batch.Draw(renderer, viewProj, &frustum);
+class StaticBatch
+{
+public:
+	struct Vertex
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 texCoord;
+		glm::u8vec4 color;
+	};
+
+	struct Stats
+	{
+		unsigned int objectCount;
+		unsigned int batchCount;
+		// bytes of the distinct meshes passed to Add, what drawing the objects
+		// one by one needs, against the bytes of the merged buffers
+		size_t sourceBytes;
+		size_t batchBytes;
+		double buildMs;
+	};
+
+private:
+	struct Object
+	{
+		const Vertex* vertices;
+		unsigned int vertexCount;
+		const unsigned int* indices;
+		unsigned int indexCount;
+		glm::mat4 model;
+		unsigned int material;
+	};
+
+	struct Material
+	{
+		Shader* shader;
+		const Texture* texture;
+	};
+
+	struct Batch
+	{
+		std::unique_ptr<VertexBuffer> vertexBuffer;
+		std::unique_ptr<IndexBuffer> indexBuffer;
+		std::unique_ptr<VertexArray> vao;
+		unsigned int material;
+		glm::vec3 min, max;
+	};
+
+	std::vector<Object> m_Objects;
+	std::vector<Material> m_Materials;
+	std::vector<Batch> m_Batches;
+	Stats m_Stats;
+
+public:
+	StaticBatch();
+	~StaticBatch();
+
+	// vertices and indices are only read by Build, they have to stay alive
+	// until then. texture may be null, otherwise it's bound to slot 0
+	void Add(const Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount,
+		const glm::mat4& model, Shader& shader, const Texture* texture = nullptr);
+
+	// merges everything added so far, batches are sorted by material so
+	// drawing them in order binds every shader and texture once
+	void Build(float chunkSize);
+
+	// returns the number of draw calls
+	unsigned int Draw(const Renderer& renderer, const glm::mat4& viewProjection, const Frustum* frustum = nullptr) const;
+
+	unsigned int GetBatchCount() const { return (unsigned int)m_Batches.size(); }
+	const Stats& GetStats() const { return m_Stats; }
+};
+
+VERTEX_LAYOUT(StaticBatch::Vertex,
+	VERTEX_ATTRIB(position),
+	VERTEX_ATTRIB(normal),
+	VERTEX_ATTRIB(texCoord),
+	VERTEX_ATTRIB(color));
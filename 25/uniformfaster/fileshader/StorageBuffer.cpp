@@ -0,0 +1,80 @@
+#include "Renderer.h"
+#include "StorageBuffer.h"
+#include "GLBackend.h"
+
+StorageBuffer::StorageBuffer(const void* data, unsigned int size, unsigned int usage, unsigned int target) :
+	m_RenderID(0),
+	m_Size(size),
+	m_Usage(usage),
+	m_Target(target)
+{
+	if (GLBackend::UseDSA())
+	{
+		CALLGL(glCreateBuffers(1, &m_RenderID));
+		CALLGL(glNamedBufferData(m_RenderID, size, data, usage));
+		GLBackend::CountSavedBinds();
+		return;
+	}
+
+	CALLGL(glGenBuffers(1, &m_RenderID));
+	Bind(m_Target);
+	CALLGL(glBufferData(m_Target, size, data, usage));
+}
+StorageBuffer::~StorageBuffer()
+{
+	CALLGL(glDeleteBuffers(1, &m_RenderID));
+}
+
+void StorageBuffer::Update(const void* data, unsigned int size, unsigned int offset)
+{
+	ASSERT_GL(offset + size <= m_Size);
+	if (GLBackend::UseDSA())
+	{
+		CALLGL(glNamedBufferSubData(m_RenderID, offset, size, data));
+		GLBackend::CountSavedBinds();
+		return;
+	}
+	Bind(m_Target);
+	CALLGL(glBufferSubData(m_Target, offset, size, data));
+}
+
+void StorageBuffer::Clear()
+{
+	// no data clears to zero
+	if (GLBackend::UseDSA())
+	{
+		CALLGL(glClearNamedBufferData(m_RenderID, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr));
+		GLBackend::CountSavedBinds();
+		return;
+	}
+	Bind(m_Target);
+	CALLGL(glClearBufferData(m_Target, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr));
+}
+
+void StorageBuffer::Read(void* data, unsigned int size, unsigned int offset) const
+{
+	ASSERT_GL(offset + size <= m_Size);
+	if (GLBackend::UseDSA())
+	{
+		CALLGL(glGetNamedBufferSubData(m_RenderID, offset, size, data));
+		GLBackend::CountSavedBinds();
+		return;
+	}
+	Bind(m_Target);
+	CALLGL(glGetBufferSubData(m_Target, offset, size, data));
+}
+
+void StorageBuffer::BindBase(unsigned int index) const
+{
+	CALLGL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, m_RenderID));
+	GLBackend::CountBinds();
+}
+void StorageBuffer::Bind(unsigned int target) const
+{
+	CALLGL(glBindBuffer(target, m_RenderID));
+	GLBackend::CountBinds();
+}
+void StorageBuffer::Unbind(unsigned int target) const
+{
+	CALLGL(glBindBuffer(target, 0));
+}
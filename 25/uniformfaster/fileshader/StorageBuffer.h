@@ -0,0 +1,39 @@
+#pragma once
+
+#include <GL/glew.h>
+
+// A buffer shaders read and write as layout(std430, binding = n) buffer
+// (GL 4.3 or ARB_shader_storage_buffer_object, see Shader::HasCompute).
+// The same buffer can hold the arguments of indirect draws and dispatches
+// or be read back after a Renderer::Barrier. Without DSA it is bound to
+// target to be filled, so a GL_DRAW_INDIRECT_BUFFER one also works on
+// drivers without storage buffers.
+class StorageBuffer {
+private:
+	unsigned int m_RenderID;
+	unsigned int m_Size;
+	unsigned int m_Usage;
+	unsigned int m_Target;
+public:
+	// data can be null, the contents are undefined then.
+	// GL_DYNAMIC_COPY for buffers only the GPU writes
+	StorageBuffer(const void* data, unsigned int size, unsigned int usage = GL_DYNAMIC_COPY,
+		unsigned int target = GL_SHADER_STORAGE_BUFFER);
+	~StorageBuffer();
+
+	void Update(const void* data, unsigned int size, unsigned int offset = 0);
+	// sets every byte to 0, counters before a dispatch appends to them
+	void Clear();
+	// copies back to the CPU. waits for GL commands that write the buffer,
+	// shader writes need Renderer::Barrier(GL_BUFFER_UPDATE_BARRIER_BIT) first
+	void Read(void* data, unsigned int size, unsigned int offset = 0) const;
+
+	// to binding = index of layout(std430, binding = index) buffer
+	void BindBase(unsigned int index) const;
+	// GL_DRAW_INDIRECT_BUFFER, GL_DISPATCH_INDIRECT_BUFFER, ...
+	void Bind(unsigned int target = GL_SHADER_STORAGE_BUFFER) const;
+	void Unbind(unsigned int target = GL_SHADER_STORAGE_BUFFER) const;
+
+	unsigned int GetRendererID() const { return m_RenderID; }
+	unsigned int GetSize() const { return m_Size; }
+};
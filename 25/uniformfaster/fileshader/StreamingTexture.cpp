@@ -0,0 +1,157 @@
+#include <cstring>
+
+#include "StreamingTexture.h"
+#include "Texture.h"
+#include "GLBackend.h"
+
+StreamingTexture::StreamingTexture(int width, int height, unsigned int internalFormat, unsigned int slotCount) :
+	m_RendererID(0),
+	m_Desc{ width, height, internalFormat, 1 },
+	m_BytesPerPixel(TexturePool::GetBytesPerPixel(internalFormat)),
+	m_CurrentSlot(0),
+	m_MapX(0), m_MapY(0), m_MapWidth(0), m_MapHeight(0),
+	m_Mapped(false),
+	m_BytesUploaded(0),
+	m_Stalls(0)
+{
+	m_RendererID = TexturePool::Get().Acquire(m_Desc);
+	Texture::SetSampling(m_RendererID, GL_LINEAR);
+	Texture::SetChannelSwizzle(m_RendererID, 4);
+	Texture::EndEdit();
+
+	// every slot can hold a full frame
+	m_Slots.resize(slotCount < 2 ? 2 : slotCount);
+	if (GLBackend::UseDSA())
+	{
+		for (Slot& slot : m_Slots)
+		{
+			slot.fence = nullptr;
+			CALLGL(glCreateBuffers(1, &slot.buffer));
+			CALLGL(glNamedBufferStorage(slot.buffer, width * height * m_BytesPerPixel, nullptr, GL_MAP_WRITE_BIT));
+		}
+		GLBackend::CountSavedBinds((unsigned int)m_Slots.size() + 1);
+		return;
+	}
+	for (Slot& slot : m_Slots)
+	{
+		slot.fence = nullptr;
+		CALLGL(glGenBuffers(1, &slot.buffer));
+		CALLGL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer));
+		CALLGL(glBufferData(GL_PIXEL_UNPACK_BUFFER, width * height * m_BytesPerPixel, nullptr, GL_STREAM_DRAW));
+	}
+	CALLGL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+	GLBackend::CountBinds((unsigned int)m_Slots.size() + 1);
+}
+StreamingTexture::~StreamingTexture()
+{
+	ASSERT_GL(!m_Mapped);
+	for (Slot& slot : m_Slots)
+	{
+		if (slot.fence)
+			CALLGL(glDeleteSync(slot.fence));
+		CALLGL(glDeleteBuffers(1, &slot.buffer));
+	}
+	TexturePool::Get().Release(m_RendererID, m_Desc);
+}
+
+unsigned char* StreamingTexture::Map(int x, int y, int width, int height)
+{
+	ASSERT_GL(!m_Mapped);
+	ASSERT_GL(x >= 0 && y >= 0 && x + width <= m_Desc.width && y + height <= m_Desc.height);
+
+	m_CurrentSlot = (m_CurrentSlot + 1) % m_Slots.size();
+	Slot& slot = m_Slots[m_CurrentSlot];
+
+	// the GPU may still be copying out of this slot from a few frames ago
+	bool idle = true;
+	if (slot.fence)
+	{
+		GLenum result;
+		CALLGL(result = glClientWaitSync(slot.fence, 0, 0));
+		if (result == GL_TIMEOUT_EXPIRED)
+		{
+			++m_Stalls;
+			CALLGL(result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000)); // 1s
+		}
+		idle = result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+		CALLGL(glDeleteSync(slot.fence));
+		slot.fence = nullptr;
+	}
+
+	m_MapX = x;
+	m_MapY = y;
+	m_MapWidth = width;
+	m_MapHeight = height;
+	m_Mapped = true;
+
+	// the fence says nobody reads the slot any more, so no need for the
+	// driver to synchronize on it either. if the wait timed out or failed
+	// the copy may still be reading it, then the invalidate without
+	// unsynchronized lets the driver orphan the storage instead
+	void* ptr;
+	GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+	if (idle)
+		access |= GL_MAP_UNSYNCHRONIZED_BIT;
+	if (GLBackend::UseDSA())
+	{
+		CALLGL(ptr = glMapNamedBufferRange(slot.buffer, 0, width * height * m_BytesPerPixel, access));
+		GLBackend::CountSavedBinds(2);
+		return (unsigned char*)ptr;
+	}
+	CALLGL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer));
+	CALLGL(ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, width * height * m_BytesPerPixel, access));
+	CALLGL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+	GLBackend::CountBinds(2);
+	return (unsigned char*)ptr;
+}
+
+void StreamingTexture::Unmap()
+{
+	ASSERT_GL(m_Mapped);
+	Slot& slot = m_Slots[m_CurrentSlot];
+
+	// the unpack buffer has to be bound on both paths, there is no DSA
+	// version of reading a texture upload from a buffer
+	CALLGL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer));
+	if (GLBackend::UseDSA())
+		CALLGL(glUnmapNamedBuffer(slot.buffer));
+	else
+		CALLGL(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+	// with a buffer bound to GL_PIXEL_UNPACK_BUFFER the pointer is an offset
+	// into it, the call returns right away and the copy happens on the GPU
+	if (!GLBackend::UseDSA())
+	{
+		CALLGL(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+		GLBackend::CountBinds();
+	}
+	Texture::SetSubImage(m_RendererID, m_MapX, m_MapY, m_MapWidth, m_MapHeight, m_BytesPerPixel, nullptr);
+	Texture::EndEdit();
+
+	CALLGL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+	GLBackend::CountBinds(2);
+
+	CALLGL(slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+	m_BytesUploaded += (unsigned long long)m_MapWidth * m_MapHeight * m_BytesPerPixel;
+	m_Mapped = false;
+}
+
+void StreamingTexture::Update(const void* data, int x, int y, int width, int height)
+{
+	unsigned char* dst = Map(x, y, width, height);
+	if (dst)
+		memcpy(dst, data, width * height * m_BytesPerPixel);
+	Unmap();
+}
+
+void StreamingTexture::Bind(unsigned int slot) const
+{
+	CALLGL(glActiveTexture(GL_TEXTURE0 + slot));
+	CALLGL(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	GLBackend::CountBinds();
+}
+void StreamingTexture::Unbind() const
+{
+	CALLGL(glBindTexture(GL_TEXTURE_2D, 0));
+}
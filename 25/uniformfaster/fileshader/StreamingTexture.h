@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include "Renderer.h"
+#include "TexturePool.h"
+
+// A texture whose content changes all the time (video, generated maps, ...).
+// Uploads go through a ring of pixel unpack buffers: while the GPU copies
+// out of one slot the CPU is already writing the next one. Each slot gets a
+// fence after its copy is queued and is only written again once that passed.
+class StreamingTexture
+{
+private:
+	struct Slot
+	{
+		unsigned int buffer;
+		GLsync fence;
+	};
+
+	unsigned int m_RendererID;
+	TextureDesc m_Desc;
+	unsigned int m_BytesPerPixel;
+	std::vector<Slot> m_Slots;
+	unsigned int m_CurrentSlot;
+
+	// rect being written between Map and Unmap
+	int m_MapX, m_MapY, m_MapWidth, m_MapHeight;
+	bool m_Mapped;
+
+	unsigned long long m_BytesUploaded;
+	unsigned int m_Stalls;
+
+public:
+	StreamingTexture(int width, int height, unsigned int internalFormat = GL_RGBA8, unsigned int slotCount = 3);
+	~StreamingTexture();
+
+	// returns memory for the w x h rect at (x, y), rows tightly packed.
+	// only what is written there changes, the rest keeps its old content
+	unsigned char* Map(int x, int y, int width, int height);
+	unsigned char* Map() { return Map(0, 0, m_Desc.width, m_Desc.height); }
+	// queues the copy into the texture
+	void Unmap();
+
+	void Update(const void* data) { Update(data, 0, 0, m_Desc.width, m_Desc.height); }
+	void Update(const void* data, int x, int y, int width, int height);
+
+	void Bind(unsigned int slot = 0) const;
+	void Unbind() const;
+
+	int GetWidth() const { return m_Desc.width; }
+	int GetHeight() const { return m_Desc.height; }
+	unsigned int GetSlotCount() const { return (unsigned int)m_Slots.size(); }
+
+	// total bytes handed to the GPU so far
+	unsigned long long GetBytesUploaded() const { return m_BytesUploaded; }
+	// how often Map had to wait for the GPU to finish with a slot
+	unsigned int GetStalls() const { return m_Stalls; }
+};
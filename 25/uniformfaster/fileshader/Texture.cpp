@@ -1,14 +1,202 @@
+#include <iostream>
+
 #include "Texture.h"
+#include "GLBackend.h"
 
 #include "stb_image/stb_image.h"
 
-Texture::Texture(const std::string& filepath) :
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define TEXTURE_USE_SSE2
+#endif
+
+// c * a / 255 rounded, exact for all 8 bit inputs
+static inline unsigned char MulDiv255(unsigned int c, unsigned int a)
+{
+	unsigned int t = c * a + 128;
+	return (unsigned char)((t + (t >> 8)) >> 8);
+}
+
+void Texture::PremultiplyAlpha(unsigned char* pixels, int pixelCount, int channels)
+{
+	ASSERT_GL(channels == 2 || channels == 4);
+	int byteCount = pixelCount * channels;
+	int i = 0;
+
+#ifdef TEXTURE_USE_SSE2
+	// 16 bytes at a time: widen to 16 bit, multiply by the alpha broadcast
+	// into every lane of its pixel, divide by 255 and put the alpha back
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i half = _mm_set1_epi16(128);
+	const __m128i alphaMask = channels == 4 ?
+		_mm_set1_epi32((int)0xFF000000) :
+		_mm_set1_epi16((short)0xFF00);
+	for (; i + 16 <= byteCount; i += 16)
+	{
+		__m128i px = _mm_loadu_si128((const __m128i*)(pixels + i));
+		__m128i lo = _mm_unpacklo_epi8(px, zero);
+		__m128i hi = _mm_unpackhi_epi8(px, zero);
+		__m128i alo, ahi;
+		if (channels == 4)
+		{
+			alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		}
+		else
+		{
+			alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+			ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+		}
+		lo = _mm_add_epi16(_mm_mullo_epi16(lo, alo), half);
+		hi = _mm_add_epi16(_mm_mullo_epi16(hi, ahi), half);
+		lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+		__m128i result = _mm_packus_epi16(lo, hi);
+		result = _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, px));
+		_mm_storeu_si128((__m128i*)(pixels + i), result);
+	}
+#endif
+
+	// whatever is left (or everything without SSE2)
+	for (; i < byteCount; i += channels)
+	{
+		unsigned int a = pixels[i + channels - 1];
+		for (int c = 0; c < channels - 1; ++c)
+			pixels[i + c] = MulDiv255(pixels[i + c], a);
+	}
+}
+
+unsigned int Texture::GetInternalFormatForChannels(int channels, bool srgb)
+{
+	switch (channels)
+	{
+	case 1: return GL_R8;
+	case 2: return GL_RG8;
+	case 3: return srgb ? GL_SRGB8 : GL_RGB8;
+	case 4: return srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+	}
+	ASSERT_GL(false);
+	return 0;
+}
+unsigned int Texture::GetFormatForChannels(int channels)
+{
+	switch (channels)
+	{
+	case 1: return GL_RED;
+	case 2: return GL_RG;
+	case 3: return GL_RGB;
+	case 4: return GL_RGBA;
+	}
+	ASSERT_GL(false);
+	return 0;
+}
+const char* Texture::GetInternalFormatName(unsigned int internalFormat)
+{
+	switch (internalFormat)
+	{
+	case GL_R8: return "GL_R8";
+	case GL_RG8: return "GL_RG8";
+	case GL_RGB8: return "GL_RGB8";
+	case GL_SRGB8: return "GL_SRGB8";
+	case GL_RGBA8: return "GL_RGBA8";
+	case GL_SRGB8_ALPHA8: return "GL_SRGB8_ALPHA8";
+	}
+	return "unknown";
+}
+
+static void SetParameteri(unsigned int id, GLenum name, GLint value)
+{
+	if (GLBackend::UseDSA())
+		CALLGL(glTextureParameteri(id, name, value));
+	else
+		CALLGL(glTexParameteri(GL_TEXTURE_2D, name, value));
+}
+
+void Texture::SetChannelSwizzle(unsigned int id, int channels)
+{
+	// shaders always read rgba, so spread the stored channels out.
+	// gray -> (l, l, l, 1), gray+alpha -> (l, l, l, a), rgb -> (r, g, b, 1).
+	// a recycled texture may still have a swizzle from its last user
+	GLint swizzle[] = { GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA };
+	if (channels == 1)
+	{
+		swizzle[1] = swizzle[2] = GL_RED;
+		swizzle[3] = GL_ONE;
+	}
+	else if (channels == 2)
+	{
+		swizzle[1] = swizzle[2] = GL_RED;
+		swizzle[3] = GL_GREEN;
+	}
+
+	if (GLBackend::UseDSA())
+		CALLGL(glTextureParameteriv(id, GL_TEXTURE_SWIZZLE_RGBA, swizzle));
+	else
+		CALLGL(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle));
+}
+
+void Texture::SetSampling(unsigned int id, int minFilter)
+{
+	// how our texture will actually be resampled down if it needs
+	// to be rendered smaller than it is kind of per pixel.
+	// we're gonna have an in-depth episode on all of these kind of
+	// texture parameters because like dealing with MIT maps and kind 
+	// of minification and magnification filtering and like you
+	// know edge clamping all that is it kind of a big topic then I don't want to just
+	// squeeze it in here so we will talk about this stuff in more detail in the future
+	SetParameteri(id, GL_TEXTURE_MIN_FILTER, minFilter);
+	SetParameteri(id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// the horizontal wrap so we wanted to clamp which means that we 
+	// wanted to basically not extend the area
+	SetParameteri(id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	SetParameteri(id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void Texture::SetSubImage(unsigned int id, int x, int y, int width, int height, int channels, const void* pixels)
+{
+	// rows of stbi data are tightly packed, but GL expects every row
+	// to start on a 4 byte boundary by default
+	bool rowsAligned = (width * channels) % 4 == 0;
+	if (!rowsAligned)
+		CALLGL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+	if (GLBackend::UseDSA())
+		CALLGL(glTextureSubImage2D(id, 0, x, y, width, height, GetFormatForChannels(channels), GL_UNSIGNED_BYTE, pixels));
+	else
+		CALLGL(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GetFormatForChannels(channels), GL_UNSIGNED_BYTE, pixels));
+
+	if (!rowsAligned)
+		CALLGL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+}
+
+void Texture::GenerateMipmap(unsigned int id)
+{
+	if (GLBackend::UseDSA())
+		CALLGL(glGenerateTextureMipmap(id));
+	else
+		CALLGL(glGenerateMipmap(GL_TEXTURE_2D));
+}
+
+void Texture::EndEdit()
+{
+	if (GLBackend::UseDSA())
+	{
+		GLBackend::CountSavedBinds();
+		return;
+	}
+	CALLGL(glBindTexture(GL_TEXTURE_2D, 0));
+	GLBackend::CountBinds();
+}
+
+Texture::Texture(const std::string& filepath, bool srgb) :
 	m_RedererID(0),
 	m_FilePath(filepath),
 	m_LocalBuffer(nullptr),
 	m_Width(0),
 	m_Height(0),
-	m_BPP(0)
+	m_BPP(0),
+	m_InternalFormat(0)
 {
 	// flip texture upside down
 	// OpenGL read a texture from bottom-left
@@ -17,78 +205,63 @@ Texture::Texture(const std::string& filepath) :
 		&m_Width,
 		&m_Height,
 		&m_BPP,
-		4 // RGBA
+		0 // keep the channel count of the file
 	);
-	CALLGL(glGenTextures(1, &m_RedererID));
-	CALLGL(glBindTexture(GL_TEXTURE_2D, m_RedererID));
+	if (!m_LocalBuffer)
+	{
+		std::cerr << "Failed to load texture '" << filepath << "'" << std::endl;
+		m_Width = m_Height = 1;
+		m_BPP = 4;
+	}
+	m_InternalFormat = GetInternalFormatForChannels(m_BPP, srgb);
 
-	CALLGL(glTexParameteri(
-		GL_TEXTURE_2D,
-		// how our texture will actually be resampled down if it needs
-		// to be rendered smaller than it is kind of per pixel.
-		// we're gonna have an in-depth episode on all of these kind of
-		// texture parameters because like dealing with MIT maps and kind 
-		// of minification and magnification filtering and like you
-		// know edge clamping all that is it kind of a big topic then I don't want to just
-		// squeeze it in here so we will talk about this stuff in more detail in the future
-		GL_TEXTURE_MIN_FILTER,
-
-		// set to geo linear which just going to linearly resample
-		// everything so we'll kind of still look
-		// ok it's not going to snap at the nearest
-		// pixel which is what gel nearest would do
-		GL_LINEAR
-	));
-	CALLGL(glTexParameteri(
-		GL_TEXTURE_2D,
-		GL_TEXTURE_MAG_FILTER,
-		GL_LINEAR
-	));
-	CALLGL(glTexParameteri(
-		GL_TEXTURE_2D,
-
-		// the horizontal wrap so we wanted to clamp which means that we 
-		// wanted to basically not extend the area
-		GL_TEXTURE_WRAP_S,
-		GL_CLAMP_TO_EDGE
-	));
-	CALLGL(glTexParameteri(
-		GL_TEXTURE_2D,
-		GL_TEXTURE_WRAP_T,
-		GL_CLAMP_TO_EDGE
-	));
-
-
-	CALLGL(glTexImage2D(
-		GL_TEXTURE_2D,
-
-		// later
-		0,
-		GL_RGBA8,
-		m_Width, m_Height,
-
-		// border
-		0,
-		GL_RGBA,
-		GL_UNSIGNED_BYTE,
-		m_LocalBuffer));
+	// premultiply once here so filtering never blends in the color of
+	// fully transparent texels (the dark fringes around sprites)
+	if (m_LocalBuffer && (m_BPP == 2 || m_BPP == 4))
+		PremultiplyAlpha(m_LocalBuffer, m_Width * m_Height, m_BPP);
 
-	CALLGL(glBindTexture(GL_TEXTURE_2D, 0));
+	// recycled from an earlier texture of the same size and format if possible
+	m_RedererID = TexturePool::Get().Acquire(GetDesc());
+
+	SetSampling(m_RedererID, GL_LINEAR);
+	SetChannelSwizzle(m_RedererID, m_BPP);
+
+	static const unsigned char missing[] = { 255, 0, 255, 255 };
+	SetSubImage(m_RedererID, 0, 0, m_Width, m_Height, m_BPP, m_LocalBuffer ? m_LocalBuffer : missing);
+
+	EndEdit();
 
 	if (m_LocalBuffer)
 		stbi_image_free(m_LocalBuffer);
 }
 Texture::~Texture()
 {
-	CALLGL(glDeleteTextures(1, &m_RedererID));
+	TexturePool::Get().Release(m_RedererID, GetDesc());
 }
 
 void Texture::Bind(unsigned int slot) const
 {
 	CALLGL(glActiveTexture(GL_TEXTURE0 + slot));
 	CALLGL(glBindTexture(GL_TEXTURE_2D, m_RedererID));
+	GLBackend::CountBinds();
 }
 void Texture::Unbind() const
 {
 	CALLGL(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+void Texture::BindImage(unsigned int unit, unsigned int access) const
+{
+	BindImage(unit, m_RedererID, m_InternalFormat, access);
+}
+
+void Texture::BindImage(unsigned int unit, unsigned int id, unsigned int internalFormat, unsigned int access, int level)
+{
+	if (internalFormat == GL_SRGB8 || internalFormat == GL_SRGB8_ALPHA8)
+	{
+		std::cerr << "sRGB textures can't be bound as images" << std::endl;
+		return;
+	}
+	CALLGL(glBindImageTexture(unit, id, level, GL_FALSE, 0, access, internalFormat));
+	GLBackend::CountBinds();
 }
\ No newline at end of file
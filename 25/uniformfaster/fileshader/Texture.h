@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include "Renderer.h"
+#include "TexturePool.h"
 
 class Texture
 {
@@ -9,14 +10,49 @@ private:
 	std::string m_FilePath;
 	unsigned char* m_LocalBuffer;
 	int m_Width, m_Height, m_BPP;
+	unsigned int m_InternalFormat;
 
 public:
-	Texture(const std::string& filepath);
+	// srgb only applies to RGB and RGBA images, core GL has no sRGB R8/RG8
+	Texture(const std::string& filepath, bool srgb = false);
 	~Texture();
 
 	void Bind(unsigned int slot = 0) const;
 	void Unbind() const;
+	// for imageLoad/imageStore, layout(binding = unit) in the shader.
+	// access is GL_READ_ONLY, GL_WRITE_ONLY or GL_READ_WRITE
+	void BindImage(unsigned int unit, unsigned int access = GL_READ_ONLY) const;
 
 	int GetWidth() const { return m_Width; }
 	int GetHeight() const { return m_Height; }
-};
\ No newline at end of file
+	int GetChannels() const { return m_BPP; }
+	unsigned int GetInternalFormat() const { return m_InternalFormat; }
+	TextureDesc GetDesc() const { return { m_Width, m_Height, m_InternalFormat, 1 }; }
+
+	// bytes the texture occupies on the GPU (level 0 only)
+	unsigned int GetSizeInBytes() const { return m_Width * m_Height * m_BPP; }
+
+	// multiplies color by alpha in place for 2 (gray+alpha) or 4 channel pixels.
+	// everything is drawn with glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)
+	static void PremultiplyAlpha(unsigned char* pixels, int pixelCount, int channels);
+
+	// edits shared by the texture wrappers. with DSA they go straight to id,
+	// otherwise id has to be bound to GL_TEXTURE_2D (TexturePool::Acquire does)
+	// and EndEdit unbinds it again
+
+	// sets the swizzle so shaders see rgba
+	static void SetChannelSwizzle(unsigned int id, int channels);
+	// linear mag filter, clamp to edge
+	static void SetSampling(unsigned int id, int minFilter);
+	// tightly packed rows, pixels is an offset when a buffer is bound to GL_PIXEL_UNPACK_BUFFER
+	static void SetSubImage(unsigned int id, int x, int y, int width, int height, int channels, const void* pixels);
+	static void GenerateMipmap(unsigned int id);
+	// any texture with immutable storage (TexturePool::Acquire makes those).
+	// image units need GL 4.3 and don't take sRGB formats
+	static void BindImage(unsigned int unit, unsigned int id, unsigned int internalFormat, unsigned int access, int level = 0);
+	static void EndEdit();
+
+	static unsigned int GetInternalFormatForChannels(int channels, bool srgb);
+	static unsigned int GetFormatForChannels(int channels);
+	static const char* GetInternalFormatName(unsigned int internalFormat);
+};
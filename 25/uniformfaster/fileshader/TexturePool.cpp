@@ -0,0 +1,192 @@
+#include <algorithm>
+
+#include "Renderer.h"
+#include "TexturePool.h"
+#include "GLBackend.h"
+
+unsigned int TextureDesc::GetSizeInBytes() const
+{
+	unsigned int bytes = 0;
+	int w = width;
+	int h = height;
+	for (int level = 0; level < levels; ++level)
+	{
+		bytes += w * h * TexturePool::GetBytesPerPixel(internalFormat);
+		w = std::max(1, w / 2);
+		h = std::max(1, h / 2);
+	}
+	return bytes;
+}
+
+TexturePool::TexturePool(unsigned int idleBudget) :
+	m_IdleBytes(0),
+	m_IdleBudget(idleBudget),
+	m_LiveBytes(0),
+	m_Allocations(0),
+	m_Reuses(0)
+{
+}
+TexturePool::~TexturePool()
+{
+	// by now the context is usually gone, Clear() should have been called
+	ASSERT_GL(m_Idle.empty());
+}
+
+TexturePool& TexturePool::Get()
+{
+	static TexturePool pool;
+	return pool;
+}
+
+unsigned int TexturePool::GetBytesPerPixel(unsigned int internalFormat)
+{
+	switch (internalFormat)
+	{
+	case GL_R8: return 1;
+	case GL_RG8: return 2;
+	case GL_RGB8:
+	case GL_SRGB8: return 3;
+	case GL_RGBA8:
+	case GL_SRGB8_ALPHA8: return 4;
+	}
+	ASSERT_GL(false);
+	return 0;
+}
+unsigned int TexturePool::GetFormatForInternalFormat(unsigned int internalFormat)
+{
+	switch (internalFormat)
+	{
+	case GL_R8: return GL_RED;
+	case GL_RG8: return GL_RG;
+	case GL_RGB8:
+	case GL_SRGB8: return GL_RGB;
+	case GL_RGBA8:
+	case GL_SRGB8_ALPHA8: return GL_RGBA;
+	}
+	ASSERT_GL(false);
+	return 0;
+}
+
+unsigned int TexturePool::Allocate(const TextureDesc& desc)
+{
+	unsigned int id;
+	if (GLBackend::UseDSA())
+	{
+		CALLGL(glCreateTextures(GL_TEXTURE_2D, 1, &id));
+		CALLGL(glTextureStorage2D(id, desc.levels, desc.internalFormat, desc.width, desc.height));
+		GLBackend::CountSavedBinds();
+		++m_Allocations;
+		return id;
+	}
+
+	CALLGL(glGenTextures(1, &id));
+	CALLGL(glBindTexture(GL_TEXTURE_2D, id));
+	GLBackend::CountBinds();
+
+	if (GLEW_ARB_texture_storage)
+	{
+		CALLGL(glTexStorage2D(GL_TEXTURE_2D, desc.levels, desc.internalFormat, desc.width, desc.height));
+	}
+	else
+	{
+		// same result on plain 3.3, just mutable
+		int w = desc.width;
+		int h = desc.height;
+		for (int level = 0; level < desc.levels; ++level)
+		{
+			CALLGL(glTexImage2D(GL_TEXTURE_2D, level, desc.internalFormat, w, h, 0,
+				GetFormatForInternalFormat(desc.internalFormat), GL_UNSIGNED_BYTE, nullptr));
+			w = std::max(1, w / 2);
+			h = std::max(1, h / 2);
+		}
+		CALLGL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, desc.levels - 1));
+	}
+	++m_Allocations;
+	return id;
+}
+
+unsigned int TexturePool::Acquire(const TextureDesc& desc)
+{
+	unsigned int id;
+	IdleIndex::iterator it = m_IdleIndex.find(desc);
+	if (it != m_IdleIndex.end())
+	{
+		id = it->second->id;
+		m_Idle.erase(it->second);
+		m_IdleIndex.erase(it);
+		m_IdleBytes -= desc.GetSizeInBytes();
+		++m_Reuses;
+		if (GLBackend::UseDSA())
+		{
+			GLBackend::CountSavedBinds();
+		}
+		else
+		{
+			CALLGL(glBindTexture(GL_TEXTURE_2D, id));
+			GLBackend::CountBinds();
+		}
+	}
+	else
+	{
+		id = Allocate(desc);
+	}
+	m_LiveBytes += desc.GetSizeInBytes();
+	return id;
+}
+
+void TexturePool::Release(unsigned int id, const TextureDesc& desc)
+{
+	if (id == 0)
+		return;
+
+	unsigned int bytes = desc.GetSizeInBytes();
+	m_LiveBytes -= bytes;
+
+	// bigger than the whole budget, nothing to gain by keeping it
+	if (bytes > m_IdleBudget)
+	{
+		CALLGL(glDeleteTextures(1, &id));
+		return;
+	}
+
+	m_Idle.push_back({ desc, id });
+	m_IdleIndex.insert({ desc, std::prev(m_Idle.end()) });
+	m_IdleBytes += bytes;
+	Trim(m_IdleBudget);
+}
+
+void TexturePool::Destroy(unsigned int id, const TextureDesc& desc)
+{
+	if (id == 0)
+		return;
+	m_LiveBytes -= desc.GetSizeInBytes();
+	CALLGL(glDeleteTextures(1, &id));
+}
+
+void TexturePool::Trim(unsigned int budget)
+{
+	while (m_IdleBytes > budget && !m_Idle.empty())
+	{
+		IdleList::iterator oldest = m_Idle.begin();
+
+		auto range = m_IdleIndex.equal_range(oldest->desc);
+		for (IdleIndex::iterator it = range.first; it != range.second; ++it)
+		{
+			if (it->second == oldest)
+			{
+				m_IdleIndex.erase(it);
+				break;
+			}
+		}
+
+		m_IdleBytes -= oldest->desc.GetSizeInBytes();
+		CALLGL(glDeleteTextures(1, &oldest->id));
+		m_Idle.erase(oldest);
+	}
+}
+
+void TexturePool::SetIdleBudget(unsigned int budget)
+{
+	m_IdleBudget = budget;
+	Trim(m_IdleBudget);
+}
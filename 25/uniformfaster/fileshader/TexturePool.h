@@ -0,0 +1,89 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+struct TextureDesc
+{
+	int width;
+	int height;
+	unsigned int internalFormat;
+	int levels;
+
+	bool operator==(const TextureDesc& other) const
+	{
+		return width == other.width && height == other.height &&
+			internalFormat == other.internalFormat && levels == other.levels;
+	}
+
+	// GPU bytes of all mip levels
+	unsigned int GetSizeInBytes() const;
+};
+
+struct TextureDescHash
+{
+	size_t operator()(const TextureDesc& desc) const
+	{
+		size_t h = (size_t)desc.width;
+		h = h * 31 + (size_t)desc.height;
+		h = h * 31 + (size_t)desc.internalFormat;
+		h = h * 31 + (size_t)desc.levels;
+		return h;
+	}
+};
+
+// Keeps released texture objects around so a new texture of the same
+// size and format reuses them instead of making the driver allocate again.
+// Storage is immutable (glTexStorage2D), new content goes in with glTexSubImage2D.
+class TexturePool
+{
+private:
+	struct IdleEntry
+	{
+		TextureDesc desc;
+		unsigned int id;
+	};
+	using IdleList = std::list<IdleEntry>; // oldest first
+	using IdleIndex = std::unordered_multimap<TextureDesc, IdleList::iterator, TextureDescHash>;
+
+	IdleList m_Idle;
+	IdleIndex m_IdleIndex;
+	unsigned int m_IdleBytes;
+	unsigned int m_IdleBudget;
+	unsigned int m_LiveBytes;
+	unsigned int m_Allocations;
+	unsigned int m_Reuses;
+
+public:
+	TexturePool(unsigned int idleBudget = 64 * 1024 * 1024);
+	~TexturePool();
+
+	static TexturePool& Get();
+
+	// returns a texture object with storage for desc. bound to GL_TEXTURE_2D
+	// unless GLBackend::UseDSA(), see Texture::EndEdit
+	unsigned int Acquire(const TextureDesc& desc);
+	// gives the texture back, it stays allocated until trimmed
+	void Release(unsigned int id, const TextureDesc& desc);
+	// gives the texture back and deletes it, for owners that keep their own idle textures
+	void Destroy(unsigned int id, const TextureDesc& desc);
+
+	// deletes least recently released textures until idle memory fits in budget
+	void Trim(unsigned int budget);
+	// deletes every idle texture, call before the context goes away
+	void Clear() { Trim(0); }
+
+	void SetIdleBudget(unsigned int budget);
+	unsigned int GetIdleBudget() const { return m_IdleBudget; }
+	unsigned int GetIdleBytes() const { return m_IdleBytes; }
+	unsigned int GetIdleCount() const { return (unsigned int)m_Idle.size(); }
+	unsigned int GetLiveBytes() const { return m_LiveBytes; }
+	unsigned int GetAllocations() const { return m_Allocations; }
+	unsigned int GetReuses() const { return m_Reuses; }
+
+	static unsigned int GetBytesPerPixel(unsigned int internalFormat);
+	static unsigned int GetFormatForInternalFormat(unsigned int internalFormat);
+
+private:
+	unsigned int Allocate(const TextureDesc& desc);
+};
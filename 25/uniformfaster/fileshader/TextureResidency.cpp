@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <iostream>
+
+#include "Renderer.h"
+#include "Texture.h"
+#include "TextureResidency.h"
+#include "GLBackend.h"
+
+#include "stb_image/stb_image.h"
+
+// longest side of the always resident fallback
+static const int FallbackSize = 32;
+
+// 2x2 box filter, odd edges just repeat the last texel
+static std::vector<unsigned char> Downsample(const unsigned char* src, int width, int height, int channels, int& outWidth, int& outHeight)
+{
+	outWidth = std::max(1, width / 2);
+	outHeight = std::max(1, height / 2);
+	std::vector<unsigned char> dst(outWidth * outHeight * channels);
+	for (int y = 0; y < outHeight; ++y)
+	{
+		int y0 = std::min(y * 2, height - 1);
+		int y1 = std::min(y * 2 + 1, height - 1);
+		for (int x = 0; x < outWidth; ++x)
+		{
+			int x0 = std::min(x * 2, width - 1);
+			int x1 = std::min(x * 2 + 1, width - 1);
+			for (int c = 0; c < channels; ++c)
+			{
+				unsigned int sum =
+					src[(y0 * width + x0) * channels + c] + src[(y0 * width + x1) * channels + c] +
+					src[(y1 * width + x0) * channels + c] + src[(y1 * width + x1) * channels + c];
+				dst[(y * outWidth + x) * channels + c] = (unsigned char)((sum + 2) / 4);
+			}
+		}
+	}
+	return dst;
+}
+
+static int GetMipCount(int width, int height)
+{
+	int levels = 1;
+	while (width > 1 || height > 1)
+	{
+		width = std::max(1, width / 2);
+		height = std::max(1, height / 2);
+		++levels;
+	}
+	return levels;
+}
+
+TextureResidency::TextureResidency(unsigned int budget) :
+	m_IdleBytes(0),
+	m_DefaultID(0),
+	m_Budget(budget),
+	m_ResidentBytes(0),
+	m_Frame(0),
+	m_Loads(0),
+	m_Evictions(0),
+	m_Quit(false)
+{
+	static const unsigned char grey[] = { 128, 128, 128, 255 };
+	TextureDesc desc;
+	m_DefaultID = Upload(grey, 1, 1, 4, false, desc);
+
+	m_Worker = std::thread(&TextureResidency::WorkerMain, this);
+}
+TextureResidency::~TextureResidency()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+	m_Condition.notify_one();
+	m_Worker.join();
+
+	for (Entry& entry : m_Entries)
+	{
+		Evict(entry);
+		if (entry.fallbackID)
+			TexturePool::Get().Release(entry.fallbackID, entry.fallbackDesc);
+	}
+	for (const IdleTexture& idle : m_Idle)
+		TexturePool::Get().Release(idle.id, idle.desc);
+	TexturePool::Get().Release(m_DefaultID, { 1, 1, GL_RGBA8, 1 });
+}
+
+TextureResidency::Handle TextureResidency::Register(const std::string& path)
+{
+	Entry entry = {};
+	entry.path = path;
+	entry.residentLod = -1;
+	m_Entries.push_back(entry);
+	return (Handle)(m_Entries.size() - 1);
+}
+
+// finest level whose size still covers the screen size, the levels
+// below it would never be sampled
+int TextureResidency::GetLodForSize(int width, int height, int displayedSize)
+{
+	int size = std::max(width, height);
+	int lod = 0;
+	while ((size >> (lod + 1)) >= std::max(displayedSize, 1))
+		++lod;
+	return lod;
+}
+
+void TextureResidency::Bind(Handle handle, int displayedSize, unsigned int slot)
+{
+	Entry& entry = m_Entries[handle];
+	entry.lastUsedFrame = m_Frame;
+
+	// only load what the screen size needs. a texture that holds two or
+	// more levels too many is reloaded smaller, one level of slack keeps
+	// it from reloading back and forth while something zooms
+	bool load = entry.residentLod < 0;
+	if (entry.width > 0 && entry.residentLod >= 0)
+	{
+		int lod = GetLodForSize(entry.width, entry.height, displayedSize);
+		load = lod < entry.residentLod || lod > entry.residentLod + 1;
+	}
+
+	if (load && !entry.loading)
+	{
+		entry.loading = true;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Requests.push_back({ handle, entry.path, displayedSize, entry.fallbackID == 0 });
+		}
+		m_Condition.notify_one();
+	}
+
+	unsigned int id = entry.id ? entry.id : (entry.fallbackID ? entry.fallbackID : m_DefaultID);
+	CALLGL(glActiveTexture(GL_TEXTURE0 + slot));
+	CALLGL(glBindTexture(GL_TEXTURE_2D, id));
+	GLBackend::CountBinds();
+}
+
+void TextureResidency::Update()
+{
+	std::vector<LoadResult> results;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		results.swap(m_Results);
+	}
+
+	for (LoadResult& result : results)
+	{
+		Entry& entry = m_Entries[result.handle];
+		entry.loading = false;
+		if (!result.ok)
+			continue;
+
+		entry.width = result.width;
+		entry.height = result.height;
+		entry.channels = result.channels;
+		if (!result.fallbackPixels.empty())
+		{
+			TexturePool::Get().Release(entry.fallbackID, entry.fallbackDesc);
+			entry.fallbackID = Upload(result.fallbackPixels.data(), result.fallbackWidth, result.fallbackHeight,
+				result.channels, false, entry.fallbackDesc);
+		}
+
+		Evict(entry);
+		entry.id = Upload(result.pixels.data(), result.lodWidth, result.lodHeight, result.channels, true, entry.desc);
+		entry.residentLod = result.lod;
+		m_ResidentBytes += entry.desc.GetSizeInBytes();
+		++m_Loads;
+	}
+
+	// least recently used first, never what was drawn this frame
+	while (m_ResidentBytes > m_Budget)
+	{
+		Entry* oldest = nullptr;
+		for (Entry& entry : m_Entries)
+		{
+			if (entry.residentLod >= 0 && entry.lastUsedFrame != m_Frame &&
+				(!oldest || entry.lastUsedFrame < oldest->lastUsedFrame))
+				oldest = &entry;
+		}
+		if (!oldest)
+			break;
+		Evict(*oldest);
+		++m_Evictions;
+	}
+	// evicted textures are GPU memory too, they get what the resident ones
+	// leave of the budget
+	TrimIdle(m_Budget > m_ResidentBytes ? m_Budget - m_ResidentBytes : 0);
+
+	++m_Frame;
+}
+
+unsigned int TextureResidency::GetResidentCount() const
+{
+	unsigned int count = 0;
+	for (const Entry& entry : m_Entries)
+		if (entry.residentLod >= 0)
+			++count;
+	return count;
+}
+unsigned int TextureResidency::GetPendingCount() const
+{
+	unsigned int count = 0;
+	for (const Entry& entry : m_Entries)
+		if (entry.loading)
+			++count;
+	return count;
+}
+
+void TextureResidency::Evict(Entry& entry)
+{
+	if (entry.residentLod < 0)
+		return;
+	unsigned int bytes = entry.desc.GetSizeInBytes();
+	m_ResidentBytes -= bytes;
+	m_Idle.push_back({ entry.id, entry.desc });
+	m_IdleBytes += bytes;
+	entry.id = 0;
+	entry.residentLod = -1;
+}
+
+void TextureResidency::TrimIdle(unsigned int budget)
+{
+	while (m_IdleBytes > budget && !m_Idle.empty())
+	{
+		const IdleTexture& oldest = m_Idle.front();
+		m_IdleBytes -= oldest.desc.GetSizeInBytes();
+		TexturePool::Get().Destroy(oldest.id, oldest.desc);
+		m_Idle.pop_front();
+	}
+}
+
+unsigned int TextureResidency::Acquire(const TextureDesc& desc)
+{
+	for (std::deque<IdleTexture>::iterator it = m_Idle.begin(); it != m_Idle.end(); ++it)
+	{
+		if (!(it->desc == desc))
+			continue;
+		unsigned int id = it->id;
+		m_IdleBytes -= desc.GetSizeInBytes();
+		m_Idle.erase(it);
+		// bound like the ones TexturePool::Acquire returns
+		if (GLBackend::UseDSA())
+		{
+			GLBackend::CountSavedBinds();
+		}
+		else
+		{
+			CALLGL(glBindTexture(GL_TEXTURE_2D, id));
+			GLBackend::CountBinds();
+		}
+		return id;
+	}
+	return TexturePool::Get().Acquire(desc);
+}
+
+unsigned int TextureResidency::Upload(const unsigned char* pixels, int width, int height, int channels, bool mipmaps, TextureDesc& desc)
+{
+	desc = { width, height, Texture::GetInternalFormatForChannels(channels, false), mipmaps ? GetMipCount(width, height) : 1 };
+	unsigned int id = Acquire(desc);
+
+	Texture::SetSampling(id, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	Texture::SetChannelSwizzle(id, channels);
+	Texture::SetSubImage(id, 0, 0, width, height, channels, pixels);
+	if (mipmaps)
+		Texture::GenerateMipmap(id);
+	Texture::EndEdit();
+	return id;
+}
+
+void TextureResidency::WorkerMain()
+{
+	while (true)
+	{
+		LoadRequest request;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return m_Quit || !m_Requests.empty(); });
+			if (m_Quit)
+				return;
+			request = m_Requests.front();
+			m_Requests.pop_front();
+		}
+
+		LoadResult result = Load(request);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Results.push_back(std::move(result));
+	}
+}
+
+// runs on the worker, no GL in here
+TextureResidency::LoadResult TextureResidency::Load(const LoadRequest& request)
+{
+	LoadResult result = {};
+	result.handle = request.handle;
+
+	// the global flag is also set by Texture on the main thread, this one
+	// belongs to the worker alone
+	stbi_set_flip_vertically_on_load_thread(1);
+	unsigned char* data = stbi_load(request.path.c_str(), &result.width, &result.height, &result.channels, 0);
+	if (!data)
+	{
+		std::cerr << "Failed to load texture '" << request.path << "'" << std::endl;
+		return result;
+	}
+	if (result.channels == 2 || result.channels == 4)
+		Texture::PremultiplyAlpha(data, result.width * result.height, result.channels);
+
+	std::vector<unsigned char> level(data, data + result.width * result.height * result.channels);
+	stbi_image_free(data);
+
+	int wantedLod = GetLodForSize(result.width, result.height, request.displayedSize);
+	int width = result.width;
+	int height = result.height;
+	int lod = 0;
+	bool fallbackDone = !request.needFallback;
+	while (lod < wantedLod || !fallbackDone)
+	{
+		if (lod == wantedLod)
+		{
+			result.pixels = level;
+			result.lodWidth = width;
+			result.lodHeight = height;
+		}
+		if (!fallbackDone && std::max(width, height) <= FallbackSize)
+		{
+			result.fallbackPixels = level;
+			result.fallbackWidth = width;
+			result.fallbackHeight = height;
+			fallbackDone = true;
+			if (lod >= wantedLod)
+				break;
+		}
+		level = Downsample(level.data(), width, height, result.channels, width, height);
+		++lod;
+	}
+	if (lod == wantedLod && result.pixels.empty())
+	{
+		result.pixels = std::move(level);
+		result.lodWidth = width;
+		result.lodHeight = height;
+	}
+	result.lod = wantedLod;
+	result.ok = true;
+	return result;
+}
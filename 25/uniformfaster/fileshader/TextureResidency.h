@@ -0,0 +1,117 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TexturePool.h"
+
+// Keeps a large set of textures on the GPU only while they are used.
+// Every texture registered here has a tiny fallback that stays resident,
+// the real texture is decoded on a worker thread when it's bound, at the
+// mip level its on-screen size needs, and the least recently used ones
+// are dropped again whenever the resident bytes go over the budget.
+// Dropped textures are kept for reuse while the budget has room for them,
+// apart from TexturePool so other owners' idle textures don't count.
+class TextureResidency
+{
+public:
+	using Handle = unsigned int;
+
+private:
+	struct Entry
+	{
+		std::string path;
+		int width, height, channels; // of the file, 0 until first load
+
+		unsigned int id;
+		TextureDesc desc;
+		int residentLod; // -1 when not resident
+
+		unsigned int fallbackID;
+		TextureDesc fallbackDesc;
+
+		bool loading;
+		unsigned int lastUsedFrame;
+	};
+
+	struct LoadRequest
+	{
+		Handle handle;
+		std::string path;
+		int displayedSize;
+		bool needFallback;
+	};
+
+	struct LoadResult
+	{
+		Handle handle;
+		bool ok;
+		int width, height, channels;
+		int lod;
+		int lodWidth, lodHeight;
+		std::vector<unsigned char> pixels;
+		int fallbackWidth, fallbackHeight;
+		std::vector<unsigned char> fallbackPixels;
+	};
+
+	struct IdleTexture
+	{
+		unsigned int id;
+		TextureDesc desc;
+	};
+
+	std::vector<Entry> m_Entries;
+	std::deque<IdleTexture> m_Idle; // evicted, oldest first
+	unsigned int m_IdleBytes;
+	unsigned int m_DefaultID; // 1x1 grey until even the fallback is there
+	unsigned int m_Budget;
+	unsigned int m_ResidentBytes;
+	unsigned int m_Frame;
+	unsigned int m_Loads;
+	unsigned int m_Evictions;
+
+	std::thread m_Worker;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::deque<LoadRequest> m_Requests;
+	std::vector<LoadResult> m_Results;
+	bool m_Quit;
+
+public:
+	TextureResidency(unsigned int budget = 32 * 1024 * 1024);
+	~TextureResidency();
+
+	Handle Register(const std::string& path);
+
+	// binds whatever is resident for the texture and marks it as used this
+	// frame. displayedSize is the longest on-screen side in pixels
+	void Bind(Handle handle, int displayedSize, unsigned int slot = 0);
+
+	// once per frame: uploads finished loads and evicts down to the budget
+	void Update();
+
+	void SetBudget(unsigned int budget) { m_Budget = budget; }
+	unsigned int GetBudget() const { return m_Budget; }
+	unsigned int GetResidentBytes() const { return m_ResidentBytes; }
+	unsigned int GetIdleBytes() const { return m_IdleBytes; }
+	unsigned int GetResidentCount() const;
+	unsigned int GetPendingCount() const;
+	unsigned int GetLoads() const { return m_Loads; }
+	unsigned int GetEvictions() const { return m_Evictions; }
+	unsigned int GetCount() const { return (unsigned int)m_Entries.size(); }
+	int GetResidentLod(Handle handle) const { return m_Entries[handle].residentLod; }
+
+private:
+	void WorkerMain();
+	static LoadResult Load(const LoadRequest& request);
+	static int GetLodForSize(int width, int height, int displayedSize);
+	unsigned int Upload(const unsigned char* pixels, int width, int height, int channels, bool mipmaps, TextureDesc& desc);
+	// an evicted texture of desc if there is one, else one from TexturePool
+	unsigned int Acquire(const TextureDesc& desc);
+	void Evict(Entry& entry);
+	void TrimIdle(unsigned int budget);
+};
@@ -0,0 +1,256 @@
+#include "Tilemap.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Shader.h"
+#include "GLBackend.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+Tilemap::Tilemap(int width, int height, int chunkSize) :
+	m_Width(width),
+	m_Height(height),
+	m_ChunkSize(chunkSize),
+	m_ChunksX((width + chunkSize - 1) / chunkSize),
+	m_ChunksY((height + chunkSize - 1) / chunkSize),
+	m_Tiles((size_t)width * height, 0),
+	m_Texture(0),
+	m_Sampling(TileSampling::Atlas),
+	m_AtlasColumns(1),
+	m_AtlasRows(1),
+	m_BuildBudget(64),
+	m_ResidentBytes(0),
+	m_FrameStats{}
+{
+	ASSERT_GL(chunkSize > 0 && chunkSize < 128);
+	m_Chunks.resize((size_t)m_ChunksX * m_ChunksY);
+	for (Chunk& chunk : m_Chunks)
+	{
+		chunk.tileCount = 0;
+		chunk.dirtyBegin = chunk.dirtyEnd = 0;
+	}
+
+	m_Layout.PushInteger<unsigned char>(2);
+	m_Layout.PushInteger<unsigned short>(1);
+
+	// the same two triangles for every tile, corners are numbered
+	// counter-clockwise from the bottom left
+	unsigned int tiles = chunkSize * chunkSize;
+	std::vector<unsigned int> indices;
+	indices.reserve(tiles * 6);
+	for (unsigned int i = 0; i < tiles; ++i)
+	{
+		unsigned int base = i * 4;
+		indices.insert(indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+	}
+	m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+	m_Scratch.resize(tiles * 4);
+}
+
+Tilemap::~Tilemap()
+{
+	if (m_Texture)
+		CALLGL(glDeleteTextures(1, &m_Texture));
+}
+
+void Tilemap::SetTileSet(const unsigned char* pixels, int tileSize, int tileCount, TileSampling sampling)
+{
+	if (m_Texture)
+		CALLGL(glDeleteTextures(1, &m_Texture));
+	m_Sampling = sampling;
+
+	CALLGL(glGenTextures(1, &m_Texture));
+	if (sampling == TileSampling::Array)
+	{
+		CALLGL(glBindTexture(GL_TEXTURE_2D_ARRAY, m_Texture));
+		CALLGL(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, tileSize, tileSize, tileCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+		CALLGL(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+		CALLGL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+		CALLGL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+		CALLGL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+		CALLGL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+		CALLGL(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+		return;
+	}
+
+	// as square as possible
+	m_AtlasColumns = (int)std::ceil(std::sqrt((float)tileCount));
+	m_AtlasRows = (tileCount + m_AtlasColumns - 1) / m_AtlasColumns;
+	int atlasWidth = m_AtlasColumns * tileSize;
+	std::vector<unsigned char> atlas((size_t)atlasWidth * m_AtlasRows * tileSize * 4, 0);
+	for (int tile = 0; tile < tileCount; ++tile)
+	{
+		int x = tile % m_AtlasColumns * tileSize;
+		int y = tile / m_AtlasColumns * tileSize;
+		for (int row = 0; row < tileSize; ++row)
+		{
+			const unsigned char* src = pixels + ((size_t)tile * tileSize + row) * tileSize * 4;
+			std::copy(src, src + tileSize * 4, atlas.begin() + ((size_t)(y + row) * atlasWidth + x) * 4);
+		}
+	}
+	CALLGL(glBindTexture(GL_TEXTURE_2D, m_Texture));
+	CALLGL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, atlasWidth, m_AtlasRows * tileSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, atlas.data()));
+	CALLGL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+	CALLGL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+	CALLGL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	CALLGL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	CALLGL(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+void Tilemap::SetTile(int x, int y, unsigned short tile)
+{
+	if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+		return;
+	unsigned short& current = m_Tiles[(size_t)y * m_Width + x];
+	if (current == tile)
+		return;
+
+	Chunk& chunk = m_Chunks[(size_t)(y / m_ChunkSize) * m_ChunksX + x / m_ChunkSize];
+	chunk.tileCount += (current == 0) - (tile == 0);
+	current = tile;
+	MarkDirty(x, y);
+}
+
+void Tilemap::FillRect(int x, int y, int width, int height, unsigned short tile)
+{
+	int x1 = std::min(x + width, m_Width);
+	int y1 = std::min(y + height, m_Height);
+	for (int ty = std::max(y, 0); ty < y1; ++ty)
+		for (int tx = std::max(x, 0); tx < x1; ++tx)
+			SetTile(tx, ty, tile);
+}
+
+void Tilemap::MarkDirty(int x, int y)
+{
+	Chunk& chunk = m_Chunks[(size_t)(y / m_ChunkSize) * m_ChunksX + x / m_ChunkSize];
+	// not built yet, it gets everything once it is
+	if (!chunk.vertexBuffer)
+		return;
+
+	unsigned int index = (y % m_ChunkSize) * m_ChunkSize + x % m_ChunkSize;
+	if (chunk.dirtyBegin == chunk.dirtyEnd)
+	{
+		chunk.dirtyBegin = index;
+		chunk.dirtyEnd = index + 1;
+	}
+	else
+	{
+		chunk.dirtyBegin = std::min(chunk.dirtyBegin, index);
+		chunk.dirtyEnd = std::max(chunk.dirtyEnd, index + 1);
+	}
+}
+
+void Tilemap::Upload(Chunk& chunk, int chunkX, int chunkY, unsigned int begin, unsigned int end)
+{
+	// tiles past the edge of the map stay empty
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		int x = i % m_ChunkSize;
+		int y = i / m_ChunkSize;
+		int mapX = chunkX * m_ChunkSize + x;
+		int mapY = chunkY * m_ChunkSize + y;
+		unsigned short tile = mapX < m_Width && mapY < m_Height ? m_Tiles[(size_t)mapY * m_Width + mapX] : 0;
+
+		TileVertex* corners = &m_Scratch[i * 4];
+		corners[0] = { (unsigned char)x, (unsigned char)y, tile };
+		corners[1] = { (unsigned char)(x + 1), (unsigned char)y, tile };
+		corners[2] = { (unsigned char)(x + 1), (unsigned char)(y + 1), tile };
+		corners[3] = { (unsigned char)x, (unsigned char)(y + 1), tile };
+	}
+
+	unsigned int size = (end - begin) * 4 * sizeof(TileVertex);
+	if (!chunk.vertexBuffer)
+	{
+		chunk.vertexBuffer = std::make_unique<VertexBuffer>(m_Scratch.data(), size);
+		m_ResidentBytes += size;
+		++m_FrameStats.builtChunks;
+	}
+	else
+	{
+		chunk.vertexBuffer->Update(&m_Scratch[begin * 4], size, begin * 4 * sizeof(TileVertex));
+		++m_FrameStats.updatedChunks;
+	}
+	m_FrameStats.uploadedBytes += size;
+	chunk.dirtyBegin = chunk.dirtyEnd = 0;
+}
+
+unsigned int Tilemap::Draw(const Renderer& renderer, Shader& shader, const glm::mat4& viewProjection)
+{
+	m_FrameStats = {};
+
+	// the view rectangle in tiles, from the corners of clip space
+	glm::mat4 inverse = glm::inverse(viewProjection);
+	glm::vec2 viewMin(1e30f), viewMax(-1e30f);
+	for (int i = 0; i < 4; ++i)
+	{
+		glm::vec4 corner = inverse * glm::vec4(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, 0.0f, 1.0f);
+		glm::vec2 p = glm::vec2(corner) / corner.w;
+		viewMin = glm::min(viewMin, p);
+		viewMax = glm::max(viewMax, p);
+	}
+	int firstX = std::max(0, (int)std::floor(viewMin.x / m_ChunkSize));
+	int firstY = std::max(0, (int)std::floor(viewMin.y / m_ChunkSize));
+	int lastX = std::min(m_ChunksX - 1, (int)std::floor(viewMax.x / m_ChunkSize));
+	int lastY = std::min(m_ChunksY - 1, (int)std::floor(viewMax.y / m_ChunkSize));
+	if (firstX > lastX || firstY > lastY)
+		return 0;
+
+	shader.Bind();
+	if (m_Sampling == TileSampling::Array)
+	{
+		CALLGL(glActiveTexture(GL_TEXTURE1));
+		CALLGL(glBindTexture(GL_TEXTURE_2D_ARRAY, m_Texture));
+		// code after this binds without picking a unit first
+		CALLGL(glActiveTexture(GL_TEXTURE0));
+	}
+	else
+	{
+		CALLGL(glActiveTexture(GL_TEXTURE0));
+		CALLGL(glBindTexture(GL_TEXTURE_2D, m_Texture));
+	}
+	GLBackend::CountBinds();
+	shader.SetUniform1i("u_Atlas", 0);
+	shader.SetUniform1i("u_TileArray", 1);
+	shader.SetUniform1i("u_UseArray", m_Sampling == TileSampling::Array);
+	shader.SetUniform1i("u_AtlasColumns", m_AtlasColumns);
+	shader.SetUniform1i("u_AtlasRows", m_AtlasRows);
+
+	unsigned int tiles = m_ChunkSize * m_ChunkSize;
+	for (int cy = firstY; cy <= lastY; ++cy)
+	{
+		for (int cx = firstX; cx <= lastX; ++cx)
+		{
+			++m_FrameStats.visibleChunks;
+			Chunk& chunk = m_Chunks[(size_t)cy * m_ChunksX + cx];
+			if (chunk.tileCount == 0)
+				continue;
+
+			if (!chunk.vertexBuffer)
+			{
+				if (m_BuildBudget && m_FrameStats.builtChunks >= m_BuildBudget)
+					continue;
+				Upload(chunk, cx, cy, 0, tiles);
+			}
+			else if (chunk.dirtyBegin != chunk.dirtyEnd)
+			{
+				Upload(chunk, cx, cy, chunk.dirtyBegin, chunk.dirtyEnd);
+			}
+
+			if (!m_VAO)
+			{
+				m_VAO = std::make_unique<VertexArray>();
+				m_VAO->AddBuffer(*chunk.vertexBuffer, m_Layout);
+			}
+			else
+			{
+				m_VAO->SetBuffer(0, *chunk.vertexBuffer);
+			}
+
+			glm::vec3 origin((float)(cx * m_ChunkSize), (float)(cy * m_ChunkSize), 0.0f);
+			shader.SetUniformMat4f("u_MVP", glm::translate(viewProjection, origin));
+			renderer.Draw(*m_VAO, *m_IndexBuffer, shader);
+			++m_FrameStats.drawnChunks;
+		}
+	}
+	return m_FrameStats.drawnChunks;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "IndexBuffer.h"
+
+// A 2D tile world cut into chunkSize x chunkSize chunks. Every chunk gets a
+// static vertex buffer the first time it's on screen, 4 bytes per corner:
+// its position inside the chunk and the tile. All chunks share one VAO and
+// one 16 bit index buffer, drawing a chunk only swaps the vertex buffer.
+//
+// SetTile only touches the CPU copy and widens the chunk's dirty range,
+// Draw uploads that range (not the whole chunk) once the chunk is visible
+// again. Chunks outside the orthographic view are never looked at, the
+// visible ones come straight from the view rectangle.
+//
+// Tile 0 is empty, tiles 1..n are the n images passed to SetTileSet and
+// come from an atlas or a texture array. Draw with res/shaders/Tilemap.shader,
+// one world unit is one tile.
+class Tilemap
+{
+public:
+	enum class TileSampling
+	{
+		// one big texture, nearest filtering, no mipmaps (they would bleed between tiles)
+		Atlas,
+		// one layer per tile, mipmapped, needs no padding
+		Array,
+	};
+
+	struct FrameStats
+	{
+		unsigned int visibleChunks;
+		unsigned int drawnChunks; // visible and not empty
+		unsigned int builtChunks;
+		unsigned int updatedChunks;
+		unsigned int uploadedBytes;
+	};
+
+private:
+	struct Chunk
+	{
+		std::unique_ptr<VertexBuffer> vertexBuffer;
+		unsigned int tileCount; // not empty
+		// tiles [dirtyBegin, dirtyEnd) in chunk order changed since the last upload
+		unsigned int dirtyBegin, dirtyEnd;
+	};
+
+	struct TileVertex
+	{
+		unsigned char x, y;
+		unsigned short tile;
+	};
+
+	int m_Width, m_Height;
+	int m_ChunkSize;
+	int m_ChunksX, m_ChunksY;
+	std::vector<unsigned short> m_Tiles;
+	std::vector<Chunk> m_Chunks;
+	std::vector<TileVertex> m_Scratch;
+
+	VertexBufferLayout m_Layout;
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+	unsigned int m_Texture;
+	TileSampling m_Sampling;
+	int m_AtlasColumns, m_AtlasRows;
+
+	unsigned int m_BuildBudget;
+	size_t m_ResidentBytes;
+	FrameStats m_FrameStats;
+
+public:
+	// chunkSize up to 127 keeps a chunk within 16 bit indices
+	Tilemap(int width, int height, int chunkSize = 64);
+	~Tilemap();
+
+	// tileCount square tiles of tileSize pixels, RGBA, one after the other
+	void SetTileSet(const unsigned char* pixels, int tileSize, int tileCount, TileSampling sampling);
+
+	unsigned short GetTile(int x, int y) const { return m_Tiles[(size_t)y * m_Width + x]; }
+	void SetTile(int x, int y, unsigned short tile);
+	void FillRect(int x, int y, int width, int height, unsigned short tile);
+
+	// how many chunks Draw builds for the first time per call. the rest stay
+	// blank a few frames, so zooming out doesn't stall. 0 for no limit
+	void SetBuildBudget(unsigned int chunks) { m_BuildBudget = chunks; }
+
+	// returns the number of draw calls
+	unsigned int Draw(const Renderer& renderer, Shader& shader, const glm::mat4& viewProjection);
+
+	int GetWidth() const { return m_Width; }
+	int GetHeight() const { return m_Height; }
+	int GetChunkSize() const { return m_ChunkSize; }
+	unsigned int GetChunkCount() const { return (unsigned int)m_Chunks.size(); }
+	TileSampling GetSampling() const { return m_Sampling; }
+	// vertex buffers of the chunks built so far
+	size_t GetResidentBytes() const { return m_ResidentBytes; }
+	const FrameStats& GetFrameStats() const { return m_FrameStats; }
+
+private:
+	void MarkDirty(int x, int y);
+	void Upload(Chunk& chunk, int chunkX, int chunkY, unsigned int begin, unsigned int end);
+};
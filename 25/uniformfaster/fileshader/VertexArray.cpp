@@ -1,13 +1,23 @@
+#include <algorithm>
 
 #include "VertexArray.h"
 #include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
 #include "Renderer.h"
+#include "GLBackend.h"
 
-VertexArray::VertexArray() 
+VertexArray::VertexArray() :
+    m_AttribCount(0),
+    m_DSA(GLBackend::UseDSA())
 {
+    if (m_DSA)
+    {
+        CALLGL(glCreateVertexArrays(1, &m_RendererID));
+        GLBackend::CountSavedBinds();
+        return;
+    }
     CALLGL(glGenVertexArrays(1, &m_RendererID));
-    CALLGL(glBindVertexArray(m_RendererID));
+    Bind();
 }
 
 VertexArray::~VertexArray()
@@ -15,38 +25,184 @@ VertexArray::~VertexArray()
     CALLGL(glDeleteVertexArrays(1, &m_RendererID));
 }
 
-void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
+bool VertexArray::HasAttribBinding()
+{
+    return GLEW_VERSION_4_3 || GLEW_ARB_vertex_attrib_binding;
+}
+
+unsigned int VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
+{
+    return AddBuffer(vb, layout, m_AttribCount);
+}
+
+unsigned int VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int attribBase)
 {
-    Bind();
-	vb.Bind();
     const auto& elements = layout.GetElements();
-    unsigned int offset = 0;
-    for (unsigned int i = 0; i < elements.size(); ++i)
+    return AddBuffer(vb, elements.data(), (unsigned int)elements.size(), layout.GetStride(), attribBase);
+}
+
+unsigned int VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferElement* elements, unsigned int count, unsigned int stride)
+{
+    return AddBuffer(vb, elements, count, stride, m_AttribCount);
+}
+
+unsigned int VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferElement* elements, unsigned int count, unsigned int stride, unsigned int attribBase)
+{
+    unsigned int binding = (unsigned int)m_Streams.size();
+    m_CheckedPrograms.clear();
+    m_Streams.push_back({ std::vector<VertexBufferElement>(elements, elements + count), attribBase, stride });
+    if (attribBase + count > m_AttribCount)
+        m_AttribCount = attribBase + count;
+
+    if (m_DSA)
     {
-        const auto& element = elements[i];
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const auto& element = elements[i];
+            unsigned int attrib = attribBase + i;
+            CALLGL(glEnableVertexArrayAttrib(m_RendererID, attrib));
+            if (element.integer)
+                CALLGL(glVertexArrayAttribIFormat(m_RendererID, attrib, element.count, element.type, element.offset));
+            else
+                CALLGL(glVertexArrayAttribFormat(m_RendererID, attrib, element.count, element.type, element.normalized, element.offset));
+            CALLGL(glVertexArrayAttribBinding(m_RendererID, attrib, binding));
+        }
+        CALLGL(glVertexArrayVertexBuffer(m_RendererID, binding, vb.GetRendererID(), 0, stride));
+        GLBackend::CountSavedBinds();
+        return binding;
+    }
 
+    Bind();
+    for (unsigned int i = 0; i < count; ++i)
+    {
         // Enable attribute0
-        CALLGL(glEnableVertexAttribArray(i)); // first attribute
+        CALLGL(glEnableVertexAttribArray(attribBase + i)); // first attribute
+    }
+
+    if (HasAttribBinding())
+    {
+        // the format is set once, buffers are swapped with glBindVertexBuffer
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const auto& element = elements[i];
+            unsigned int attrib = attribBase + i;
+            if (element.integer)
+                CALLGL(glVertexAttribIFormat(attrib, element.count, element.type, element.offset));
+            else
+                CALLGL(glVertexAttribFormat(attrib, element.count, element.type, element.normalized, element.offset));
+            CALLGL(glVertexAttribBinding(attrib, binding));
+        }
+        CALLGL(glBindVertexBuffer(binding, vb.GetRendererID(), 0, stride));
+    }
+    else
+    {
+        vb.Bind();
+        SetAttribPointers(m_Streams.back(), 0);
+    }
+    return binding;
+}
+
+const VertexBufferElement* VertexArray::GetAttribute(unsigned int location) const
+{
+    for (const Stream& stream : m_Streams)
+    {
+        if (location >= stream.attribBase && location < stream.attribBase + stream.elements.size())
+            return &stream.elements[location - stream.attribBase];
+    }
+    return nullptr;
+}
+
+bool VertexArray::NeedsInputCheck(unsigned int program) const
+{
+    if (std::find(m_CheckedPrograms.begin(), m_CheckedPrograms.end(), program) != m_CheckedPrograms.end())
+        return false;
+    m_CheckedPrograms.push_back(program);
+    return true;
+}
+
+void VertexArray::SetBuffer(unsigned int binding, const VertexBuffer& vb, unsigned int offset)
+{
+    ASSERT_GL(binding < m_Streams.size());
+    if (m_DSA)
+    {
+        CALLGL(glVertexArrayVertexBuffer(m_RendererID, binding, vb.GetRendererID(), offset, m_Streams[binding].stride));
+        GLBackend::CountSavedBinds();
+        return;
+    }
+    Bind();
+    if (HasAttribBinding())
+    {
+        CALLGL(glBindVertexBuffer(binding, vb.GetRendererID(), offset, m_Streams[binding].stride));
+    }
+    else
+    {
+        // 3.3 keeps the buffer per attribute, all of them have to be set again
+        vb.Bind();
+        SetAttribPointers(m_Streams[binding], offset);
+    }
+}
+
+void VertexArray::SetDivisor(unsigned int binding, unsigned int divisor)
+{
+    ASSERT_GL(binding < m_Streams.size());
+    if (m_DSA)
+    {
+        CALLGL(glVertexArrayBindingDivisor(m_RendererID, binding, divisor));
+        return;
+    }
+    Bind();
+    if (HasAttribBinding())
+    {
+        CALLGL(glVertexBindingDivisor(binding, divisor));
+    }
+    else
+    {
+        // per attribute on 3.3, the pointers keep it when SetBuffer changes them
+        const Stream& stream = m_Streams[binding];
+        for (unsigned int i = 0; i < stream.elements.size(); ++i)
+            CALLGL(glVertexAttribDivisor(stream.attribBase + i, divisor));
+    }
+}
+
+void VertexArray::SetAttribPointers(const Stream& stream, unsigned int offset)
+{
+    for (unsigned int i = 0; i < stream.elements.size(); ++i)
+    {
+        const auto& element = stream.elements[i];
 
         // Layout the buffer
         // set attribute0 , decides the composition of memory(positions)
-        CALLGL(glVertexAttribPointer(
-            i, // first attribute
-            element.count, // count of point in a vertex(position)
-            element.type,
-            element.normalized, // not normalize
-            layout.GetStride(), // sizeof(float) * 2, // stride, byte size of 2 vertexes
-            (const void*)offset  // offset
-        ));
-        offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+        if (element.integer)
+        {
+            // no conversion, the shader reads int/uint
+            CALLGL(glVertexAttribIPointer(
+                stream.attribBase + i,
+                element.count,
+                element.type,
+                stream.stride,
+                (const void*)(size_t)(offset + element.offset)
+            ));
+        }
+        else
+        {
+            CALLGL(glVertexAttribPointer(
+                stream.attribBase + i, // first attribute
+                element.count, // count of point in a vertex(position)
+                element.type,
+                element.normalized, // not normalize
+                stream.stride, // sizeof(float) * 2, // stride, byte size of 2 vertexes
+                (const void*)(size_t)(offset + element.offset)  // offset
+            ));
+        }
     }
 }
 
 void VertexArray::Bind() const
 {
     CALLGL(glBindVertexArray(m_RendererID));
+    GLBackend::CountBinds();
 }
 void VertexArray::Unbind() const
 {
     CALLGL(glBindVertexArray(0));
-}
\ No newline at end of file
+}
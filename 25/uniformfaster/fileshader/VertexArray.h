@@ -1,18 +1,81 @@
 #pragma once
 
+#include <vector>
+
 #include "VertexBuffer.h"
 
 class VertexBufferLayout;
+struct VertexBufferElement;
+template<typename Vertex> struct VertexLayout;
 
+// A VAO fed by one or more vertex buffers (streams). Each AddBuffer attaches
+// a buffer with its own layout, e.g. static positions in one buffer and
+// colors rewritten every frame in another, and returns the binding index
+// of that stream. SetBuffer swaps the buffer of a stream without
+// re-specifying its formats when ARB_vertex_attrib_binding is available.
 class VertexArray {
 private:
+	struct Stream
+	{
+		std::vector<VertexBufferElement> elements;
+		unsigned int attribBase;
+		unsigned int stride;
+	};
+
 	unsigned int m_RendererID;
+	std::vector<Stream> m_Streams;
+	// first attribute the next AddBuffer without attribBase uses
+	unsigned int m_AttribCount;
+	// created with glCreateVertexArrays, edited through glVertexArray*
+	bool m_DSA;
+	// programs Renderer::Draw compared the attributes with
+	mutable std::vector<unsigned int> m_CheckedPrograms;
 public:
 	VertexArray();
 	~VertexArray();
 
-	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+	// attributes continue after the ones already added, 0 for the first buffer
+	unsigned int AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+	unsigned int AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int attribBase);
+	unsigned int AddBuffer(const VertexBuffer& vb, const VertexBufferElement* elements, unsigned int count, unsigned int stride);
+	unsigned int AddBuffer(const VertexBuffer& vb, const VertexBufferElement* elements, unsigned int count, unsigned int stride, unsigned int attribBase);
+
+	// layout comes from VERTEX_LAYOUT(Vertex, ...), a constant table
+	template<typename Vertex>
+	unsigned int AddBuffer(const VertexBuffer& vb)
+	{
+		return AddBuffer(vb, VertexLayout<Vertex>::Elements, VertexLayout<Vertex>::Count, VertexLayout<Vertex>::Stride);
+	}
+	template<typename Vertex>
+	unsigned int AddBuffer(const VertexBuffer& vb, unsigned int attribBase)
+	{
+		return AddBuffer(vb, VertexLayout<Vertex>::Elements, VertexLayout<Vertex>::Count, VertexLayout<Vertex>::Stride, attribBase);
+	}
+
+	// feeds stream binding from another buffer with the same layout,
+	// offset is in bytes from the start of vb
+	void SetBuffer(unsigned int binding, const VertexBuffer& vb, unsigned int offset = 0);
+	// the stream advances once per divisor instances instead of every vertex,
+	// 0 goes back to per vertex. instanced draws start at their base instance
+	void SetDivisor(unsigned int binding, unsigned int divisor);
+
+	unsigned int GetStreamCount() const { return (unsigned int)m_Streams.size(); }
+	// one past the highest attribute location in use
+	unsigned int GetAttribCount() const { return m_AttribCount; }
+	// the format of an attribute, null when location isn't enabled
+	const VertexBufferElement* GetAttribute(unsigned int location) const;
+
+	// true the first time it's asked about a program since the last
+	// AddBuffer, debug builds check the inputs then
+	bool NeedsInputCheck(unsigned int program) const;
 
 	void Bind() const;
 	void Unbind() const;
-};
\ No newline at end of file
+
+	// glVertexAttribFormat/glBindVertexBuffer instead of glVertexAttribPointer,
+	// the DSA path always has it
+	static bool HasAttribBinding();
+
+private:
+	void SetAttribPointers(const Stream& stream, unsigned int offset);
+};
@@ -1,26 +1,76 @@
-
 #include "Renderer.h"
 #include "VertexBuffer.h"
+#include "GLBackend.h"
 
-VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+VertexBuffer::VertexBuffer(const void* data, unsigned int size, unsigned int usage) :
+    m_RenderID(0),
+    m_Size(size),
+    m_Usage(usage),
+    m_Immutable(false)
 {
+    if (GLBackend::UseDSA())
+    {
+        CALLGL(glCreateBuffers(1, &m_RenderID));
+        if (usage == GL_STATIC_DRAW)
+        {
+            // Update still works through glNamedBufferSubData
+            m_Immutable = true;
+            CALLGL(glNamedBufferStorage(m_RenderID, size, data, GL_DYNAMIC_STORAGE_BIT));
+        }
+        else
+        {
+            CALLGL(glNamedBufferData(m_RenderID, size, data, usage));
+        }
+        GLBackend::CountSavedBinds();
+        return;
+    }
+
     CALLGL(glGenBuffers(1, &m_RenderID));
     CALLGL(glBindBuffer(GL_ARRAY_BUFFER, m_RenderID));
+    GLBackend::CountBinds();
     CALLGL(glBufferData(GL_ARRAY_BUFFER,
         size, //_countof(positions) * sizeof(float),  // 6 * 2 * sizeof(float)
         data,
-        GL_STATIC_DRAW));
+        usage));
 }
 VertexBuffer::~VertexBuffer()
 {
     CALLGL(glDeleteBuffers(1, &m_RenderID));
 }
 
+void VertexBuffer::Update(const void* data, unsigned int size, unsigned int offset)
+{
+    ASSERT_GL(offset + size <= m_Size);
+    bool orphan = offset == 0 && size == m_Size && !m_Immutable;
+    if (GLBackend::UseDSA())
+    {
+        if (orphan)
+            CALLGL(glNamedBufferData(m_RenderID, m_Size, nullptr, m_Usage));
+        CALLGL(glNamedBufferSubData(m_RenderID, offset, size, data));
+        GLBackend::CountSavedBinds();
+        return;
+    }
+
+    Bind();
+    if (orphan)
+    {
+        CALLGL(glBufferData(GL_ARRAY_BUFFER, m_Size, nullptr, m_Usage));
+    }
+    CALLGL(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
+
 void VertexBuffer::Bind() const
 {
     CALLGL(glBindBuffer(GL_ARRAY_BUFFER, m_RenderID));
+    GLBackend::CountBinds();
 }
 void VertexBuffer::Unbind() const
 {
     CALLGL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-}
\ No newline at end of file
+}
+
+void VertexBuffer::BindBase(unsigned int index) const
+{
+    CALLGL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, m_RenderID));
+    GLBackend::CountBinds();
+}
@@ -1,12 +1,30 @@
 #pragma once
 
+#include <GL/glew.h>
+
 class VertexBuffer {
 private:
 	unsigned int m_RenderID;
+	unsigned int m_Size;
+	unsigned int m_Usage;
+	// GL_STATIC_DRAW buffers made with DSA get immutable storage, never orphaned
+	bool m_Immutable;
 public:
-	VertexBuffer(const void* data, unsigned int size);
+	// usage is GL_STATIC_DRAW for data uploaded once,
+	// GL_DYNAMIC_DRAW or GL_STREAM_DRAW for data rewritten every frame
+	VertexBuffer(const void* data, unsigned int size, unsigned int usage = GL_STATIC_DRAW);
 	~VertexBuffer();
 
+	// rewrites size bytes at offset. a full rewrite orphans the old storage
+	// so the driver doesn't wait for draws still reading it
+	void Update(const void* data, unsigned int size, unsigned int offset = 0);
+
 	void Bind() const;
 	void Unbind() const;
-};
\ No newline at end of file
+	// as layout(std430, binding = index) buffer, for compute shaders writing
+	// vertices. Renderer::Barrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT) before drawing
+	void BindBase(unsigned int index) const;
+
+	unsigned int GetRendererID() const { return m_RenderID; }
+	unsigned int GetSize() const { return m_Size; }
+};
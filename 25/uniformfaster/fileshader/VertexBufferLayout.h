@@ -1,26 +1,46 @@
 #pragma once
+#include <cstddef>
 #include <vector>
 
 #include <GL/glew.h>
 #include "Renderer.h"
 
+#include "glm/glm.hpp"
+
+#include "VertexPacking.h"
+
 struct VertexBufferElement
 {
 	unsigned int type;
 	unsigned int count;
 	unsigned char normalized;
+	unsigned int offset;
+	// read with glVertexAttribIPointer, the shader gets ints instead of floats
+	unsigned char integer;
 
-	static unsigned int GetSizeOfType(unsigned int type)
+	static constexpr unsigned int GetSizeOfType(unsigned int type)
 	{
 		switch (type)
 		{
 		case GL_FLOAT:return 4;
 		case GL_UNSIGNED_INT:return 4;
+		case GL_INT:return 4;
+		case GL_HALF_FLOAT:return 2;
+		case GL_SHORT:return 2;
+		case GL_UNSIGNED_SHORT:return 2;
+		case GL_BYTE:return 1;
 		case GL_UNSIGNED_BYTE:return 1;
+		// all 4 components in one
+		case GL_INT_2_10_10_10_REV:return 4;
 		}
 		ASSERT_GL(false);
 		return 0;
 	}
+
+	constexpr unsigned int GetSize() const
+	{
+		return type == GL_INT_2_10_10_10_REV ? 4 : count * GetSizeOfType(type);
+	}
 };
 
 class VertexBufferLayout {
@@ -33,36 +53,197 @@ public:
 		m_Stride(0) {}
 
 	template<typename T>
-	void Push(unsigned int count)
-	{
-		static_assert(false);
-	}
+	void Push(unsigned int count);
 
-	template<>
-	void Push<float>(unsigned int count)
-	{
-		m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
-	}
-
-	template<>
-	void Push<unsigned int>(unsigned int count)
-	{
-		m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
-	}
-	template<>
+	// integer attributes the shader reads as int/uint (ivec, uvec),
+	// Push<unsigned int> on the other hand converts to float
+	template<typename T>
+	void PushInteger(unsigned int count);
 
-	void Push<unsigned char>(unsigned int count)
+private:
+	void Push(const VertexBufferElement& element)
 	{
-		m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+		m_Elements.push_back(element);
+		m_Elements.back().offset = m_Stride;
+		m_Stride += element.GetSize();
 	}
 
+public:
 	const std::vector<VertexBufferElement>& GetElements() const {
 		return m_Elements;
 	}
 	unsigned int GetStride() const {
 		return m_Stride;
 	}
-};
\ No newline at end of file
+};
+
+// explicit specializations have to live at namespace scope,
+// only MSVC accepts them inside the class
+template<>
+inline void VertexBufferLayout::Push<float>(unsigned int count)
+{
+	Push({ GL_FLOAT, count, GL_FALSE, 0, GL_FALSE });
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int count)
+{
+	Push({ GL_UNSIGNED_INT, count, GL_FALSE, 0, GL_FALSE });
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int count)
+{
+	Push({ GL_UNSIGNED_BYTE, count, GL_TRUE, 0, GL_FALSE });
+}
+
+template<>
+inline void VertexBufferLayout::Push<Half>(unsigned int count)
+{
+	Push({ GL_HALF_FLOAT, count, GL_FALSE, 0, GL_FALSE });
+}
+
+// 16 bit values are normalized, -32767..32767 -> -1..1 and 0..65535 -> 0..1
+template<>
+inline void VertexBufferLayout::Push<short>(unsigned int count)
+{
+	Push({ GL_SHORT, count, GL_TRUE, 0, GL_FALSE });
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned short>(unsigned int count)
+{
+	Push({ GL_UNSIGNED_SHORT, count, GL_TRUE, 0, GL_FALSE });
+}
+
+// count is the number of components the shader reads, 3 or 4
+template<>
+inline void VertexBufferLayout::Push<PackedNormal>(unsigned int count)
+{
+	ASSERT_GL(count == 3 || count == 4);
+	Push({ GL_INT_2_10_10_10_REV, 4, GL_TRUE, 0, GL_FALSE });
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<int>(unsigned int count)
+{
+	Push({ GL_INT, count, GL_FALSE, 0, GL_TRUE });
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<unsigned int>(unsigned int count)
+{
+	Push({ GL_UNSIGNED_INT, count, GL_FALSE, 0, GL_TRUE });
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<unsigned short>(unsigned int count)
+{
+	Push({ GL_UNSIGNED_SHORT, count, GL_FALSE, 0, GL_TRUE });
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<unsigned char>(unsigned int count)
+{
+	Push({ GL_UNSIGNED_BYTE, count, GL_FALSE, 0, GL_TRUE });
+}
+
+// Compile time layouts
+//
+// Describe a vertex struct once and the layout (type, count, normalization
+// and offset of every member) is a constant table:
+//
+//   struct SpriteVertex { glm::vec2 position; glm::vec2 texCoord; float blend; };
+//   VERTEX_LAYOUT(SpriteVertex,
+//       VERTEX_ATTRIB(position),
+//       VERTEX_ATTRIB(texCoord),
+//       VERTEX_ATTRIB(blend));
+//
+//   va.AddBuffer<SpriteVertex>(vb);
+//
+// Members have to be listed in order and cover the whole struct, a member
+// that is missing, listed twice or of an unsupported type fails to compile.
+
+template<typename T>
+struct VertexAttribTraits
+{
+	static_assert(sizeof(T) == 0, "unsupported vertex attribute type");
+};
+
+#define VERTEX_ATTRIB_TRAITS(T, glType, n, norm, isInteger)           \
+template<> struct VertexAttribTraits<T>                               \
+{                                                                     \
+	static constexpr unsigned int Type = glType;                      \
+	static constexpr unsigned int Count = n;                          \
+	static constexpr unsigned char Normalized = norm;                 \
+	static constexpr unsigned char Integer = isInteger;               \
+}
+
+VERTEX_ATTRIB_TRAITS(float, GL_FLOAT, 1, GL_FALSE, GL_FALSE);
+VERTEX_ATTRIB_TRAITS(glm::vec2, GL_FLOAT, 2, GL_FALSE, GL_FALSE);
+VERTEX_ATTRIB_TRAITS(glm::vec3, GL_FLOAT, 3, GL_FALSE, GL_FALSE);
+VERTEX_ATTRIB_TRAITS(glm::vec4, GL_FLOAT, 4, GL_FALSE, GL_FALSE);
+// ints stay ints in the shader (uint, uvec2, ivec3, ...)
+VERTEX_ATTRIB_TRAITS(unsigned int, GL_UNSIGNED_INT, 1, GL_FALSE, GL_TRUE);
+VERTEX_ATTRIB_TRAITS(glm::uvec2, GL_UNSIGNED_INT, 2, GL_FALSE, GL_TRUE);
+VERTEX_ATTRIB_TRAITS(glm::uvec3, GL_UNSIGNED_INT, 3, GL_FALSE, GL_TRUE);
+VERTEX_ATTRIB_TRAITS(glm::uvec4, GL_UNSIGNED_INT, 4, GL_FALSE, GL_TRUE);
+VERTEX_ATTRIB_TRAITS(int, GL_INT, 1, GL_FALSE, GL_TRUE);
+VERTEX_ATTRIB_TRAITS(glm::ivec2, GL_INT, 2, GL_FALSE, GL_TRUE);
+VERTEX_ATTRIB_TRAITS(glm::ivec3, GL_INT, 3, GL_FALSE, GL_TRUE);
+VERTEX_ATTRIB_TRAITS(glm::ivec4, GL_INT, 4, GL_FALSE, GL_TRUE);
+// bytes are colors, same as Push<unsigned char>
+VERTEX_ATTRIB_TRAITS(glm::u8vec4, GL_UNSIGNED_BYTE, 4, GL_TRUE, GL_FALSE);
+// reduced precision, floats in the shader
+VERTEX_ATTRIB_TRAITS(Half2, GL_HALF_FLOAT, 2, GL_FALSE, GL_FALSE);
+VERTEX_ATTRIB_TRAITS(Half4, GL_HALF_FLOAT, 4, GL_FALSE, GL_FALSE);
+VERTEX_ATTRIB_TRAITS(glm::i16vec2, GL_SHORT, 2, GL_TRUE, GL_FALSE);
+VERTEX_ATTRIB_TRAITS(glm::i16vec4, GL_SHORT, 4, GL_TRUE, GL_FALSE);
+VERTEX_ATTRIB_TRAITS(glm::u16vec2, GL_UNSIGNED_SHORT, 2, GL_TRUE, GL_FALSE);
+VERTEX_ATTRIB_TRAITS(glm::u16vec4, GL_UNSIGNED_SHORT, 4, GL_TRUE, GL_FALSE);
+VERTEX_ATTRIB_TRAITS(PackedNormal, GL_INT_2_10_10_10_REV, 4, GL_TRUE, GL_FALSE);
+
+template<typename T>
+constexpr VertexBufferElement MakeVertexElement(size_t offset)
+{
+	using Traits = VertexAttribTraits<T>;
+	static_assert(sizeof(T) == VertexBufferElement{ Traits::Type, Traits::Count, Traits::Normalized, 0, Traits::Integer }.GetSize(), "vertex attribute size mismatch");
+	return { Traits::Type, Traits::Count, Traits::Normalized, (unsigned int)offset, Traits::Integer };
+}
+
+// elements ordered, not overlapping and adding up to the whole vertex
+template<size_t N>
+constexpr bool IsCompleteVertexLayout(const VertexBufferElement (&elements)[N], size_t vertexSize)
+{
+	size_t end = 0;
+	for (size_t i = 0; i < N; ++i)
+	{
+		if (elements[i].offset < end)
+			return false;
+		end = elements[i].offset + elements[i].GetSize();
+	}
+	size_t total = 0;
+	for (size_t i = 0; i < N; ++i)
+		total += elements[i].GetSize();
+	return end == vertexSize && total == vertexSize;
+}
+
+template<typename Vertex>
+struct VertexLayout
+{
+	static_assert(sizeof(Vertex) == 0, "no VERTEX_LAYOUT for this vertex type");
+};
+
+#define VERTEX_ATTRIB(member) \
+	MakeVertexElement<decltype(VertexType::member)>(offsetof(VertexType, member))
+
+#define VERTEX_LAYOUT(Vertex, ...)                                                           \
+template<> struct VertexLayout<Vertex>                                                       \
+{                                                                                            \
+	using VertexType = Vertex;                                                               \
+	static constexpr VertexBufferElement Elements[] = { __VA_ARGS__ };                       \
+	static constexpr unsigned int Count = sizeof(Elements) / sizeof(Elements[0]);            \
+	static constexpr unsigned int Stride = sizeof(Vertex);                                   \
+};                                                                                           \
+static_assert(IsCompleteVertexLayout(VertexLayout<Vertex>::Elements, sizeof(Vertex)),      \
+	"VERTEX_LAYOUT(" #Vertex ") does not match the members of the struct")
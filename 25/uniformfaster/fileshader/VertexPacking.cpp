@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cmath>
+
+#include "VertexPacking.h"
+
+#include "glm/gtc/packing.hpp"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define VERTEXPACKING_USE_SSE2
+#endif
+
+namespace VertexPacking {
+
+#ifdef VERTEXPACKING_USE_SSE2
+	// 4 floats to 4 halves in the low 16 bits of each lane.
+	// rebias the exponent with a multiply and take the top bits, values
+	// out of range become infinity, NaN stays NaN
+	static inline __m128i FloatToHalf4(__m128 f)
+	{
+		const __m128i signMask = _mm_set1_epi32((int)0x80000000u);
+		const __m128i roundMask = _mm_set1_epi32(~0xfff);
+		const __m128i f32Infinity = _mm_set1_epi32(255 << 23);
+		const __m128i magic = _mm_set1_epi32(15 << 23);
+		const __m128i nanBit = _mm_set1_epi32(0x200);
+		const __m128i f16Infinity = _mm_set1_epi32(0x7c00);
+		const __m128i clamp = _mm_set1_epi32((31 << 23) - 0x1000);
+
+		__m128 sign = _mm_and_ps(_mm_castsi128_ps(signMask), f);
+		__m128 absf = _mm_xor_ps(f, sign);
+		__m128i absInt = _mm_castps_si128(absf);
+		__m128i isNan = _mm_cmpgt_epi32(absInt, f32Infinity);
+		__m128i isNormal = _mm_cmpgt_epi32(f32Infinity, absInt);
+		__m128i infOrNan = _mm_or_si128(_mm_and_si128(isNan, nanBit), f16Infinity);
+
+		__m128 truncated = _mm_and_ps(absf, _mm_castsi128_ps(roundMask));
+		__m128 scaled = _mm_mul_ps(truncated, _mm_castsi128_ps(magic));
+		__m128 clamped = _mm_min_ps(scaled, _mm_castsi128_ps(clamp));
+		__m128i biased = _mm_sub_epi32(_mm_castps_si128(clamped), roundMask);
+		__m128i normal = _mm_and_si128(_mm_srli_epi32(biased, 13), isNormal);
+		__m128i joined = _mm_or_si128(normal, _mm_andnot_si128(isNormal, infOrNan));
+		return _mm_or_si128(joined, _mm_srli_epi32(_mm_castps_si128(sign), 16));
+	}
+
+	// 8 32 bit lanes to 8 unsigned 16 bit values, SSE2 only has the signed pack
+	static inline __m128i PackUnsigned16(__m128i lo, __m128i hi)
+	{
+		const __m128i bias = _mm_set1_epi32(0x8000);
+		__m128i packed = _mm_packs_epi32(_mm_sub_epi32(lo, bias), _mm_sub_epi32(hi, bias));
+		return _mm_xor_si128(packed, _mm_set1_epi16((short)0x8000));
+	}
+#endif
+
+	void PackHalf(const float* src, Half* dst, unsigned int count)
+	{
+		unsigned int i = 0;
+#ifdef VERTEXPACKING_USE_SSE2
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i lo = FloatToHalf4(_mm_loadu_ps(src + i));
+			__m128i hi = FloatToHalf4(_mm_loadu_ps(src + i + 4));
+			_mm_storeu_si128((__m128i*)(dst + i), PackUnsigned16(lo, hi));
+		}
+#endif
+		for (; i < count; ++i)
+			dst[i].bits = glm::packHalf1x16(src[i]);
+	}
+
+	void PackSnorm16(const float* src, short* dst, unsigned int count)
+	{
+		unsigned int i = 0;
+#ifdef VERTEXPACKING_USE_SSE2
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 minusOne = _mm_set1_ps(-1.0f);
+		const __m128 scale = _mm_set1_ps(32767.0f);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), minusOne), one);
+			__m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), minusOne), one);
+			// cvtps rounds to nearest
+			__m128i ia = _mm_cvtps_epi32(_mm_mul_ps(a, scale));
+			__m128i ib = _mm_cvtps_epi32(_mm_mul_ps(b, scale));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(ia, ib));
+		}
+#endif
+		for (; i < count; ++i)
+			dst[i] = (short)std::lround(std::min(std::max(src[i], -1.0f), 1.0f) * 32767.0f);
+	}
+
+	void PackUnorm16(const float* src, unsigned short* dst, unsigned int count)
+	{
+		unsigned int i = 0;
+#ifdef VERTEXPACKING_USE_SSE2
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 scale = _mm_set1_ps(65535.0f);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), zero), one);
+			__m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), zero), one);
+			__m128i ia = _mm_cvtps_epi32(_mm_mul_ps(a, scale));
+			__m128i ib = _mm_cvtps_epi32(_mm_mul_ps(b, scale));
+			_mm_storeu_si128((__m128i*)(dst + i), PackUnsigned16(ia, ib));
+		}
+#endif
+		for (; i < count; ++i)
+			dst[i] = (unsigned short)std::lround(std::min(std::max(src[i], 0.0f), 1.0f) * 65535.0f);
+	}
+
+	void PackNormals(const glm::vec3* src, PackedNormal* dst, unsigned int count)
+	{
+		unsigned int i = 0;
+#ifdef VERTEXPACKING_USE_SSE2
+		// 4 normals are 3 registers of xyzx yzxy zxyz, shuffled into one
+		// register per component so each lane packs a whole normal
+		static_assert(sizeof(glm::vec3) == 12, "normals have to be tightly packed");
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 minusOne = _mm_set1_ps(-1.0f);
+		const __m128 scale = _mm_set1_ps(511.0f);
+		const __m128i mask = _mm_set1_epi32(0x3ff);
+		for (; i + 4 <= count; i += 4)
+		{
+			const float* f = &src[i].x;
+			__m128 a = _mm_loadu_ps(f);
+			__m128 b = _mm_loadu_ps(f + 4);
+			__m128 c = _mm_loadu_ps(f + 8);
+			__m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+			__m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+			__m128i qx = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(x, minusOne), one), scale)), mask);
+			__m128i qy = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(y, minusOne), one), scale)), mask);
+			__m128i qz = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(z, minusOne), one), scale)), mask);
+			__m128i bits = _mm_or_si128(qx, _mm_or_si128(_mm_slli_epi32(qy, 10), _mm_slli_epi32(qz, 20)));
+			_mm_storeu_si128((__m128i*)(dst + i), bits);
+		}
+#endif
+		for (; i < count; ++i)
+			dst[i].bits = glm::packSnorm3x10_1x2(glm::vec4(src[i], 0.0f));
+	}
+
+	float UnpackHalf(Half h)
+	{
+		return glm::unpackHalf1x16(h.bits);
+	}
+
+} // namespace VertexPacking
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+// Reduced precision vertex attribute types, usable with Push<T>() and in
+// VERTEX_LAYOUT structs. All of them reach the shader as floats.
+
+// IEEE half float, GL_HALF_FLOAT
+struct Half
+{
+	unsigned short bits;
+};
+struct Half2
+{
+	Half x, y;
+};
+struct Half4
+{
+	Half x, y, z, w;
+};
+
+// signed normalized xyz in 10 bits each, w in 2 bits, GL_INT_2_10_10_10_REV.
+// shaders read it as a vec3/vec4 in [-1, 1], made for normals and tangents
+struct PackedNormal
+{
+	unsigned int bits;
+};
+
+// CPU side converters for filling vertex buffers, SSE2 when available.
+// dst and src don't have to be aligned
+namespace VertexPacking {
+
+	void PackHalf(const float* src, Half* dst, unsigned int count);
+	// round(clamp(v, -1, 1) * 32767)
+	void PackSnorm16(const float* src, short* dst, unsigned int count);
+	// round(clamp(v, 0, 1) * 65535)
+	void PackUnorm16(const float* src, unsigned short* dst, unsigned int count);
+	// w is 0
+	void PackNormals(const glm::vec3* src, PackedNormal* dst, unsigned int count);
+
+	float UnpackHalf(Half h);
+
+} // namespace VertexPacking
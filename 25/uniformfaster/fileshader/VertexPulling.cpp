@@ -0,0 +1,123 @@
+#include <iostream>
+
+#include "VertexPulling.h"
+#include "GLBackend.h"
+
+PullBuffer::PullBuffer(const void* data, unsigned int size, unsigned int format, bool storage) :
+	m_RenderID(0),
+	m_Texture(0),
+	m_Size(size),
+	m_Storage(storage)
+{
+	unsigned int target = storage ? GL_SHADER_STORAGE_BUFFER : GL_TEXTURE_BUFFER;
+	if (GLBackend::UseDSA())
+	{
+		CALLGL(glCreateBuffers(1, &m_RenderID));
+		CALLGL(glNamedBufferData(m_RenderID, size, data, GL_STATIC_DRAW));
+		if (!storage)
+		{
+			CALLGL(glCreateTextures(GL_TEXTURE_BUFFER, 1, &m_Texture));
+			CALLGL(glTextureBuffer(m_Texture, format, m_RenderID));
+		}
+		GLBackend::CountSavedBinds();
+		return;
+	}
+
+	CALLGL(glGenBuffers(1, &m_RenderID));
+	CALLGL(glBindBuffer(target, m_RenderID));
+	CALLGL(glBufferData(target, size, data, GL_STATIC_DRAW));
+	GLBackend::CountBinds();
+	if (!storage)
+	{
+		CALLGL(glGenTextures(1, &m_Texture));
+		CALLGL(glBindTexture(GL_TEXTURE_BUFFER, m_Texture));
+		CALLGL(glTexBuffer(GL_TEXTURE_BUFFER, format, m_RenderID));
+		CALLGL(glBindTexture(GL_TEXTURE_BUFFER, 0));
+		GLBackend::CountBinds();
+	}
+}
+PullBuffer::~PullBuffer()
+{
+	if (m_Texture)
+		CALLGL(glDeleteTextures(1, &m_Texture));
+	CALLGL(glDeleteBuffers(1, &m_RenderID));
+}
+
+void PullBuffer::Update(const void* data, unsigned int size, unsigned int offset)
+{
+	ASSERT_GL(offset + size <= m_Size);
+	if (GLBackend::UseDSA())
+	{
+		CALLGL(glNamedBufferSubData(m_RenderID, offset, size, data));
+		GLBackend::CountSavedBinds();
+		return;
+	}
+	unsigned int target = m_Storage ? GL_SHADER_STORAGE_BUFFER : GL_TEXTURE_BUFFER;
+	CALLGL(glBindBuffer(target, m_RenderID));
+	CALLGL(glBufferSubData(target, offset, size, data));
+	GLBackend::CountBinds();
+}
+
+void PullBuffer::Bind(unsigned int slot) const
+{
+	if (m_Storage)
+	{
+		CALLGL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, slot, m_RenderID));
+	}
+	else
+	{
+		CALLGL(glActiveTexture(GL_TEXTURE0 + slot));
+		CALLGL(glBindTexture(GL_TEXTURE_BUFFER, m_Texture));
+	}
+	GLBackend::CountBinds();
+}
+
+unsigned int PullBuffer::GetMaxTextureBufferTexels()
+{
+	int texels = 0;
+	CALLGL(glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &texels));
+	return (unsigned int)texels;
+}
+
+PulledGeometry::PulledGeometry()
+{
+}
+
+PulledGeometry::~PulledGeometry()
+{
+}
+
+unsigned int PulledGeometry::AddMesh(const Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+	ASSERT_GL(!m_VAO);
+	unsigned int firstVertex = (unsigned int)m_Vertices.size();
+	m_Meshes.push_back({ (unsigned int)m_Indices.size(), indexCount });
+	m_Vertices.insert(m_Vertices.end(), vertices, vertices + vertexCount);
+	for (unsigned int i = 0; i < indexCount; ++i)
+		m_Indices.push_back(firstVertex + indices[i]);
+	return (unsigned int)m_Meshes.size() - 1;
+}
+
+void PulledGeometry::Build(bool storage)
+{
+	// two texels a vertex
+	if (!storage && m_Vertices.size() * 2 > PullBuffer::GetMaxTextureBufferTexels())
+		std::cerr << "[vertex pulling] " << m_Vertices.size() << " vertices are more than a texture buffer holds" << std::endl;
+
+	m_VertexBuffer = std::make_unique<PullBuffer>(m_Vertices.data(), (unsigned int)(m_Vertices.size() * sizeof(Vertex)), GL_RGBA32UI, storage);
+	m_IndexBuffer = std::make_unique<PullBuffer>(m_Indices.data(), (unsigned int)(m_Indices.size() * sizeof(unsigned int)), GL_R32UI, storage);
+	m_VAO = std::make_unique<VertexArray>();
+}
+
+void PulledGeometry::Bind() const
+{
+	m_VertexBuffer->Bind(0);
+	m_IndexBuffer->Bind(1);
+}
+
+void PulledGeometry::Draw(const Renderer& renderer, const Shader& shader, unsigned int mesh, unsigned int instanceCount) const
+{
+	const Mesh& range = m_Meshes[mesh];
+	// gl_VertexID runs from firstIndex, the shader looks the vertex up in the index buffer
+	renderer.DrawArrays(*m_VAO, shader, range.firstIndex, range.indexCount, instanceCount);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <GL/glew.h>
+#include "glm/glm.hpp"
+
+#include "Renderer.h"
+#include "VertexArray.h"
+
+// Vertex pulling: the vertex shader fetches its vertices itself, by
+// gl_VertexID and gl_InstanceID, instead of the vertex array doing it.
+// Nothing about the data lives in a VAO, so meshes in different buffers
+// or with different layouts draw without switching one.
+
+// Data a shader indexes into. On GL 3.3 a texture buffer, read with
+// texelFetch on a samplerBuffer/usamplerBuffer at texture unit slot, with
+// storage buffers (Shader::HasCompute) an SSBO at binding = slot.
+class PullBuffer {
+private:
+	unsigned int m_RenderID;
+	unsigned int m_Texture; // texture buffers only
+	unsigned int m_Size;
+	bool m_Storage;
+public:
+	// format is the texel format of the texture buffer, e.g. GL_RGBA32UI
+	// for uvec4s, GL_R32UI for uints. storage buffers ignore it
+	PullBuffer(const void* data, unsigned int size, unsigned int format, bool storage);
+	~PullBuffer();
+
+	void Update(const void* data, unsigned int size, unsigned int offset = 0);
+	void Bind(unsigned int slot) const;
+
+	bool IsStorage() const { return m_Storage; }
+	unsigned int GetSize() const { return m_Size; }
+
+	// texel count the driver allows in a texture buffer, 65536 at least
+	static unsigned int GetMaxTextureBufferTexels();
+};
+
+// Meshes in one vertex and index PullBuffer, drawn with glDrawArrays over
+// their index range and an empty vertex array. A vertex is two uvec4s,
+// PulledMesh.shader (texture buffers) and PulledMeshStorage.shader (storage
+// buffers) unpack them. Indices are stored with the mesh's first vertex
+// added, so drawing a mesh sets no per mesh state at all.
+//
+//   PulledGeometry geometry;
+//   unsigned int cube = geometry.AddMesh(vertices, vertexCount, indices, indexCount);
+//   geometry.Build(storage);
+//   geometry.Bind();  // slots 0 and 1, once for every mesh
+//   geometry.Draw(renderer, shader, cube);
+class PulledGeometry
+{
+public:
+	// 32 bytes, two uvec4 in the shader
+	struct Vertex
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::u8vec4 color;
+		unsigned int padding;
+	};
+
+	struct Mesh
+	{
+		unsigned int firstIndex;
+		unsigned int indexCount;
+	};
+
+private:
+	std::vector<Vertex> m_Vertices;
+	std::vector<unsigned int> m_Indices;
+	std::vector<Mesh> m_Meshes;
+
+	std::unique_ptr<PullBuffer> m_VertexBuffer;
+	std::unique_ptr<PullBuffer> m_IndexBuffer;
+	// no attributes, core profile only draws with a vertex array bound
+	std::unique_ptr<VertexArray> m_VAO;
+
+public:
+	PulledGeometry();
+	~PulledGeometry();
+
+	unsigned int AddMesh(const Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+	// storage buffers or texture buffers, meshes can't be added afterwards
+	void Build(bool storage);
+
+	// vertices to slot 0, indices to slot 1
+	void Bind() const;
+	// instanceCount instances, the shader adds gl_InstanceID to its own base
+	void Draw(const Renderer& renderer, const Shader& shader, unsigned int mesh, unsigned int instanceCount = 1) const;
+
+	const Mesh& GetMesh(unsigned int mesh) const { return m_Meshes[mesh]; }
+	unsigned int GetMeshCount() const { return (unsigned int)m_Meshes.size(); }
+	bool IsStorage() const { return m_VertexBuffer && m_VertexBuffer->IsStorage(); }
+};
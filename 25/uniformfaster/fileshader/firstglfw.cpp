@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <vector>
@@ -18,6 +19,9 @@
 #include "VertexArray.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "TexturePool.h"
+#include "ShaderVariantCache.h"
+#include "GLBackend.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -25,6 +29,29 @@
 #include "tests/Test.h"
 #include "tests/TestClearColor.h"
 #include "tests/TestTexture2D.h"
+#include "tests/TestTextureMemory.h"
+#include "tests/TestBlendBatch.h"
+#include "tests/TestStreamingTexture.h"
+#include "tests/TestTextureResidency.h"
+#include "tests/TestVertexLayout.h"
+#include "tests/TestVertexFormats.h"
+#include "tests/TestVertexStreams.h"
+#include "tests/TestDirectStateAccess.h"
+#include "tests/TestMeshOptimizer.h"
+#include "tests/TestGltfLoading.h"
+#include "tests/TestMeshLod.h"
+#include "tests/TestStaticBatching.h"
+#include "tests/TestTilemap.h"
+#include "tests/TestShaderVariants.h"
+#include "tests/TestShaderCompile.h"
+#include "tests/TestShaderReflection.h"
+#include "tests/TestUniformUploads.h"
+#include "tests/TestShaderStartup.h"
+#include "tests/TestShaderOptimizer.h"
+#include "tests/TestComputeSprites.h"
+#include "tests/TestGpuCulling.h"
+#include "tests/TestVertexPulling.h"
+#include "tests/TestParticles.h"
 
 
 int main(void)
@@ -69,7 +96,7 @@ int main(void)
         //CALLGL(glBlendFunc(GL_ONE, GL_ZERO));
 
          CALLGL(glEnable(GL_BLEND));
-         CALLGL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+         CALLGL(glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)); // textures are premultiplied
 
 
         Renderer renderer;
@@ -84,16 +111,46 @@ int main(void)
 
         testMenu->RegisterTest<test::TestClearColor>("clear color");
         testMenu->RegisterTest<test::TestTexture2D>("2D Texture");
-
+        testMenu->RegisterTest<test::TestTextureMemory>("Texture Memory");
+        testMenu->RegisterTest<test::TestBlendBatch>("Blend Batch");
+        testMenu->RegisterTest<test::TestStreamingTexture>("Streaming Texture");
+        testMenu->RegisterTest<test::TestTextureResidency>("Texture Residency");
+        testMenu->RegisterTest<test::TestVertexLayout>("Vertex Layout");
+        testMenu->RegisterTest<test::TestVertexFormats>("Vertex Formats");
+        testMenu->RegisterTest<test::TestVertexStreams>("Vertex Streams");
+        testMenu->RegisterTest<test::TestDirectStateAccess>("Direct State Access");
+        testMenu->RegisterTest<test::TestMeshOptimizer>("Mesh Optimizer");
+        testMenu->RegisterTest<test::TestGltfLoading>("glTF Loading");
+        testMenu->RegisterTest<test::TestMeshLod>("Mesh LOD");
+        testMenu->RegisterTest<test::TestStaticBatching>("Static Batching");
+        testMenu->RegisterTest<test::TestTilemap>("Tilemap");
+        testMenu->RegisterTest<test::TestShaderVariants>("Shader Variants");
+        testMenu->RegisterTest<test::TestShaderCompile>("Shader Compile");
+        testMenu->RegisterTest<test::TestShaderReflection>("Shader Reflection");
+        testMenu->RegisterTest<test::TestUniformUploads>("Uniform Uploads");
+        testMenu->RegisterTest<test::TestShaderStartup>("Shader Startup");
+        testMenu->RegisterTest<test::TestShaderOptimizer>("Shader Optimizer");
+        testMenu->RegisterTest<test::TestComputeSprites>("Compute Sprites");
+        testMenu->RegisterTest<test::TestGpuCulling>("GPU Culling");
+        testMenu->RegisterTest<test::TestVertexPulling>("Vertex Pulling");
+        testMenu->RegisterTest<test::TestParticles>("Particles");
+
+        double lastTime = glfwGetTime();
         while (!glfwWindowShouldClose(window))
         {
+            // capped, so a hitch like a test loading doesn't throw simulations forward
+            double now = glfwGetTime();
+            float deltatime = std::min((float)(now - lastTime), 0.1f);
+            lastTime = now;
+
+            GLBackend::NewFrame();
             CALLGL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
             renderer.Clear();
             
             ImGui_ImplGlfwGL3_NewFrame();
             if (currentTest)
             {
-                currentTest->OnUpdate(0.0f);
+                currentTest->OnUpdate(deltatime);
                 currentTest->OnRender();
                 ImGui::Begin("Test");
                 if (currentTest != testMenu && ImGui::Button("<-"))
@@ -118,6 +175,10 @@ int main(void)
         delete currentTest;
         if (currentTest != testMenu)
             delete testMenu;
+
+        // pooled textures and cached programs must be deleted while the context is alive
+        TexturePool::Get().Clear();
+        ShaderVariantCache::Get().Clear();
     } 
     ImGui_ImplGlfwGL3_Shutdown();
     ImGui::DestroyContext();
@@ -0,0 +1,45 @@
+#shader vertex
+#version 330 core
+
+// PulledMesh.shader with the vertices fetched by the vertex array, for
+// comparing. instances are still read from the texture buffer
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec4 color;
+
+// two texels each, position and scale, color
+uniform samplerBuffer u_Instances;
+
+uniform int u_InstanceBase;
+uniform mat4 u_ViewProjection;
+
+out vec3 v_Normal;
+out vec4 v_Color;
+
+void main()
+{
+	int instance = (u_InstanceBase + gl_InstanceID) * 2;
+	vec4 positionScale = texelFetch(u_Instances, instance);
+	vec4 instanceColor = texelFetch(u_Instances, instance + 1);
+
+	gl_Position = u_ViewProjection * vec4(position * positionScale.w + positionScale.xyz, 1.0);
+	v_Normal = normal;
+	v_Color = instanceColor * color;
+}
+
+
+#shader fragment
+#version 330 core
+
+#include "include/Lighting.glsl"
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_Normal;
+in vec4 v_Color;
+
+void main()
+{
+	color = vec4(ApplyLighting(v_Color.rgb, v_Normal), 1.0);
+}
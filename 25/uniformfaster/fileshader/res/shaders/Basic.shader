@@ -1,7 +1,7 @@
 #shader vertex
 #version 330 core
 
-layout(location = 0) in vec4 position;
+layout(location = 0) in vec2 position;
 layout(location = 1) in vec2 texCoord;
 
 out vec2 v_TexCoord;
@@ -10,7 +10,7 @@ uniform mat4 u_MVP;
 
 void main()
 {
-	gl_Position = u_MVP * position;
+	gl_Position = u_MVP * vec4(position, 0.0, 1.0);
 	v_TexCoord = texCoord;
 }
 
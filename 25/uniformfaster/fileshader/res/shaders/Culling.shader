@@ -0,0 +1,68 @@
+#shader compute
+#version 430 core
+
+// one instance per invocation, see IndirectScene::CullCpu for the same on the CPU
+layout(local_size_x = 256) in;
+
+struct Instance
+{
+	vec4 positionScale;
+	vec4 color;
+};
+
+struct SceneInstance
+{
+	Instance instance;
+	uint mesh;
+	float radius;
+};
+
+// DrawElementsIndirectCommand, 20 bytes
+struct DrawCommand
+{
+	uint count;
+	uint instanceCount;
+	uint firstIndex;
+	int baseVertex;
+	uint baseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer Instances
+{
+	SceneInstance instances[];
+};
+
+// the instanced vertex stream of the draw
+layout(std430, binding = 1) writeonly buffer Visible
+{
+	Instance visible[];
+};
+
+// one per mesh, instanceCount starts at 0
+layout(std430, binding = 2) buffer Commands
+{
+	DrawCommand commands[];
+};
+
+uniform int u_Count;
+// left, right, bottom, top, near, far, pointing inwards
+uniform vec4 u_Planes[6];
+
+void main()
+{
+	uint i = gl_GlobalInvocationID.x;
+	if (i >= uint(u_Count))
+		return;
+
+	SceneInstance scene = instances[i];
+	vec3 center = scene.instance.positionScale.xyz;
+	for (int p = 0; p < 6; ++p)
+	{
+		if (dot(u_Planes[p].xyz, center) + u_Planes[p].w < -scene.radius)
+			return;
+	}
+
+	// the order within a mesh changes from frame to frame, nothing depends on it
+	uint slot = atomicAdd(commands[scene.mesh].instanceCount, 1u);
+	visible[commands[scene.mesh].baseInstance + slot] = scene.instance;
+}
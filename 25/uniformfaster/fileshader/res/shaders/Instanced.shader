@@ -0,0 +1,36 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+// per instance, IndirectScene::Instance
+layout(location = 2) in vec4 instancePositionScale;
+layout(location = 3) in vec4 instanceColor;
+
+out vec3 v_Normal;
+out vec4 v_Color;
+
+uniform mat4 u_ViewProjection;
+
+void main()
+{
+	vec3 world = position * instancePositionScale.w + instancePositionScale.xyz;
+	gl_Position = u_ViewProjection * vec4(world, 1.0);
+	v_Normal = normal;
+	v_Color = instanceColor;
+}
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_Normal;
+in vec4 v_Color;
+
+void main()
+{
+	float light = max(dot(normalize(v_Normal), normalize(vec3(0.3, 1.0, 0.5))), 0.0);
+	color = vec4(v_Color.rgb * (0.25 + 0.75 * light), 1.0);
+}
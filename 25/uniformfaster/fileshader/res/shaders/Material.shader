@@ -0,0 +1,62 @@
+#shader vertex
+#version 330 core
+
+// features: TEXTURED, VERTEX_COLOR, LIT, CHECKER, TINT=vec3(r, g, b)
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in vec4 color;
+
+out vec3 v_Normal;
+out vec2 v_TexCoord;
+out vec4 v_Color;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+	gl_Position = u_MVP * position;
+	v_Normal = normal;
+	v_TexCoord = texCoord;
+#ifdef VERTEX_COLOR
+	v_Color = color;
+#else
+	v_Color = vec4(1.0);
+#endif
+}
+
+
+#shader fragment
+#version 330 core
+
+#include "include/Lighting.glsl"
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_Normal;
+in vec2 v_TexCoord;
+in vec4 v_Color;
+
+uniform vec4 u_Color;
+#ifdef TEXTURED
+uniform sampler2D u_Texture;
+#endif
+
+void main()
+{
+	vec3 albedo = u_Color.rgb * v_Color.rgb;
+#ifdef TEXTURED
+	albedo *= texture(u_Texture, v_TexCoord).rgb;
+#endif
+#ifdef CHECKER
+	albedo *= 0.8 + 0.2 * mod(floor(v_TexCoord.x * 8.0) + floor(v_TexCoord.y * 8.0), 2.0);
+#endif
+#ifdef TINT
+	albedo *= TINT;
+#endif
+#ifdef LIT
+	albedo = ApplyLighting(albedo, v_Normal);
+#endif
+	color = vec4(albedo, 1.0);
+}
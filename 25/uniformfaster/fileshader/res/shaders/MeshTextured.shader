@@ -0,0 +1,40 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in vec4 color;
+
+out vec3 v_Normal;
+out vec2 v_TexCoord;
+out vec4 v_Color;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+	gl_Position = u_MVP * position;
+	v_Normal = normal;
+	v_TexCoord = texCoord;
+	v_Color = color;
+}
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_Normal;
+in vec2 v_TexCoord;
+in vec4 v_Color;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+	float light = max(dot(normalize(v_Normal), normalize(vec3(0.3, 1.0, 0.5))), 0.0);
+	vec4 texColor = texture(u_Texture, v_TexCoord);
+	color = vec4(v_Color.rgb * texColor.rgb * (0.2 + 0.8 * light), 1.0);
+}
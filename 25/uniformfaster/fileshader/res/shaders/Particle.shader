@@ -0,0 +1,41 @@
+#shader vertex
+#version 330 core
+
+// instanced quads, the particle comes from per instance attributes.
+// x and y are separate so the CPU's structure of arrays uploads as it is
+layout(location = 0) in vec2 corner;
+layout(location = 1) in float positionX;
+layout(location = 2) in float positionY;
+layout(location = 3) in float life;
+
+out vec2 v_Corner;
+out float v_Fade;
+
+uniform mat4 u_ViewProjection;
+uniform float u_Size;
+uniform float u_Lifetime;
+
+void main()
+{
+	vec2 center = vec2(positionX, positionY);
+	gl_Position = u_ViewProjection * vec4(center + corner * u_Size, 0.0, 1.0);
+	v_Corner = corner;
+	v_Fade = clamp(life / u_Lifetime, 0.0, 1.0);
+}
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_Corner;
+in float v_Fade;
+
+void main()
+{
+	float falloff = max(1.0 - dot(v_Corner, v_Corner), 0.0);
+	vec3 hot = mix(vec3(0.9, 0.25, 0.05), vec3(1.0, 0.85, 0.4), v_Fade);
+	// premultiplied, added on top
+	color = vec4(hot * falloff * v_Fade, 0.0);
+}
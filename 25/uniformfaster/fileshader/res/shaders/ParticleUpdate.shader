@@ -0,0 +1,54 @@
+#shader vertex
+#version 330 core
+
+// one particle per vertex, the outputs are captured by transform feedback
+// into the other set of buffers. ParticleSystem::UpdateRange is the same on the CPU
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 velocity;
+layout(location = 2) in float life;
+
+out vec2 o_Position;
+out vec2 o_Velocity;
+out float o_Life;
+
+uniform float u_DeltaTime;
+uniform vec2 u_Gravity;
+uniform vec2 u_Emitter;
+uniform float u_Speed;
+uniform float u_Spread;
+uniform float u_Lifetime;
+uniform int u_Seed;
+
+uint Hash(uint x)
+{
+	x ^= x >> 16;
+	x *= 0x7FEB352Du;
+	x ^= x >> 15;
+	x *= 0x846CA68Bu;
+	x ^= x >> 16;
+	return x;
+}
+
+// 0..1 from 24 bits
+float Random(uint x)
+{
+	return float(Hash(x) >> 8) * (1.0 / 16777216.0);
+}
+
+void main()
+{
+	vec2 v = velocity + u_Gravity * u_DeltaTime;
+	vec2 p = position + v * u_DeltaTime;
+	float l = life - u_DeltaTime;
+	if (l <= 0.0)
+	{
+		uint seed = Hash(uint(gl_VertexID) ^ uint(u_Seed));
+		p = u_Emitter;
+		v = vec2((Random(seed) - 0.5) * u_Spread, u_Speed * (0.5 + 0.5 * Random(seed + 1u)));
+		l = u_Lifetime * (0.5 + 0.5 * Random(seed + 2u));
+	}
+	o_Position = p;
+	o_Velocity = v;
+	o_Life = l;
+}
@@ -0,0 +1,56 @@
+#shader vertex
+#version 330 core
+
+// vertex pulling from texture buffers, no vertex attributes. see
+// PulledGeometry, PulledMeshStorage.shader reads the same from storage buffers
+
+// PulledGeometry::Vertex, two texels each
+uniform usamplerBuffer u_Vertices;
+// the vertex of every gl_VertexID, mesh offsets already added
+uniform usamplerBuffer u_Indices;
+// two texels each, position and scale, color
+uniform samplerBuffer u_Instances;
+
+uniform int u_InstanceBase;
+uniform mat4 u_ViewProjection;
+
+out vec3 v_Normal;
+out vec4 v_Color;
+
+vec4 UnpackColor(uint color)
+{
+	return vec4(uvec4(color, color >> 8, color >> 16, color >> 24) & 0xFFu) / 255.0;
+}
+
+void main()
+{
+	int vertex = int(texelFetch(u_Indices, gl_VertexID).r) * 2;
+	uvec4 a = texelFetch(u_Vertices, vertex);
+	uvec4 b = texelFetch(u_Vertices, vertex + 1);
+	vec3 position = uintBitsToFloat(a.xyz);
+	vec3 normal = uintBitsToFloat(uvec3(a.w, b.xy));
+
+	int instance = (u_InstanceBase + gl_InstanceID) * 2;
+	vec4 positionScale = texelFetch(u_Instances, instance);
+	vec4 color = texelFetch(u_Instances, instance + 1);
+
+	gl_Position = u_ViewProjection * vec4(position * positionScale.w + positionScale.xyz, 1.0);
+	v_Normal = normal;
+	v_Color = color * UnpackColor(b.z);
+}
+
+
+#shader fragment
+#version 330 core
+
+#include "include/Lighting.glsl"
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_Normal;
+in vec4 v_Color;
+
+void main()
+{
+	color = vec4(ApplyLighting(v_Color.rgb, v_Normal), 1.0);
+}
@@ -0,0 +1,59 @@
+#shader vertex
+#version 430 core
+
+// PulledMesh.shader with storage buffers instead of texture buffers,
+// plain array reads without a texture unit in between
+
+layout(std430, binding = 0) readonly buffer Vertices
+{
+	uvec4 vertices[];
+};
+
+layout(std430, binding = 1) readonly buffer Indices
+{
+	uint indices[];
+};
+
+layout(std430, binding = 2) readonly buffer Instances
+{
+	vec4 instances[];
+};
+
+uniform int u_InstanceBase;
+uniform mat4 u_ViewProjection;
+
+out vec3 v_Normal;
+out vec4 v_Color;
+
+void main()
+{
+	uint vertex = indices[gl_VertexID] * 2u;
+	uvec4 a = vertices[vertex];
+	uvec4 b = vertices[vertex + 1u];
+	vec3 position = uintBitsToFloat(a.xyz);
+	vec3 normal = uintBitsToFloat(uvec3(a.w, b.xy));
+
+	int instance = (u_InstanceBase + gl_InstanceID) * 2;
+	vec4 positionScale = instances[instance];
+	vec4 color = instances[instance + 1];
+
+	gl_Position = u_ViewProjection * vec4(position * positionScale.w + positionScale.xyz, 1.0);
+	v_Normal = normal;
+	v_Color = color * unpackUnorm4x8(b.z);
+}
+
+
+#shader fragment
+#version 430 core
+
+#include "include/Lighting.glsl"
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_Normal;
+in vec4 v_Color;
+
+void main()
+{
+	color = vec4(ApplyLighting(v_Color.rgb, v_Normal), 1.0);
+}
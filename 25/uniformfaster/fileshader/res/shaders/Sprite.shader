@@ -0,0 +1,38 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in float blend;
+
+out vec2 v_TexCoord;
+out float v_Blend;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+	gl_Position = u_MVP * position;
+	v_TexCoord = texCoord;
+	v_Blend = blend;
+}
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+in float v_Blend;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+	// texture is premultiplied and blending is (ONE, ONE_MINUS_SRC_ALPHA).
+	// blend 1 -> normal alpha blending, blend 0 -> alpha is 0 so the
+	// color is just added, anything between is a mix of both
+	vec4 texColor = texture(u_Texture, v_TexCoord);
+	color = vec4(texColor.rgb, texColor.a * v_Blend);
+}
@@ -0,0 +1,65 @@
+#shader compute
+#version 430 core
+
+// one sprite per invocation: moves it and writes its quad
+layout(local_size_x = 256) in;
+
+struct Sprite
+{
+	vec2 position;
+	vec2 velocity;
+};
+
+// the layout of the vertex buffer, 4 vertices per sprite
+struct SpriteVertex
+{
+	vec2 position;
+	vec2 texCoord;
+};
+
+layout(std430, binding = 0) buffer Sprites
+{
+	Sprite sprites[];
+};
+
+layout(std430, binding = 1) writeonly buffer Vertices
+{
+	SpriteVertex vertices[];
+};
+
+uniform int u_Count;
+uniform float u_DeltaTime;
+uniform float u_Width;
+uniform float u_Size;
+
+const float Gravity = 300.0;
+
+void main()
+{
+	uint i = gl_GlobalInvocationID.x;
+	if (i >= uint(u_Count))
+		return;
+
+	// same steps as TestComputeSprites::Simulate
+	Sprite sprite = sprites[i];
+	sprite.velocity.y -= Gravity * u_DeltaTime;
+	sprite.position += sprite.velocity * u_DeltaTime;
+	if (sprite.position.x < 0.0 || sprite.position.x > u_Width)
+	{
+		sprite.velocity.x = -sprite.velocity.x;
+		sprite.position.x = clamp(sprite.position.x, 0.0, u_Width);
+	}
+	if (sprite.position.y < 0.0)
+	{
+		sprite.velocity.y = abs(sprite.velocity.y);
+		sprite.position.y = 0.0;
+	}
+	sprites[i] = sprite;
+
+	float halfSize = u_Size * 0.5;
+	uint v = i * 4u;
+	vertices[v + 0u] = SpriteVertex(sprite.position + vec2(-halfSize, -halfSize), vec2(0.0, 0.0));
+	vertices[v + 1u] = SpriteVertex(sprite.position + vec2( halfSize, -halfSize), vec2(1.0, 0.0));
+	vertices[v + 2u] = SpriteVertex(sprite.position + vec2( halfSize,  halfSize), vec2(1.0, 1.0));
+	vertices[v + 3u] = SpriteVertex(sprite.position + vec2(-halfSize,  halfSize), vec2(0.0, 1.0));
+}
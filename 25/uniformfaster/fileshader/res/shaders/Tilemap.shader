@@ -0,0 +1,59 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in uvec2 corner;
+layout(location = 1) in uint tile;
+
+out vec2 v_TexCoord;
+flat out int v_Tile;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+	// empty tiles put all 4 corners on the same spot outside the view
+	if (tile == 0u)
+	{
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		v_TexCoord = vec2(0.0);
+		v_Tile = 0;
+		return;
+	}
+	gl_Position = u_MVP * vec4(vec2(corner), 0.0, 1.0);
+
+	// corners go counter-clockwise from the bottom left, 4 per tile
+	int c = gl_VertexID & 3;
+	v_TexCoord = vec2(c == 1 || c == 2 ? 1.0 : 0.0, c >= 2 ? 1.0 : 0.0);
+	v_Tile = int(tile) - 1;
+}
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+flat in int v_Tile;
+
+uniform sampler2D u_Atlas;
+uniform sampler2DArray u_TileArray;
+uniform int u_UseArray;
+uniform int u_AtlasColumns;
+uniform int u_AtlasRows;
+
+void main()
+{
+	if (u_UseArray != 0)
+	{
+		color = texture(u_TileArray, vec3(v_TexCoord, float(v_Tile)));
+		return;
+	}
+
+	// keep half a texel inside the tile so the neighbours never bleed in
+	vec2 grid = vec2(u_AtlasColumns, u_AtlasRows);
+	vec2 cell = vec2(v_Tile % u_AtlasColumns, v_Tile / u_AtlasColumns);
+	vec2 halfTexel = 0.5 / vec2(textureSize(u_Atlas, 0));
+	vec2 uv = clamp((cell + v_TexCoord) / grid, cell / grid + halfTexel, (cell + 1.0) / grid - halfTexel);
+	color = texture(u_Atlas, uv);
+}
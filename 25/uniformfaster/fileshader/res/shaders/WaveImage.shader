@@ -0,0 +1,22 @@
+#shader compute
+#version 430 core
+
+// fills an image with moving waves, sampled as a texture afterwards
+layout(local_size_x = 16, local_size_y = 16) in;
+
+layout(rgba8, binding = 0) writeonly uniform image2D u_Image;
+
+uniform float u_Time;
+
+void main()
+{
+	ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+	ivec2 size = imageSize(u_Image);
+	if (any(greaterThanEqual(texel, size)))
+		return;
+
+	vec2 uv = vec2(texel) / vec2(size);
+	float wave = sin(uv.x * 12.0 + u_Time) * cos(uv.y * 9.0 - u_Time * 0.7);
+	vec3 color = mix(vec3(0.05, 0.07, 0.15), vec3(0.1, 0.2, 0.35), 0.5 + 0.5 * wave);
+	imageStore(u_Image, texel, vec4(color, 1.0));
+}
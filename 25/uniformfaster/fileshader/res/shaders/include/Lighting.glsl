@@ -0,0 +1,13 @@
+// one directional light plus ambient, shared by the mesh shaders
+
+const vec3 c_LightDirection = vec3(0.3, 1.0, 0.5);
+
+float Lambert(vec3 normal)
+{
+	return max(dot(normalize(normal), normalize(c_LightDirection)), 0.0);
+}
+
+vec3 ApplyLighting(vec3 albedo, vec3 normal)
+{
+	return albedo * (0.2 + 0.8 * Lambert(normal));
+}
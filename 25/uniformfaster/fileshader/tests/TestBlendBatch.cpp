@@ -0,0 +1,102 @@
+#include "TestBlendBatch.h"
+
+#include "../Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+struct SpriteVertex
+{
+    glm::vec2 position;
+    glm::vec2 texCoord;
+    float blend;
+};
+VERTEX_LAYOUT(SpriteVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(texCoord),
+    VERTEX_ATTRIB(blend));
+
+namespace test {
+    static const unsigned int SpriteColumns = 8;
+    static const unsigned int SpriteRows = 4;
+    static const unsigned int SpriteCount = SpriteColumns * SpriteRows;
+
+    TestBlendBatch::TestBlendBatch() :
+        m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_AlphaBlend(1.0f),
+        m_AdditiveBlend(0.0f)
+    {
+        std::vector<unsigned int> indices;
+        for (unsigned int i = 0; i < SpriteCount; ++i)
+        {
+            unsigned int base = i * 4;
+            indices.insert(indices.end(), { base + 0, base + 1, base + 2, base + 2, base + 3, base + 0 });
+        }
+
+        CALLGL(glEnable(GL_BLEND));
+        CALLGL(glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+
+        m_VAO = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(nullptr, SpriteCount * 4 * sizeof(SpriteVertex));
+        BuildSprites();
+
+        m_VAO->AddBuffer<SpriteVertex>(*m_VertexBuffer);
+
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+        m_Shader = std::make_unique<Shader>("res/shaders/Sprite.shader");
+        m_Shader->Bind();
+        m_Shader->SetUniformMat4f("u_MVP", m_Proj);
+        m_Shader->SetUniform1i("u_Texture", 0);
+
+        m_Texture = std::make_unique<Texture>("res/textures/Glow.png");
+    }
+    TestBlendBatch::~TestBlendBatch()
+    {}
+
+    void TestBlendBatch::BuildSprites()
+    {
+        // overlapping glows, even columns alpha blended, odd columns additive
+        std::vector<SpriteVertex> vertices;
+        vertices.reserve(SpriteCount * 4);
+        for (unsigned int y = 0; y < SpriteRows; ++y)
+        {
+            for (unsigned int x = 0; x < SpriteColumns; ++x)
+            {
+                float left = 100.0f + x * 90.0f;
+                float bottom = 80.0f + y * 90.0f;
+                float blend = (x % 2 == 0) ? m_AlphaBlend : m_AdditiveBlend;
+                vertices.push_back({ { left,          bottom          }, { 0.0f, 0.0f }, blend });
+                vertices.push_back({ { left + 128.0f, bottom          }, { 1.0f, 0.0f }, blend });
+                vertices.push_back({ { left + 128.0f, bottom + 128.0f }, { 1.0f, 1.0f }, blend });
+                vertices.push_back({ { left,          bottom + 128.0f }, { 0.0f, 1.0f }, blend });
+            }
+        }
+        m_VertexBuffer->Bind();
+        CALLGL(glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(SpriteVertex), vertices.data()));
+    }
+
+    void TestBlendBatch::OnUpdate(float deltatime)
+    {}
+    void TestBlendBatch::OnRender()
+    {
+        CALLGL(glClearColor(0.1f, 0.1f, 0.3f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+
+        Renderer renderer;
+        m_Texture->Bind();
+        renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+    }
+    void TestBlendBatch::OnImGuiRender()
+    {
+        bool changed = false;
+        changed |= ImGui::SliderFloat("Even columns blend", &m_AlphaBlend, 0.0f, 1.0f);
+        changed |= ImGui::SliderFloat("Odd columns blend", &m_AdditiveBlend, 0.0f, 1.0f);
+        if (changed)
+            BuildSprites();
+
+        ImGui::Text("%u sprites, 1 draw call", SpriteCount);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../Texture.h"
+
+#include <memory>
+
+namespace test {
+
+	// alpha blended and additive sprites drawn in a single draw call,
+	// the blend mode is a vertex attribute instead of glBlendFunc state
+	class TestBlendBatch : public Test
+	{
+	public:
+		TestBlendBatch();
+		~TestBlendBatch();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void BuildSprites();
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Shader> m_Shader;
+		std::unique_ptr<Texture> m_Texture;
+
+		glm::mat4 m_Proj;
+		float m_AlphaBlend;
+		float m_AdditiveBlend;
+	};
+} // namespace test
@@ -0,0 +1,240 @@
+#include "TestComputeSprites.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "../Renderer.h"
+#include "../TexturePool.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+// matches struct SpriteVertex in SpriteSimulation.shader (std430, 16 bytes)
+struct ComputeSpriteVertex
+{
+    glm::vec2 position;
+    glm::vec2 texCoord;
+};
+VERTEX_LAYOUT(ComputeSpriteVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(texCoord));
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const float Width = 960.0f;
+    static const float Height = 540.0f;
+    static const float SpriteSize = 16.0f;
+    static const float Gravity = 300.0f;
+    static const TextureDesc BackgroundDesc = { 480, 270, GL_RGBA8, 1 };
+
+    TestComputeSprites::TestComputeSprites() :
+        m_Background(0),
+        m_SpriteCount(20000),
+        m_Gpu(false),
+        m_ComputeBackground(false),
+        m_DeltaTime(0.0f),
+        m_Time(0.0f),
+        m_CpuMs(0.0)
+    {
+        m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader");
+        m_Texture = std::make_unique<Texture>("res/textures/Glow.png");
+
+        if (Shader::HasCompute())
+        {
+            m_Simulation = std::make_unique<Shader>("res/shaders/SpriteSimulation.shader");
+            m_WaveImage = std::make_unique<Shader>("res/shaders/WaveImage.shader");
+            m_Gpu = m_Simulation->IsLinked();
+            m_ComputeBackground = m_WaveImage->IsLinked();
+            if (!m_Simulation->IsLinked())
+                std::cout << "Compute Sprites: SpriteSimulation.shader didn't link, only the CPU path runs" << std::endl;
+
+            m_Background = TexturePool::Get().Acquire(BackgroundDesc);
+            Texture::SetSampling(m_Background, GL_LINEAR);
+            Texture::EndEdit();
+
+            ComputeSpriteVertex vertices[] = {
+                { { 0.0f,  0.0f   }, { 0.0f, 0.0f } },
+                { { Width, 0.0f   }, { 1.0f, 0.0f } },
+                { { Width, Height }, { 1.0f, 1.0f } },
+                { { 0.0f,  Height }, { 0.0f, 1.0f } },
+            };
+            unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+            m_BackgroundVAO = std::make_unique<VertexArray>();
+            m_BackgroundBuffer = std::make_unique<VertexBuffer>(vertices, (unsigned int)sizeof(vertices));
+            m_BackgroundVAO->AddBuffer<ComputeSpriteVertex>(*m_BackgroundBuffer);
+            m_BackgroundIndices = std::make_unique<IndexBuffer>(indices, 6);
+        }
+        else
+            std::cout << "Compute Sprites: no compute shaders (GL 4.3), only the CPU path runs" << std::endl;
+
+        BuildSprites();
+    }
+    TestComputeSprites::~TestComputeSprites()
+    {
+        if (m_Background)
+            TexturePool::Get().Release(m_Background, BackgroundDesc);
+    }
+
+    void TestComputeSprites::BuildSprites()
+    {
+        std::mt19937 rng(47);
+        std::uniform_real_distribution<float> x(0.0f, Width), y(Height * 0.3f, Height);
+        std::uniform_real_distribution<float> speed(-150.0f, 150.0f);
+
+        m_Sprites.resize(m_SpriteCount);
+        for (Sprite& sprite : m_Sprites)
+            sprite = { { x(rng), y(rng) }, { speed(rng), speed(rng) } };
+
+        std::vector<unsigned int> indices;
+        indices.reserve(m_SpriteCount * 6);
+        for (unsigned int i = 0; i < (unsigned int)m_SpriteCount; ++i)
+        {
+            unsigned int base = i * 4;
+            indices.insert(indices.end(), { base + 0, base + 1, base + 2, base + 2, base + 3, base + 0 });
+        }
+
+        // DYNAMIC_DRAW, the CPU path rewrites it every frame
+        m_VAO = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(nullptr, m_SpriteCount * 4 * (unsigned int)sizeof(ComputeSpriteVertex), GL_DYNAMIC_DRAW);
+        m_VAO->AddBuffer<ComputeSpriteVertex>(*m_VertexBuffer);
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+        if (m_Simulation)
+            m_SpriteBuffer = std::make_unique<StorageBuffer>(m_Sprites.data(), m_SpriteCount * (unsigned int)sizeof(Sprite));
+    }
+
+    void TestComputeSprites::SetGpu(bool gpu)
+    {
+        // the state lives on whichever side moves the sprites
+        if (gpu)
+            m_SpriteBuffer->Update(m_Sprites.data(), m_SpriteCount * (unsigned int)sizeof(Sprite));
+        else
+        {
+            // the last dispatch wrote it from the shader
+            Renderer renderer;
+            renderer.Barrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+            m_SpriteBuffer->Read(m_Sprites.data(), m_SpriteCount * (unsigned int)sizeof(Sprite));
+        }
+        m_Gpu = gpu;
+    }
+
+    void TestComputeSprites::Simulate(float deltatime)
+    {
+        // same steps as SpriteSimulation.shader
+        std::vector<ComputeSpriteVertex> vertices(m_Sprites.size() * 4);
+        ComputeSpriteVertex* v = vertices.data();
+        float half = SpriteSize * 0.5f;
+        for (Sprite& sprite : m_Sprites)
+        {
+            sprite.velocity.y -= Gravity * deltatime;
+            sprite.position += sprite.velocity * deltatime;
+            if (sprite.position.x < 0.0f || sprite.position.x > Width)
+            {
+                sprite.velocity.x = -sprite.velocity.x;
+                sprite.position.x = std::min(std::max(sprite.position.x, 0.0f), Width);
+            }
+            if (sprite.position.y < 0.0f)
+            {
+                sprite.velocity.y = std::abs(sprite.velocity.y);
+                sprite.position.y = 0.0f;
+            }
+            const glm::vec2& p = sprite.position;
+            *v++ = { { p.x - half, p.y - half }, { 0.0f, 0.0f } };
+            *v++ = { { p.x + half, p.y - half }, { 1.0f, 0.0f } };
+            *v++ = { { p.x + half, p.y + half }, { 1.0f, 1.0f } };
+            *v++ = { { p.x - half, p.y + half }, { 0.0f, 1.0f } };
+        }
+        m_VertexBuffer->Update(vertices.data(), (unsigned int)(vertices.size() * sizeof(ComputeSpriteVertex)));
+    }
+
+    void TestComputeSprites::OnUpdate(float deltatime)
+    {
+        m_DeltaTime = deltatime > 0.0f ? deltatime : 1.0f / 60.0f;
+        m_Time += m_DeltaTime;
+    }
+    void TestComputeSprites::OnRender()
+    {
+        CALLGL(glClearColor(0.05f, 0.05f, 0.1f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+        CALLGL(glEnable(GL_BLEND));
+        CALLGL(glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+
+        m_GpuTimer.Poll();
+
+        Renderer renderer;
+        glm::mat4 proj = glm::ortho(0.0f, Width, 0.0f, Height, -1.0f, 1.0f);
+        m_Shader->Bind();
+        m_Shader->SetUniformMat4f("u_MVP", proj);
+        m_Shader->SetUniform1i("u_Texture", 0);
+
+        if (m_ComputeBackground)
+        {
+            Texture::BindImage(0, m_Background, BackgroundDesc.internalFormat, GL_WRITE_ONLY);
+            m_WaveImage->Bind();
+            m_WaveImage->SetUniform1f("u_Time", m_Time);
+            const glm::uvec3& group = m_WaveImage->GetWorkGroupSize();
+            renderer.Dispatch(*m_WaveImage,
+                Renderer::GetGroupCount(BackgroundDesc.width, group.x),
+                Renderer::GetGroupCount(BackgroundDesc.height, group.y));
+            renderer.Barrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+            CALLGL(glActiveTexture(GL_TEXTURE0));
+            CALLGL(glBindTexture(GL_TEXTURE_2D, m_Background));
+            renderer.Draw(*m_BackgroundVAO, *m_BackgroundIndices, *m_Shader);
+        }
+
+        m_GpuTimer.Begin();
+        Clock::time_point start = Clock::now();
+        if (m_Gpu)
+        {
+            m_Simulation->Bind();
+            m_Simulation->SetUniform1i("u_Count", m_SpriteCount);
+            m_Simulation->SetUniform1f("u_DeltaTime", m_DeltaTime);
+            m_Simulation->SetUniform1f("u_Width", Width);
+            m_Simulation->SetUniform1f("u_Size", SpriteSize);
+            m_SpriteBuffer->BindBase(0);
+            m_VertexBuffer->BindBase(1);
+            renderer.Dispatch(*m_Simulation, Renderer::GetGroupCount(m_SpriteCount, m_Simulation->GetWorkGroupSize().x));
+            renderer.Barrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+        }
+        else
+            Simulate(m_DeltaTime);
+
+        m_Texture->Bind(0);
+        renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+        m_CpuMs = Milliseconds(Clock::now() - start).count();
+        m_GpuTimer.End();
+        CALLGL(glDisable(GL_BLEND));
+    }
+    void TestComputeSprites::OnImGuiRender()
+    {
+        // starts over, on the GPU too
+        if (ImGui::SliderInt("Sprites", &m_SpriteCount, 1000, 200000))
+            BuildSprites();
+
+        if (m_Simulation && m_Simulation->IsLinked())
+        {
+            bool gpu = m_Gpu;
+            if (ImGui::Checkbox("Move sprites in a compute shader", &gpu))
+                SetGpu(gpu);
+        }
+        else if (m_Simulation)
+            ImGui::Text("the sprite compute shader didn't link, sprites move on the CPU");
+        else
+            ImGui::Text("compute shaders need GL 4.3, sprites move on the CPU");
+        if (m_WaveImage && m_WaveImage->IsLinked())
+            ImGui::Checkbox("Compute background", &m_ComputeBackground);
+
+        ImGui::Text("%s: %.3f ms CPU (simulate, upload, draw), %.3f ms GPU",
+            m_Gpu ? "compute" : "CPU", m_CpuMs, m_GpuTimer.GetMs());
+        ImGui::Text("%.1f MB of vertices uploaded per frame",
+            m_Gpu ? 0.0 : m_SpriteCount * 4.0 * sizeof(ComputeSpriteVertex) / (1024.0 * 1024.0));
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
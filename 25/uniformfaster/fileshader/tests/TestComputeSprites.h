@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../StorageBuffer.h"
+#include "../Texture.h"
+#include "../GpuTimer.h"
+
+#include <memory>
+#include <vector>
+
+namespace test {
+
+	// bouncing glow sprites moved either on the CPU (vertices rebuilt and
+	// uploaded every frame) or by a compute shader that writes the vertex
+	// buffer itself, so nothing crosses the bus. the background is an image
+	// another compute shader fills each frame
+	class TestComputeSprites : public Test
+	{
+	public:
+		TestComputeSprites();
+		~TestComputeSprites();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		struct Sprite
+		{
+			glm::vec2 position;
+			glm::vec2 velocity;
+		};
+
+		void BuildSprites();
+		void Simulate(float deltatime);
+		void SetGpu(bool gpu);
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<StorageBuffer> m_SpriteBuffer;
+		std::unique_ptr<Shader> m_Shader;
+		std::unique_ptr<Shader> m_Simulation;
+		std::unique_ptr<Texture> m_Texture;
+		std::vector<Sprite> m_Sprites;
+
+		std::unique_ptr<VertexArray> m_BackgroundVAO;
+		std::unique_ptr<VertexBuffer> m_BackgroundBuffer;
+		std::unique_ptr<IndexBuffer> m_BackgroundIndices;
+		std::unique_ptr<Shader> m_WaveImage;
+		unsigned int m_Background;
+
+		int m_SpriteCount;
+		bool m_Gpu;
+		bool m_ComputeBackground;
+		float m_DeltaTime;
+		float m_Time;
+
+		double m_CpuMs;
+
+		GpuTimer m_GpuTimer;
+	};
+} // namespace test
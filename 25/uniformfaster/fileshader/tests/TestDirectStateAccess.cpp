@@ -0,0 +1,116 @@
+#include "TestDirectStateAccess.h"
+
+#include <chrono>
+
+#include "../Renderer.h"
+#include "../GLBackend.h"
+#include "../Texture.h"
+#include "../TexturePool.h"
+#include "../VertexBufferLayout.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    TestDirectStateAccess::TestDirectStateAccess() :
+        m_ObjectsPerFrame(200),
+        m_UseDSA(GLBackend::IsDSAEnabled()),
+        m_CpuMs(0.0)
+    {
+        m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader");
+        m_Shader->Bind();
+        m_Shader->SetUniform1i("u_Texture", 0);
+
+        // 64x64 checker
+        m_Pixels.resize(64 * 64 * 4);
+        for (int i = 0; i < 64 * 64; ++i)
+        {
+            unsigned char c = ((i % 64) / 8 + (i / 64) / 8) % 2 ? 255 : 64;
+            m_Pixels[i * 4 + 0] = c;
+            m_Pixels[i * 4 + 1] = c;
+            m_Pixels[i * 4 + 2] = 255;
+            m_Pixels[i * 4 + 3] = 255;
+        }
+    }
+    TestDirectStateAccess::~TestDirectStateAccess()
+    {
+        // the rest of the app goes on with whatever the context supports
+        GLBackend::SetDSAEnabled(true);
+    }
+
+    void TestDirectStateAccess::OnRender()
+    {
+        CALLGL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+        GLBackend::SetDSAEnabled(m_UseDSA);
+
+        m_Shader->Bind();
+        glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+
+        unsigned int indices[] = {
+            0,1,2,
+            2,3,0,
+        };
+        TextureDesc desc = { 64, 64, GL_RGBA8, 1 };
+        Renderer renderer;
+
+        // everything a mesh and texture load does: create, fill, describe, draw
+        Clock::time_point start = Clock::now();
+        int columns = 20;
+        float size = 960.0f / columns;
+        for (int i = 0; i < m_ObjectsPerFrame; ++i)
+        {
+            float x = (i % columns) * size;
+            float y = (i / columns % 11) * size;
+            float positions[] = {
+                x,        y,        0.0f, 0.0f,
+                x + size, y,        1.0f, 0.0f,
+                x + size, y + size, 1.0f, 1.0f,
+                x,        y + size, 0.0f, 1.0f,
+            };
+            VertexBuffer vb(positions, sizeof(positions), GL_DYNAMIC_DRAW);
+            vb.Update(positions, sizeof(positions));
+            IndexBuffer ib(indices, _countof(indices));
+            VertexArray va;
+            VertexBufferLayout layout;
+            layout.Push<float>(2);
+            layout.Push<float>(2);
+            va.AddBuffer(vb, layout);
+
+            unsigned int texture = TexturePool::Get().Acquire(desc);
+            Texture::SetSampling(texture, GL_LINEAR);
+            Texture::SetChannelSwizzle(texture, 4);
+            Texture::SetSubImage(texture, 0, 0, 64, 64, 4, m_Pixels.data());
+            Texture::EndEdit();
+
+            CALLGL(glActiveTexture(GL_TEXTURE0));
+            CALLGL(glBindTexture(GL_TEXTURE_2D, texture));
+            GLBackend::CountBinds();
+            m_Shader->SetUniformMat4f("u_MVP", proj);
+            renderer.Draw(va, ib, *m_Shader);
+
+            TexturePool::Get().Release(texture, desc);
+        }
+        m_CpuMs = Milliseconds(Clock::now() - start).count();
+    }
+    void TestDirectStateAccess::OnImGuiRender()
+    {
+        if (GLBackend::HasDSA())
+            ImGui::Checkbox("Direct State Access", &m_UseDSA);
+        else
+            ImGui::Text("no GL 4.5 / ARB_direct_state_access, bind-to-edit only");
+        ImGui::SliderInt("Objects per frame", &m_ObjectsPerFrame, 1, 2000);
+
+        unsigned int binds = GLBackend::GetFrameBinds();
+        unsigned int saved = GLBackend::GetFrameSavedBinds();
+        ImGui::Text("%s path", GLBackend::UseDSA() ? "DSA" : "bind-to-edit");
+        ImGui::Text("binds last frame: %u issued, %u saved (%.1f per object)", binds, saved,
+            (float)saved / m_ObjectsPerFrame);
+        ImGui::Text("create + fill + draw %.3f ms (%.2f us per object)", m_CpuMs, 1000.0 * m_CpuMs / m_ObjectsPerFrame);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../Renderer.h"
+
+#include <memory>
+#include <vector>
+
+namespace test {
+
+	// creates, fills and draws small meshes and textures every frame and
+	// counts the binds the DSA path saves over bind-to-edit
+	class TestDirectStateAccess : public Test
+	{
+	public:
+		TestDirectStateAccess();
+		~TestDirectStateAccess();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		std::unique_ptr<Shader> m_Shader;
+		std::vector<unsigned char> m_Pixels;
+
+		int m_ObjectsPerFrame;
+		bool m_UseDSA;
+		double m_CpuMs;
+	};
+} // namespace test
@@ -0,0 +1,204 @@
+#include "TestGltfLoading.h"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "../Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const int BenchmarkGridSize = 200; // 40000 vertices, ~1.9 MB per mesh
+
+    TestGltfLoading::TestGltfLoading() :
+        m_Path("gltf_benchmark.glb"),
+        m_MeshCount(200),
+        m_Threads((int)std::thread::hardware_concurrency()),
+        m_FileBytes(0),
+        m_WriteMs(0.0),
+        m_LoadMs(0.0)
+    {
+        m_Shader = std::make_unique<Shader>("res/shaders/Mesh.shader");
+        if (m_Threads < 1)
+            m_Threads = 1;
+    }
+    TestGltfLoading::~TestGltfLoading()
+    {}
+
+    size_t TestGltfLoading::WriteBenchmarkFile(const std::string& filepath, int meshCount, int gridSize)
+    {
+        struct Vertex
+        {
+            glm::vec3 position;
+            glm::vec3 normal;
+            glm::vec2 texCoord;
+        };
+        int n = gridSize;
+        unsigned int vertexCount = n * n;
+        unsigned int indexCount = (n - 1) * (n - 1) * 6;
+
+        // one wavy tile, moved for every mesh
+        std::vector<Vertex> tile(vertexCount);
+        std::vector<glm::u8vec4> colors(vertexCount);
+        for (int y = 0; y < n; ++y)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                float u = (float)x / (n - 1);
+                float v = (float)y / (n - 1);
+                float h = 0.05f * std::sin(u * 12.0f) * std::cos(v * 9.0f);
+                glm::vec3 normal = glm::normalize(glm::vec3(-0.6f * std::cos(u * 12.0f) * std::cos(v * 9.0f), 1.0f,
+                    0.45f * std::sin(u * 12.0f) * std::sin(v * 9.0f)));
+                tile[y * n + x] = { glm::vec3(u, h, v), normal, glm::vec2(u, v) };
+                colors[y * n + x] = glm::u8vec4((unsigned char)(u * 255), 160, (unsigned char)(v * 255), 255);
+            }
+        }
+        std::vector<unsigned short> indices;
+        indices.reserve(indexCount);
+        for (int y = 0; y < n - 1; ++y)
+        {
+            for (int x = 0; x < n - 1; ++x)
+            {
+                unsigned short i = (unsigned short)(y * n + x);
+                unsigned short j = (unsigned short)(i + n);
+                indices.insert(indices.end(), { i, j, (unsigned short)(i + 1), (unsigned short)(i + 1), j, (unsigned short)(j + 1) });
+            }
+        }
+
+        // every mesh has the same sizes, views are laid out back to back
+        size_t vertexBytes = vertexCount * sizeof(Vertex);
+        size_t colorBytes = vertexCount * sizeof(glm::u8vec4);
+        size_t indexBytes = ((indexCount * sizeof(unsigned short)) + 3) & ~(size_t)3;
+        size_t meshBytes = vertexBytes + colorBytes + indexBytes;
+        size_t binBytes = meshBytes * meshCount;
+
+        std::ostringstream json;
+        json << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"fileshader benchmark\"},"
+            << "\"buffers\":[{\"byteLength\":" << binBytes << "}],\"bufferViews\":[";
+        for (int m = 0; m < meshCount; ++m)
+        {
+            size_t base = meshBytes * m;
+            json << (m ? "," : "")
+                << "{\"buffer\":0,\"byteOffset\":" << base << ",\"byteLength\":" << vertexBytes << ",\"byteStride\":" << sizeof(Vertex) << ",\"target\":34962},"
+                << "{\"buffer\":0,\"byteOffset\":" << base + vertexBytes << ",\"byteLength\":" << colorBytes << ",\"target\":34962},"
+                << "{\"buffer\":0,\"byteOffset\":" << base + vertexBytes + colorBytes << ",\"byteLength\":" << indexCount * sizeof(unsigned short) << ",\"target\":34963}";
+        }
+        json << "],\"accessors\":[";
+        for (int m = 0; m < meshCount; ++m)
+        {
+            glm::vec3 offset((float)(m % 16) * 1.1f, 0.0f, (float)(m / 16) * 1.1f);
+            json << (m ? "," : "")
+                << "{\"bufferView\":" << m * 3 << ",\"byteOffset\":0,\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC3\","
+                << "\"min\":[" << offset.x << ",-0.05," << offset.z << "],\"max\":[" << offset.x + 1.0f << ",0.05," << offset.z + 1.0f << "]},"
+                << "{\"bufferView\":" << m * 3 << ",\"byteOffset\":12,\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC3\"},"
+                << "{\"bufferView\":" << m * 3 << ",\"byteOffset\":24,\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC2\"},"
+                << "{\"bufferView\":" << m * 3 + 1 << ",\"componentType\":5121,\"normalized\":true,\"count\":" << vertexCount << ",\"type\":\"VEC4\"},"
+                << "{\"bufferView\":" << m * 3 + 2 << ",\"componentType\":5123,\"count\":" << indexCount << ",\"type\":\"SCALAR\"}";
+        }
+        json << "],\"meshes\":[";
+        for (int m = 0; m < meshCount; ++m)
+        {
+            int a = m * 5;
+            json << (m ? "," : "") << "{\"name\":\"tile" << m << "\",\"primitives\":[{\"attributes\":{"
+                << "\"POSITION\":" << a << ",\"NORMAL\":" << a + 1 << ",\"TEXCOORD_0\":" << a + 2 << ",\"COLOR_0\":" << a + 3
+                << "},\"indices\":" << a + 4 << "}]}";
+        }
+        json << "]}";
+
+        std::string text = json.str();
+        while (text.size() % 4)
+            text += ' ';
+
+        std::ofstream file(filepath, std::ios::binary);
+        unsigned int header[5] = { 0x46546C67, 2, (unsigned int)(12 + 8 + text.size() + 8 + binBytes), (unsigned int)text.size(), 0x4E4F534A };
+        file.write((const char*)header, sizeof(header));
+        file.write(text.data(), text.size());
+        unsigned int binHeader[2] = { (unsigned int)binBytes, 0x004E4942 };
+        file.write((const char*)binHeader, sizeof(binHeader));
+
+        std::vector<Vertex> moved(vertexCount);
+        std::vector<char> padding(indexBytes - indexCount * sizeof(unsigned short), 0);
+        for (int m = 0; m < meshCount; ++m)
+        {
+            glm::vec3 offset((float)(m % 16) * 1.1f, 0.0f, (float)(m / 16) * 1.1f);
+            for (unsigned int i = 0; i < vertexCount; ++i)
+            {
+                moved[i] = tile[i];
+                moved[i].position += offset;
+            }
+            file.write((const char*)moved.data(), vertexBytes);
+            file.write((const char*)colors.data(), colorBytes);
+            file.write((const char*)indices.data(), indexCount * sizeof(unsigned short));
+            file.write(padding.data(), padding.size());
+        }
+        return file ? (size_t)header[2] : 0;
+    }
+
+    void TestGltfLoading::Load()
+    {
+        m_Model.reset();
+        Clock::time_point start = Clock::now();
+        m_Model = std::make_unique<GltfModel>(m_Path, m_Threads);
+        m_LoadMs = Milliseconds(Clock::now() - start).count();
+
+        const GltfModel::LoadStats& stats = m_Model->GetStats();
+        std::cout << "glTF load " << m_Path << ": " << stats.fileBytes / (1024.0 * 1024.0) << " MB in " << m_LoadMs << " ms ("
+            << stats.fileBytes / (1024.0 * 1024.0) / (m_LoadMs / 1000.0) << " MB/s), map " << stats.mapMs
+            << " ms, parse " << stats.parseMs << " ms, decode " << stats.decodeMs << " ms on " << stats.threads
+            << " threads, upload " << stats.uploadMs << " ms" << std::endl;
+    }
+
+    void TestGltfLoading::OnRender()
+    {
+        CALLGL(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        if (!m_Model || !m_Model->IsLoaded())
+            return;
+
+        CALLGL(glEnable(GL_DEPTH_TEST));
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), 960.0f / 540.0f, 0.1f, 100.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(8.8f, 14.0f, 22.0f), glm::vec3(8.8f, 0.0f, 6.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        m_Shader->Bind();
+        m_Shader->SetUniformMat4f("u_MVP", proj * view);
+
+        Renderer renderer;
+        m_Model->Draw(renderer, *m_Shader);
+        CALLGL(glDisable(GL_DEPTH_TEST));
+    }
+    void TestGltfLoading::OnImGuiRender()
+    {
+        ImGui::SliderInt("Meshes", &m_MeshCount, 1, 300);
+        if (ImGui::Button("Write file"))
+        {
+            Clock::time_point start = Clock::now();
+            m_FileBytes = WriteBenchmarkFile(m_Path, m_MeshCount, BenchmarkGridSize);
+            m_WriteMs = Milliseconds(Clock::now() - start).count();
+        }
+        ImGui::SameLine();
+        ImGui::Text("%s: %.1f MB, written in %.0f ms", m_Path.c_str(), m_FileBytes / (1024.0 * 1024.0), m_WriteMs);
+
+        ImGui::SliderInt("Threads", &m_Threads, 1, 32);
+        if (ImGui::Button("Load"))
+            Load();
+
+        if (m_Model)
+        {
+            const GltfModel::LoadStats& stats = m_Model->GetStats();
+            double megabytes = stats.fileBytes / (1024.0 * 1024.0);
+            ImGui::Text("%zu meshes, %u triangles", m_Model->GetMeshes().size(), m_Model->GetTriangleCount());
+            ImGui::Text("loaded %.1f MB in %.1f ms, %.0f MB/s", megabytes, m_LoadMs, m_LoadMs > 0.0 ? megabytes / (m_LoadMs / 1000.0) : 0.0);
+            ImGui::Text("map %.2f ms, parse %.2f ms, decode %.2f ms (%u threads), upload %.2f ms (%.1f MB)",
+                stats.mapMs, stats.parseMs, stats.decodeMs, stats.threads, stats.uploadMs, stats.uploadedBytes / (1024.0 * 1024.0));
+        }
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../GltfModel.h"
+
+#include <memory>
+#include <string>
+
+namespace test {
+
+	// writes a large generated .glb and measures how fast GltfModel maps,
+	// decodes and uploads it
+	class TestGltfLoading : public Test
+	{
+	public:
+		TestGltfLoading();
+		~TestGltfLoading();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// meshes of gridSize x gridSize vertices, position/normal/texcoord
+		// interleaved in one buffer view, colors in another, 16 bit indices
+		static size_t WriteBenchmarkFile(const std::string& filepath, int meshCount, int gridSize);
+		void Load();
+
+		std::unique_ptr<GltfModel> m_Model;
+		std::unique_ptr<Shader> m_Shader;
+		std::string m_Path;
+
+		int m_MeshCount;
+		int m_Threads;
+		size_t m_FileBytes;
+		double m_WriteMs;
+		double m_LoadMs;
+	};
+} // namespace test
@@ -0,0 +1,155 @@
+#include "TestGpuCulling.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "../Renderer.h"
+#include "../Frustum.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const int SceneSizes[] = { 10000, 100000, 250000, 500000, 1000000 };
+    static const char* SceneSizeNames[] = { "10k", "100k", "250k", "500k", "1M" };
+    // instances per unit of volume stay the same, bigger scenes are wider
+    static const float Density = 0.02f;
+
+    TestGpuCulling::TestGpuCulling() :
+        m_SizeIndex(1),
+        m_GpuCulling(false),
+        m_Time(0.0f),
+        m_BuildMs(0.0),
+        m_CpuMs(0.0)
+    {
+        m_Shader = std::make_unique<Shader>("res/shaders/Instanced.shader");
+        BuildScene();
+        m_GpuCulling = m_Scene->CanCullOnGpu();
+    }
+    TestGpuCulling::~TestGpuCulling()
+    {
+    }
+
+    void TestGpuCulling::BuildScene()
+    {
+        Clock::time_point start = Clock::now();
+        m_Scene = std::make_unique<IndirectScene>();
+
+        // unit cube, 4 vertices per face for flat normals
+        std::vector<IndirectScene::Vertex> vertices;
+        std::vector<unsigned int> indices;
+        for (int face = 0; face < 6; ++face)
+        {
+            glm::vec3 n(0.0f);
+            n[face / 2] = face % 2 ? -1.0f : 1.0f;
+            glm::vec3 u(0.0f);
+            u[(face / 2 + 1) % 3] = 1.0f;
+            glm::vec3 v = glm::cross(n, u);
+            unsigned int base = (unsigned int)vertices.size();
+            for (int corner = 0; corner < 4; ++corner)
+                vertices.push_back({ 0.5f * n + ((corner & 1) - 0.5f) * u + ((corner >> 1) - 0.5f) * v, n });
+            indices.insert(indices.end(), { base, base + 1, base + 3, base, base + 3, base + 2 });
+        }
+        unsigned int cube = m_Scene->AddMesh(vertices.data(), (unsigned int)vertices.size(), indices.data(), (unsigned int)indices.size());
+
+        // octahedron, a triangle per octant wound to face outwards
+        vertices.clear();
+        indices.clear();
+        for (int octant = 0; octant < 8; ++octant)
+        {
+            glm::vec3 sign(octant & 1 ? -1.0f : 1.0f, octant & 2 ? -1.0f : 1.0f, octant & 4 ? -1.0f : 1.0f);
+            glm::vec3 a(sign.x * 0.6f, 0.0f, 0.0f), b(0.0f, sign.y * 0.6f, 0.0f), c(0.0f, 0.0f, sign.z * 0.6f);
+            if (glm::dot(glm::cross(b - a, c - a), sign) < 0.0f)
+                std::swap(b, c);
+            glm::vec3 n = glm::normalize(sign);
+            unsigned int base = (unsigned int)vertices.size();
+            vertices.insert(vertices.end(), { { a, n }, { b, n }, { c, n } });
+            indices.insert(indices.end(), { base, base + 1, base + 2 });
+        }
+        unsigned int octahedron = m_Scene->AddMesh(vertices.data(), (unsigned int)vertices.size(), indices.data(), (unsigned int)indices.size());
+
+        std::mt19937 rng(48);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        int count = SceneSizes[m_SizeIndex];
+        float extent = std::cbrt(count / Density);
+        for (int i = 0; i < count; ++i)
+        {
+            glm::vec3 position = (glm::vec3(unit(rng), unit(rng), unit(rng)) - 0.5f) * extent;
+            glm::vec4 color(0.4f + 0.6f * unit(rng), 0.4f + 0.6f * unit(rng), 0.4f + 0.6f * unit(rng), 1.0f);
+            m_Scene->AddInstance(unit(rng) < 0.6f ? cube : octahedron, position, 0.5f + unit(rng), color);
+        }
+        m_Scene->Build();
+        m_BuildMs = Milliseconds(Clock::now() - start).count();
+        std::cout << "GPU culling: " << count << " instances of " << m_Scene->GetMeshCount() << " meshes built in "
+            << m_BuildMs << " ms" << std::endl;
+    }
+
+    void TestGpuCulling::OnUpdate(float deltatime)
+    {
+        m_Time += deltatime > 0.0f ? deltatime : 1.0f / 60.0f;
+    }
+
+    void TestGpuCulling::OnRender()
+    {
+        CALLGL(glClearColor(0.08f, 0.08f, 0.12f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        CALLGL(glEnable(GL_DEPTH_TEST));
+        CALLGL(glEnable(GL_CULL_FACE));
+
+        m_GpuTimer.Poll();
+
+        // stands in the middle and turns, a slice of the cloud is in view
+        float angle = m_Time * 0.2f;
+        glm::vec3 forward(std::cos(angle), 0.2f * std::sin(angle * 0.7f), std::sin(angle));
+        float depth = std::cbrt(SceneSizes[m_SizeIndex] / Density);
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), 960.0f / 540.0f, 0.1f, depth);
+        glm::mat4 viewProj = proj * glm::lookAt(glm::vec3(0.0f), forward, glm::vec3(0.0f, 1.0f, 0.0f));
+        Frustum frustum(viewProj);
+
+        Renderer renderer;
+        m_GpuTimer.Begin();
+        Clock::time_point start = Clock::now();
+        if (m_GpuCulling)
+            m_Scene->CullGpu(renderer, frustum);
+        else
+            m_Scene->CullCpu(frustum);
+        m_Shader->Bind();
+        m_Shader->SetUniformMat4f("u_ViewProjection", viewProj);
+        m_Scene->Draw(renderer, *m_Shader);
+        m_CpuMs = Milliseconds(Clock::now() - start).count();
+        m_GpuTimer.End();
+        CALLGL(glDisable(GL_CULL_FACE));
+        CALLGL(glDisable(GL_DEPTH_TEST));
+    }
+    void TestGpuCulling::OnImGuiRender()
+    {
+        if (ImGui::Combo("Instances", &m_SizeIndex, SceneSizeNames, IM_ARRAYSIZE(SceneSizeNames)))
+            BuildScene();
+        if (m_Scene->CanCullOnGpu())
+            ImGui::Checkbox("Cull in a compute shader", &m_GpuCulling);
+        else
+            ImGui::Text("compute shaders need GL 4.3, culling on the CPU");
+        if (!Renderer::HasMultiDrawIndirect())
+            ImGui::Text("no multi draw indirect, an instanced draw per mesh");
+
+        ImGui::Text("%u instances, built in %.0f ms", m_Scene->GetInstanceCount(), m_BuildMs);
+        if (m_GpuCulling)
+            ImGui::Text("visible: stays on the GPU, nothing uploaded");
+        else
+            ImGui::Text("visible: %u, %.1f MB uploaded", m_Scene->GetVisibleCount(),
+                m_Scene->GetVisibleCount() * sizeof(IndirectScene::Instance) / (1024.0 * 1024.0));
+        // multi draw indirect submits every mesh's command in one call
+        if (Renderer::HasMultiDrawIndirect())
+            ImGui::Text("1 draw call, %u commands", m_Scene->GetMeshCount());
+        else
+            ImGui::Text("%u draw calls", m_Scene->GetMeshCount());
+        ImGui::Text("%.3f ms CPU (cull and submit), %.3f ms GPU", m_CpuMs, m_GpuTimer.GetMs());
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../IndirectScene.h"
+#include "../GpuTimer.h"
+
+#include <memory>
+
+namespace test {
+
+	// a cloud of up to a million cubes and octahedra around a turning camera.
+	// either the CPU culls them and uploads the visible instances and draw
+	// counts, or a compute shader does it on the GPU. both submit the same
+	// one draw per mesh (multi draw indirect)
+	class TestGpuCulling : public Test
+	{
+	public:
+		TestGpuCulling();
+		~TestGpuCulling();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void BuildScene();
+
+		std::unique_ptr<IndirectScene> m_Scene;
+		std::unique_ptr<Shader> m_Shader;
+
+		int m_SizeIndex;
+		bool m_GpuCulling;
+		float m_Time;
+
+		double m_BuildMs;
+		double m_CpuMs;
+
+		GpuTimer m_GpuTimer;
+	};
+} // namespace test
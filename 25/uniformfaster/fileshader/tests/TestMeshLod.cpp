@@ -0,0 +1,179 @@
+#include "TestMeshLod.h"
+
+#include <chrono>
+#include <cmath>
+#include <map>
+
+#include "../Renderer.h"
+#include "../MeshOptimizer.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+struct LodVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(LodVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord),
+    VERTEX_ATTRIB(color));
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const float InstanceSpacing = 3.0f;
+
+    TestMeshLod::TestMeshLod() :
+        m_BuildMs(0.0),
+        m_GridSize(16),
+        m_UseLod(true),
+        m_MaxPixelError(1.0f),
+        m_Hysteresis(0.25f),
+        m_Time(0.0f),
+        m_Triangles(0),
+        m_LevelSwitches(0)
+    {
+        m_Shader = std::make_unique<Shader>("res/shaders/Mesh.shader");
+        BuildMesh();
+    }
+    TestMeshLod::~TestMeshLod()
+    {
+    }
+
+    void TestMeshLod::BuildMesh()
+    {
+        // icosphere subdivided 6 times, 81920 triangles, then made bumpy
+        float t = (1.0f + std::sqrt(5.0f)) / 2.0f;
+        std::vector<glm::vec3> positions = {
+            { -1, t, 0 }, { 1, t, 0 }, { -1, -t, 0 }, { 1, -t, 0 },
+            { 0, -1, t }, { 0, 1, t }, { 0, -1, -t }, { 0, 1, -t },
+            { t, 0, -1 }, { t, 0, 1 }, { -t, 0, -1 }, { -t, 0, 1 },
+        };
+        for (glm::vec3& p : positions)
+            p = glm::normalize(p);
+        std::vector<unsigned int> indices = {
+            0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11,
+            1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+            3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9,
+            4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1,
+        };
+        for (int level = 0; level < 6; ++level)
+        {
+            std::map<std::pair<unsigned int, unsigned int>, unsigned int> midpoints;
+            auto midpoint = [&](unsigned int a, unsigned int b) {
+                auto key = std::make_pair(std::min(a, b), std::max(a, b));
+                auto it = midpoints.find(key);
+                if (it != midpoints.end())
+                    return it->second;
+                positions.push_back(glm::normalize(positions[a] + positions[b]));
+                return midpoints[key] = (unsigned int)positions.size() - 1;
+            };
+            std::vector<unsigned int> subdivided;
+            subdivided.reserve(indices.size() * 4);
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                unsigned int a = indices[i], b = indices[i + 1], c = indices[i + 2];
+                unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+                subdivided.insert(subdivided.end(), { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca });
+            }
+            indices.swap(subdivided);
+        }
+
+        std::vector<LodVertex> vertices(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            glm::vec3 n = positions[i];
+            float bump = 1.0f + 0.06f * std::sin(n.x * 11.0f) * std::sin(n.y * 9.0f) * std::sin(n.z * 7.0f);
+            positions[i] = n * bump;
+            vertices[i] = { positions[i], n, glm::vec2(std::atan2(n.z, n.x) / 6.2831853f + 0.5f, n.y * 0.5f + 0.5f),
+                glm::u8vec4((unsigned char)(140 + 100 * n.x), (unsigned char)(140 + 100 * n.y), 200, 255) };
+        }
+
+        Clock::time_point start = Clock::now();
+        MeshOptimizer::OptimizeVertexCache(indices.data(), indices.data(), (unsigned int)indices.size(), (unsigned int)positions.size());
+        m_Lod = std::make_unique<MeshLod>(indices.data(), (unsigned int)indices.size(), positions.data(), (unsigned int)positions.size());
+        m_BuildMs = Milliseconds(Clock::now() - start).count();
+
+        m_VertexBuffer = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(LodVertex)));
+        m_VAO = std::make_unique<VertexArray>();
+        m_VAO->AddBuffer<LodVertex>(*m_VertexBuffer);
+    }
+
+    void TestMeshLod::OnUpdate(float deltatime)
+    {
+        m_Time += deltatime > 0.0f ? deltatime : 1.0f / 60.0f;
+    }
+
+    void TestMeshLod::OnRender()
+    {
+        CALLGL(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        CALLGL(glEnable(GL_DEPTH_TEST));
+        CALLGL(glEnable(GL_CULL_FACE));
+
+        m_GpuTimer.Poll();
+
+        // fly back and forth over the field so instances change distance
+        float extent = m_GridSize * InstanceSpacing;
+        float travel = 0.5f + 0.5f * std::sin(m_Time * 0.3f);
+        glm::vec3 eye(extent * 0.5f, 3.0f + 10.0f * travel, -4.0f + extent * 0.6f * travel);
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), 960.0f / 540.0f, 0.1f, 500.0f);
+        glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.0f, -0.35f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 viewProj = proj * view;
+        float pixelsPerUnit = 540.0f * 0.5f * proj[1][1];
+
+        unsigned int instanceCount = m_GridSize * m_GridSize;
+        m_InstanceLevels.resize(instanceCount, 0);
+        m_LevelCounts.assign(m_Lod->GetLevelCount(), 0);
+        m_Triangles = 0;
+        m_LevelSwitches = 0;
+
+        m_Shader->Bind();
+        Renderer renderer;
+        m_GpuTimer.Begin();
+        for (unsigned int i = 0; i < instanceCount; ++i)
+        {
+            glm::vec3 position((i % m_GridSize) * InstanceSpacing, 0.0f, (i / m_GridSize) * InstanceSpacing);
+            unsigned int level = 0;
+            if (m_UseLod)
+            {
+                float distance = glm::length(position + m_Lod->GetCenter() - eye);
+                level = m_Lod->SelectLevel(distance, pixelsPerUnit, m_MaxPixelError, m_InstanceLevels[i], m_Hysteresis);
+                m_LevelSwitches += level != m_InstanceLevels[i];
+                m_InstanceLevels[i] = level;
+            }
+            ++m_LevelCounts[level];
+            m_Triangles += m_Lod->GetTriangleCount(level);
+
+            m_Shader->SetUniformMat4f("u_MVP", viewProj * glm::translate(glm::mat4(1.0f), position));
+            renderer.Draw(*m_VAO, m_Lod->GetIndexBuffer(level), *m_Shader);
+        }
+        m_GpuTimer.End();
+        CALLGL(glDisable(GL_CULL_FACE));
+        CALLGL(glDisable(GL_DEPTH_TEST));
+    }
+    void TestMeshLod::OnImGuiRender()
+    {
+        ImGui::SliderInt("Instances per side", &m_GridSize, 1, 40);
+        ImGui::Checkbox("LOD", &m_UseLod);
+        ImGui::SliderFloat("Max error (pixels)", &m_MaxPixelError, 0.25f, 8.0f);
+        ImGui::SliderFloat("Hysteresis", &m_Hysteresis, 0.0f, 0.9f);
+
+        ImGui::Text("%u levels built in %.1f ms", m_Lod->GetLevelCount(), m_BuildMs);
+        for (unsigned int level = 0; level < m_Lod->GetLevelCount(); ++level)
+        {
+            ImGui::Text("  level %u: %6u triangles, error %.4f, %u instances", level,
+                m_Lod->GetTriangleCount(level), m_Lod->GetError(level),
+                level < m_LevelCounts.size() ? m_LevelCounts[level] : 0);
+        }
+        ImGui::Text("%.2f M triangles, %.3f ms GPU, %u level switches this frame", m_Triangles / 1000000.0f, m_GpuTimer.GetMs(), m_LevelSwitches);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
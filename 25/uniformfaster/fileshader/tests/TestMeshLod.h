@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../MeshLod.h"
+#include "../GpuTimer.h"
+
+#include <memory>
+#include <vector>
+
+namespace test {
+
+	// a field of high poly meshes with the camera flying over it, drawn at
+	// full detail or with MeshLod picking a level per instance every frame
+	class TestMeshLod : public Test
+	{
+	public:
+		TestMeshLod();
+		~TestMeshLod();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void BuildMesh();
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<MeshLod> m_Lod;
+		std::unique_ptr<Shader> m_Shader;
+		double m_BuildMs;
+
+		int m_GridSize; // instances per side
+		bool m_UseLod;
+		float m_MaxPixelError;
+		float m_Hysteresis;
+		float m_Time;
+		std::vector<unsigned int> m_InstanceLevels;
+
+		unsigned int m_Triangles;
+		unsigned int m_LevelSwitches;
+		std::vector<unsigned int> m_LevelCounts;
+
+		GpuTimer m_GpuTimer;
+	};
+} // namespace test
@@ -0,0 +1,174 @@
+#include "TestMeshOptimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+struct OptimizerVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(OptimizerVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord),
+    VERTEX_ATTRIB(color));
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const char* OrderNames[] = { "shuffled", "vertex cache", "cache + overdraw + fetch" };
+
+    TestMeshOptimizer::TestMeshOptimizer() :
+        m_Stats{},
+        m_Detail(256),
+        m_Order(Full),
+        m_DrawsPerFrame(8),
+        m_OptimizeMs(0.0),
+        m_Angle(0.0f),
+        m_GpuMs{}
+    {
+        m_Shader = std::make_unique<Shader>("res/shaders/Mesh.shader");
+        BuildMesh();
+    }
+    TestMeshOptimizer::~TestMeshOptimizer()
+    {
+    }
+
+    void TestMeshOptimizer::BuildMesh()
+    {
+        // bumpy torus, the inner side hides behind the outer one
+        int rings = m_Detail;
+        int sides = m_Detail / 2;
+        std::vector<OptimizerVertex> vertices;
+        vertices.reserve((rings + 1) * (sides + 1));
+        for (int r = 0; r <= rings; ++r)
+        {
+            float u = (float)r / rings * 6.2831853f;
+            for (int s = 0; s <= sides; ++s)
+            {
+                float v = (float)s / sides * 6.2831853f;
+                float tube = 0.3f + 0.02f * std::sin(u * 24.0f) * std::sin(v * 12.0f);
+                glm::vec3 normal(std::cos(u) * std::cos(v), std::sin(v), std::sin(u) * std::cos(v));
+                glm::vec3 center(std::cos(u) * 0.7f, 0.0f, std::sin(u) * 0.7f);
+                vertices.push_back({ center + normal * tube, normal, glm::vec2((float)r / rings, (float)s / sides),
+                    glm::u8vec4((unsigned char)(128 + 127 * normal.x), (unsigned char)(128 + 127 * normal.y), 200, 255) });
+            }
+        }
+
+        std::vector<unsigned int> indices;
+        indices.reserve(rings * sides * 6);
+        for (int r = 0; r < rings; ++r)
+        {
+            for (int s = 0; s < sides; ++s)
+            {
+                unsigned int i = r * (sides + 1) + s;
+                unsigned int j = i + sides + 1;
+                indices.insert(indices.end(), { i, i + 1, j, j, i + 1, j + 1 });
+            }
+        }
+
+        // scramble triangles and vertices like a careless exporter would
+        std::mt19937 random(7);
+        unsigned int triangleCount = (unsigned int)indices.size() / 3;
+        std::vector<unsigned int> triangleOrder(triangleCount);
+        for (unsigned int t = 0; t < triangleCount; ++t)
+            triangleOrder[t] = t;
+        std::shuffle(triangleOrder.begin(), triangleOrder.end(), random);
+        std::vector<unsigned int> vertexOrder(vertices.size());
+        for (unsigned int v = 0; v < vertexOrder.size(); ++v)
+            vertexOrder[v] = v;
+        std::shuffle(vertexOrder.begin(), vertexOrder.end(), random);
+
+        std::vector<OptimizerVertex> shuffledVertices(vertices.size());
+        for (unsigned int v = 0; v < vertexOrder.size(); ++v)
+            shuffledVertices[vertexOrder[v]] = vertices[v];
+        std::vector<unsigned int> shuffled(indices.size());
+        for (unsigned int t = 0; t < triangleCount; ++t)
+            for (int k = 0; k < 3; ++k)
+                shuffled[t * 3 + k] = vertexOrder[indices[triangleOrder[t] * 3 + k]];
+
+        unsigned int vertexCount = (unsigned int)shuffledVertices.size();
+        unsigned int indexCount = (unsigned int)shuffled.size();
+        std::vector<OptimizerVertex> meshVertices[OrderCount] = { shuffledVertices, shuffledVertices, {} };
+        std::vector<unsigned int> meshIndices[OrderCount] = { shuffled, shuffled, shuffled };
+
+        Clock::time_point start = Clock::now();
+        MeshOptimizer::OptimizeVertexCache(meshIndices[VertexCache].data(), meshIndices[VertexCache].data(), indexCount, vertexCount);
+
+        std::vector<glm::vec3> positions(vertexCount);
+        for (unsigned int v = 0; v < vertexCount; ++v)
+            positions[v] = shuffledVertices[v].position;
+        std::vector<unsigned int>& full = meshIndices[Full];
+        MeshOptimizer::OptimizeVertexCache(full.data(), full.data(), indexCount, vertexCount);
+        MeshOptimizer::OptimizeOverdraw(full.data(), full.data(), indexCount, positions.data(), vertexCount);
+        meshVertices[Full].resize(vertexCount);
+        unsigned int used = MeshOptimizer::OptimizeVertexFetch(meshVertices[Full].data(), full.data(), indexCount,
+            shuffledVertices.data(), vertexCount, sizeof(OptimizerVertex));
+        meshVertices[Full].resize(used);
+        m_OptimizeMs = Milliseconds(Clock::now() - start).count();
+
+        for (int i = 0; i < OrderCount; ++i)
+        {
+            m_Stats[i] = MeshOptimizer::AnalyzeVertexCache(meshIndices[i].data(), indexCount, (unsigned int)meshVertices[i].size());
+            m_VertexBuffer[i] = std::make_unique<VertexBuffer>(meshVertices[i].data(), (unsigned int)(meshVertices[i].size() * sizeof(OptimizerVertex)));
+            m_IndexBuffer[i] = std::make_unique<IndexBuffer>(meshIndices[i].data(), indexCount);
+            m_VAO[i] = std::make_unique<VertexArray>();
+            m_VAO[i]->AddBuffer<OptimizerVertex>(*m_VertexBuffer[i]);
+        }
+    }
+
+    void TestMeshOptimizer::OnRender()
+    {
+        CALLGL(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        CALLGL(glEnable(GL_DEPTH_TEST));
+        CALLGL(glEnable(GL_CULL_FACE));
+
+        // last frame's result, never wait for the GPU here
+        if (m_GpuTimer.Poll())
+            m_GpuMs[m_Order] = m_GpuTimer.GetMs() / m_DrawsPerFrame;
+
+        m_Angle += 0.005f;
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), 960.0f / 540.0f, 0.1f, 10.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 1.5f, 2.2f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 model = glm::rotate(glm::mat4(1.0f), m_Angle, glm::vec3(0.0f, 1.0f, 0.0f));
+        m_Shader->Bind();
+        m_Shader->SetUniformMat4f("u_MVP", proj * view * model);
+
+        Renderer renderer;
+        m_GpuTimer.Begin();
+        for (int i = 0; i < m_DrawsPerFrame; ++i)
+            renderer.Draw(*m_VAO[m_Order], *m_IndexBuffer[m_Order], *m_Shader);
+        m_GpuTimer.End();
+        CALLGL(glDisable(GL_CULL_FACE));
+        CALLGL(glDisable(GL_DEPTH_TEST));
+    }
+    void TestMeshOptimizer::OnImGuiRender()
+    {
+        if (ImGui::SliderInt("Detail", &m_Detail, 16, 1024))
+            BuildMesh();
+        ImGui::Combo("Order", &m_Order, OrderNames, OrderCount);
+        ImGui::SliderInt("Draws per frame", &m_DrawsPerFrame, 1, 64);
+
+        ImGui::Text("%u triangles, optimized in %.2f ms", m_IndexBuffer[0]->GetCount() / 3, m_OptimizeMs);
+        for (int i = 0; i < OrderCount; ++i)
+        {
+            ImGui::Text("%-24s ACMR %.3f ATVR %.3f, %.3f ms per draw", OrderNames[i],
+                m_Stats[i].acmr, m_Stats[i].atvr, m_GpuMs[i]);
+        }
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
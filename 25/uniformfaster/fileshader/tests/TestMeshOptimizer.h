@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../MeshOptimizer.h"
+#include "../GpuTimer.h"
+
+#include <memory>
+
+namespace test {
+
+	// a mesh with its triangles in random order, as imported meshes often
+	// are, against the same mesh after MeshOptimizer. shows ACMR/ATVR and
+	// GPU time per draw
+	class TestMeshOptimizer : public Test
+	{
+	public:
+		TestMeshOptimizer();
+		~TestMeshOptimizer();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		enum Order { Shuffled, VertexCache, Full, OrderCount };
+
+		void BuildMesh();
+
+		std::unique_ptr<VertexArray> m_VAO[OrderCount];
+		std::unique_ptr<VertexBuffer> m_VertexBuffer[OrderCount];
+		std::unique_ptr<IndexBuffer> m_IndexBuffer[OrderCount];
+		MeshOptimizer::VertexCacheStats m_Stats[OrderCount];
+		std::unique_ptr<Shader> m_Shader;
+
+		int m_Detail;
+		int m_Order;
+		int m_DrawsPerFrame;
+		double m_OptimizeMs;
+		float m_Angle;
+
+		GpuTimer m_GpuTimer;
+		double m_GpuMs[OrderCount];
+	};
+} // namespace test
@@ -0,0 +1,195 @@
+#include "TestParticles.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#include "../Renderer.h"
+
+#include "imgui/imgui.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test {
+
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const char* BackendNames[] = { "CPU (SSE2, threads)", "GPU (transform feedback)" };
+    static const char* CountNames[] = { "10k", "30k", "100k", "300k", "1M", "3M", "10M" };
+    static const unsigned int Counts[] = { 10000, 30000, 100000, 300000, 1000000, 3000000, 10000000 };
+    static const int BackendCount = IM_ARRAYSIZE(BackendNames);
+    static const int CountCount = IM_ARRAYSIZE(Counts);
+
+    // enough for the buffers to settle and the timer queries to catch up
+    static const int WarmupFrames = 10;
+    static const int MeasureFrames = 60;
+
+    TestParticles::TestParticles() :
+        m_Backend(1),
+        m_CountIndex(4),
+        m_Threads(0),
+        m_Size(1.5f),
+        m_DeltaTime(1.0f / 60.0f),
+        m_Sweeping(false),
+        m_SweepStep(0),
+        m_SweepFrame(0),
+        m_SweepSum{},
+        m_LastFrame(Clock::now()),
+        m_FrameMs(0.0)
+    {
+        m_Emitter.position = glm::vec2(480.0f, 40.0f);
+        m_Emitter.gravity = glm::vec2(0.0f, -300.0f);
+        m_Emitter.speed = 480.0f;
+        m_Emitter.spread = 320.0f;
+        m_Emitter.lifetime = 3.0f;
+        Rebuild();
+    }
+
+    TestParticles::~TestParticles()
+    {
+    }
+
+    void TestParticles::Rebuild()
+    {
+        // 10M particles are a few hundred MB, let the old ones go first
+        m_Particles.reset();
+        m_Particles = std::make_unique<ParticleSystem>(Counts[m_CountIndex], (ParticleSystem::Backend)m_Backend, m_Emitter);
+        m_Particles->SetThreadCount(m_Threads);
+        if (!m_Particles->IsValid())
+            std::cerr << "[particles] " << BackendNames[m_Backend] << " shaders didn't link" << std::endl;
+    }
+
+    void TestParticles::StartSweepStep()
+    {
+        m_CountIndex = m_SweepStep / BackendCount;
+        m_Backend = m_SweepStep % BackendCount;
+        m_SweepFrame = 0;
+        m_SweepSum = SweepResult{ Counts[m_CountIndex], m_Backend, 0.0, 0.0, 0.0, 0.0 };
+        Rebuild();
+    }
+
+    void TestParticles::AdvanceSweep()
+    {
+        if (++m_SweepFrame <= WarmupFrames)
+            return;
+
+        const ParticleSystem::Stats& stats = m_Particles->GetStats();
+        m_SweepSum.simulateMs += stats.simulateMs;
+        m_SweepSum.uploadMs += stats.uploadMs;
+        m_SweepSum.gpuMs += m_GpuTimer.GetMs();
+        m_SweepSum.frameMs += m_FrameMs;
+        if (m_SweepFrame < WarmupFrames + MeasureFrames)
+            return;
+
+        SweepResult result = m_SweepSum;
+        result.simulateMs /= MeasureFrames;
+        result.uploadMs /= MeasureFrames;
+        result.gpuMs /= MeasureFrames;
+        result.frameMs /= MeasureFrames;
+        m_Results.push_back(result);
+
+        if (++m_SweepStep < (unsigned int)(CountCount * BackendCount))
+        {
+            StartSweepStep();
+            return;
+        }
+        m_Sweeping = false;
+        PrintSweep();
+    }
+
+    void TestParticles::PrintSweep() const
+    {
+        std::cout << "[particles] sweep, " << MeasureFrames << " frame averages in ms" << std::endl;
+        char line[128];
+        std::snprintf(line, sizeof(line), "%10s %-26s %10s %10s %10s %10s", "count", "backend", "simulate", "upload", "gpu", "frame");
+        std::cout << line << std::endl;
+        for (const SweepResult& result : m_Results)
+        {
+            std::snprintf(line, sizeof(line), "%10u %-26s %10.3f %10.3f %10.3f %10.3f", result.count, BackendNames[result.backend],
+                result.simulateMs, result.uploadMs, result.gpuMs, result.frameMs);
+            std::cout << line << std::endl;
+        }
+    }
+
+    void TestParticles::OnUpdate(float deltatime)
+    {
+        m_DeltaTime = deltatime > 0.0f ? deltatime : 1.0f / 60.0f;
+    }
+
+    void TestParticles::OnRender()
+    {
+        Clock::time_point now = Clock::now();
+        m_FrameMs = Milliseconds(now - m_LastFrame).count();
+        m_LastFrame = now;
+
+        CALLGL(glClearColor(0.02f, 0.02f, 0.04f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_GpuTimer.Poll();
+
+        Renderer renderer;
+        glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+
+        // the feedback pass and the upload are GPU work too, so both are in the query
+        m_GpuTimer.Begin();
+
+        m_Particles->Update(renderer, m_DeltaTime);
+        CALLGL(glEnable(GL_BLEND));
+        CALLGL(glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+        m_Particles->Draw(renderer, proj, m_Size);
+        CALLGL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+        CALLGL(glDisable(GL_BLEND));
+
+        m_GpuTimer.End();
+
+        if (m_Sweeping)
+            AdvanceSweep();
+    }
+
+    void TestParticles::OnImGuiRender()
+    {
+        if (m_Sweeping)
+        {
+            ImGui::Text("sweeping %s on %s, %u of %d", CountNames[m_CountIndex], BackendNames[m_Backend],
+                m_SweepStep + 1, CountCount * BackendCount);
+        }
+        else
+        {
+            bool rebuild = ImGui::Combo("Backend", &m_Backend, BackendNames, BackendCount);
+            rebuild |= ImGui::Combo("Particles", &m_CountIndex, CountNames, CountCount);
+            if (rebuild)
+                Rebuild();
+            if (ImGui::SliderInt("CPU threads (0 = all)", &m_Threads, 0, 32))
+                m_Particles->SetThreadCount(m_Threads);
+            ImGui::SliderFloat("Size", &m_Size, 0.5f, 4.0f);
+            if (ImGui::Button("Run sweep"))
+            {
+                m_Sweeping = true;
+                m_SweepStep = 0;
+                m_Results.clear();
+                StartSweepStep();
+            }
+        }
+
+        const ParticleSystem::Stats& stats = m_Particles->GetStats();
+        if (m_Particles->GetBackend() == ParticleSystem::Backend::Cpu)
+            ImGui::Text("%u particles, %.3f ms simulate on %u threads, %.3f ms upload", m_Particles->GetCount(), stats.simulateMs, stats.threads, stats.uploadMs);
+        else
+            ImGui::Text("%u particles, %.3f ms to submit the feedback pass", m_Particles->GetCount(), stats.simulateMs);
+        ImGui::Text("%.3f ms GPU", m_GpuTimer.GetMs());
+
+        if (!m_Results.empty())
+        {
+            // frame time includes the swap, with vsync on it won't go below the refresh
+            ImGui::Separator();
+            ImGui::Text("%10s %-26s %9s %9s %9s %9s", "count", "backend", "simulate", "upload", "gpu", "frame");
+            for (const SweepResult& result : m_Results)
+            {
+                ImGui::Text("%10u %-26s %9.3f %9.3f %9.3f %9.3f", result.count, BackendNames[result.backend],
+                    result.simulateMs, result.uploadMs, result.gpuMs, result.frameMs);
+            }
+        }
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../ParticleSystem.h"
+#include "../GpuTimer.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace test {
+
+	// a fountain of up to 10M particles, simulated on the CPU (SSE2 over
+	// threads, then uploaded) or on the GPU with transform feedback. the
+	// sweep steps through every count on both backends and prints a table
+	class TestParticles : public Test
+	{
+	public:
+		TestParticles();
+		~TestParticles();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		struct SweepResult
+		{
+			unsigned int count;
+			int backend;
+			double simulateMs;
+			double uploadMs;
+			double gpuMs;
+			double frameMs;
+		};
+
+		void Rebuild();
+		void StartSweepStep();
+		void AdvanceSweep();
+		void PrintSweep() const;
+
+		std::unique_ptr<ParticleSystem> m_Particles;
+		ParticleEmitter m_Emitter;
+
+		int m_Backend;
+		int m_CountIndex;
+		int m_Threads;
+		float m_Size;
+		float m_DeltaTime;
+
+		// one step per count and backend, warm up first, then average
+		bool m_Sweeping;
+		unsigned int m_SweepStep;
+		int m_SweepFrame;
+		SweepResult m_SweepSum;
+		std::vector<SweepResult> m_Results;
+
+		std::chrono::steady_clock::time_point m_LastFrame;
+		double m_FrameMs;
+
+		GpuTimer m_GpuTimer;
+	};
+} // namespace test
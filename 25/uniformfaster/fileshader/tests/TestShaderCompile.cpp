@@ -0,0 +1,182 @@
+#include "TestShaderCompile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include "../Renderer.h"
+#include "../VertexBufferLayout.h"
+#include "../ShaderPreprocessor.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+struct CompileVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(CompileVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord),
+    VERTEX_ATTRIB(color));
+
+namespace test {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const char* ShaderPath = "res/shaders/Material.shader";
+    static const char* FeatureNames[] = { "VERTEX_COLOR", "LIT", "CHECKER" };
+
+    TestShaderCompile::TestShaderCompile() :
+        m_ProgramCount(64),
+        m_WaitBudget(1),
+        m_Generation(0),
+        m_Time(0.0f),
+        m_Compiling(false),
+        m_PreprocessMs(0.0),
+        m_SubmitMs(0.0),
+        m_TotalMs(0.0),
+        m_WorstFrameMs(0.0),
+        m_CompileFrames(0),
+        m_BlockingMs(0.0),
+        m_ParallelMs(0.0)
+    {
+        CompileVertex vertices[] = {
+            { { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f }, { 255, 120, 120, 255 } },
+            { { 0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f }, { 120, 255, 120, 255 } },
+            { { 0.5f, 0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f }, { 120, 120, 255, 255 } },
+            { { -0.5f, 0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f }, { 255, 255, 120, 255 } },
+        };
+        unsigned int indices[] = { 0, 1, 2, 0, 2, 3 };
+        m_VertexBuffer = std::make_unique<VertexBuffer>(vertices, (unsigned int)sizeof(vertices));
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+        m_VAO = std::make_unique<VertexArray>();
+        m_VAO->AddBuffer<CompileVertex>(*m_VertexBuffer);
+
+        m_Fallback = std::make_unique<Shader>("res/shaders/Mesh.shader");
+        m_LastFrame = Clock::now();
+        Compile(false);
+    }
+    TestShaderCompile::~TestShaderCompile()
+    {
+        m_Queue.FinishAll();
+    }
+
+    void TestShaderCompile::Compile(bool wait)
+    {
+        m_Queue.FinishAll();
+        m_Programs.clear();
+        ++m_Generation;
+
+        // every program gets its own tint, drivers cache compiled programs
+        // by source so the generation goes in too
+        Clock::time_point start = Clock::now();
+        std::vector<ShaderProgramSources> sources(m_ProgramCount);
+        for (int i = 0; i < m_ProgramCount; ++i)
+        {
+            std::ostringstream features;
+            for (int f = 0; f < 3; ++f)
+            {
+                if (i & (1 << f))
+                    features << FeatureNames[f] << '|';
+            }
+            float t = (float)i / m_ProgramCount;
+            features << "TINT=vec3(" << 0.5f + 0.5f * t << ", " << 1.0f - 0.5f * t << ", " << 0.5f + 0.001f * (m_Generation % 500) << ")";
+            ShaderPreprocessor::Process(ShaderPath, ShaderPreprocessor::ParseDefines(features.str()), sources[i]);
+        }
+        m_PreprocessMs = Milliseconds(Clock::now() - start).count();
+
+        m_CompileStart = Clock::now();
+        for (int i = 0; i < m_ProgramCount; ++i)
+        {
+            m_Programs.push_back(std::make_unique<Shader>(ShaderPath, sources[i], wait));
+            if (!wait)
+                m_Queue.Add(*m_Programs.back());
+        }
+        m_SubmitMs = Milliseconds(Clock::now() - m_CompileStart).count();
+
+        m_WorstFrameMs = 0.0;
+        m_CompileFrames = 0;
+        m_Compiling = !wait;
+        if (wait)
+        {
+            m_TotalMs = m_BlockingMs = m_SubmitMs;
+            std::cout << "Shader compile: " << m_ProgramCount << " programs one by one in " << m_TotalMs << " ms" << std::endl;
+        }
+        m_LastFrame = Clock::now();
+    }
+
+    void TestShaderCompile::OnUpdate(float deltatime)
+    {
+        m_Time += deltatime > 0.0f ? deltatime : 1.0f / 60.0f;
+    }
+
+    void TestShaderCompile::OnRender()
+    {
+        Clock::time_point now = Clock::now();
+        if (m_Compiling)
+        {
+            m_WorstFrameMs = std::max(m_WorstFrameMs, Milliseconds(now - m_LastFrame).count());
+            ++m_CompileFrames;
+            m_Queue.SetWaitBudget(m_WaitBudget);
+            m_Queue.Update();
+            if (m_Queue.IsIdle())
+            {
+                m_Compiling = false;
+                m_TotalMs = m_ParallelMs = Milliseconds(Clock::now() - m_CompileStart).count();
+                std::cout << "Shader compile: " << m_ProgramCount << " programs submitted in " << m_SubmitMs << " ms, ready after "
+                    << m_TotalMs << " ms and " << m_CompileFrames << " frames (parallel compile "
+                    << (Shader::HasParallelCompile() ? "on" : "off") << ")" << std::endl;
+            }
+        }
+        m_LastFrame = now;
+
+        CALLGL(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+
+        int columns = (int)std::ceil(std::sqrt((float)m_Programs.size()));
+        // cells are 16:9 like the window
+        glm::mat4 proj = glm::ortho(-1.0f, columns * 1.78f - 0.78f, -1.0f, (float)columns, -1.0f, 1.0f);
+
+        Renderer renderer;
+        for (size_t i = 0; i < m_Programs.size(); ++i)
+        {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3((float)(i % columns) * 1.78f, (float)(i / columns), 0.0f));
+            model = glm::rotate(model, std::sin(m_Time + i * 0.2f) * 0.3f, glm::vec3(0.0f, 0.0f, 1.0f));
+            model = glm::scale(model, glm::vec3(0.9f));
+
+            // keep drawing, just not with what isn't there yet
+            Shader& program = *m_Programs[i];
+            Shader& shader = program.IsReady() && program.IsLinked() ? program : *m_Fallback;
+            shader.Bind();
+            shader.SetUniformMat4f("u_MVP", proj * model);
+            if (&shader == &program)
+                shader.SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f);
+            renderer.Draw(*m_VAO, *m_IndexBuffer, shader);
+        }
+    }
+    void TestShaderCompile::OnImGuiRender()
+    {
+        ImGui::SliderInt("Programs", &m_ProgramCount, 8, 256);
+        ImGui::SliderInt("Programs waited for per frame", &m_WaitBudget, 1, 16);
+        if (ImGui::Button("Compile one by one"))
+            Compile(true);
+        ImGui::SameLine();
+        if (ImGui::Button("Submit all"))
+            Compile(false);
+
+        ImGui::Text("parallel shader compile: %s", Shader::HasParallelCompile() ? "yes" : "no (queue waits per frame)");
+        ImGui::Text("%.1f ms preprocessing, %.1f ms submitting", m_PreprocessMs, m_SubmitMs);
+        if (m_Compiling)
+            ImGui::Text("%u programs pending, %u frames so far", m_Queue.GetPendingCount(), m_CompileFrames);
+        else
+            ImGui::Text("ready after %.1f ms, %u frames drawn meanwhile, worst frame %.1f ms", m_TotalMs, m_CompileFrames, m_WorstFrameMs);
+        ImGui::Text("startup compile: %.1f ms one by one, %.1f ms submitted together", m_BlockingMs, m_ParallelMs);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
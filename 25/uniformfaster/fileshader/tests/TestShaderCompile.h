@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../IndexBuffer.h"
+#include "../ShaderCompileQueue.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace test {
+
+	// compiles a batch of distinct Material.shader programs one after the
+	// other (each waiting for its status) or submits them all and keeps
+	// drawing with a fallback shader while ShaderCompileQueue finishes them
+	class TestShaderCompile : public Test
+	{
+	public:
+		TestShaderCompile();
+		~TestShaderCompile();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		void Compile(bool wait);
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Shader> m_Fallback;
+		std::vector<std::unique_ptr<Shader>> m_Programs;
+		ShaderCompileQueue m_Queue;
+
+		int m_ProgramCount;
+		int m_WaitBudget;
+		unsigned int m_Generation; // makes every batch new to the driver's cache
+		float m_Time;
+
+		bool m_Compiling;
+		Clock::time_point m_CompileStart;
+		Clock::time_point m_LastFrame;
+		double m_PreprocessMs;
+		double m_SubmitMs;
+		double m_TotalMs;
+		double m_WorstFrameMs;
+		unsigned int m_CompileFrames;
+		double m_BlockingMs; // the last run that waited for every program
+		double m_ParallelMs; // the last run through the queue
+	};
+} // namespace test
@@ -0,0 +1,117 @@
+#include "TestShaderOptimizer.h"
+
+#include <cmath>
+
+#include "../Renderer.h"
+#include "../ShaderPreprocessor.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+
+struct LayerVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+};
+VERTEX_LAYOUT(LayerVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord));
+
+namespace test {
+    // a shader the tests really draw with, the variant with the most code
+    static const char* ShaderPath = "res/shaders/Material.shader";
+    static const std::vector<std::string> Defines = { "LIT", "TEXTURED" };
+
+    TestShaderOptimizer::TestShaderOptimizer() :
+        m_SourceBytes{ 0, 0 },
+        m_Layers(8),
+        m_Time(0.0f),
+        m_Frame(0)
+    {
+        // already in clip space, u_MVP stays the identity
+        glm::vec3 normal(0.3f, 0.4f, 1.0f);
+        LayerVertex vertices[] = {
+            { { -1.0f, -1.0f, 0.0f }, normal, { 0.0f, 0.0f } },
+            { {  1.0f, -1.0f, 0.0f }, normal, { 1.0f, 0.0f } },
+            { {  1.0f,  1.0f, 0.0f }, normal, { 1.0f, 1.0f } },
+            { { -1.0f,  1.0f, 0.0f }, normal, { 0.0f, 1.0f } },
+        };
+        unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+        m_VAO = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(vertices, (unsigned int)sizeof(vertices));
+        m_VAO->AddBuffer<LayerVertex>(*m_VertexBuffer);
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+        m_Texture = std::make_unique<Texture>("res/textures/ChernoLogo.png");
+
+        // the same path both ways, only where the sources come from changes.
+        // as written is the file or nothing, never the embedded copy
+        bool fileOverride = ShaderPreprocessor::HasFileOverride();
+        ShaderPreprocessor::SetFileOverride(false);
+        for (int optimized = 0; optimized < 2; ++optimized)
+        {
+            ShaderProgramSources sources;
+            bool read = optimized ? ShaderPreprocessor::Process(ShaderPath, Defines, sources)
+                : ShaderPreprocessor::ProcessFile(ShaderPath, Defines, sources);
+            if (!read)
+                continue;
+            m_SourceBytes[optimized] = (unsigned int)(sources.VertexSource.size() + sources.FragmentSource.size());
+            m_Programs[optimized] = std::make_unique<Shader>(std::string(ShaderPath) + (optimized ? " (optimized)" : ""), sources);
+        }
+        ShaderPreprocessor::SetFileOverride(fileOverride);
+    }
+    TestShaderOptimizer::~TestShaderOptimizer()
+    {
+    }
+
+    void TestShaderOptimizer::OnUpdate(float deltatime)
+    {
+        m_Time += deltatime;
+    }
+    void TestShaderOptimizer::OnRender()
+    {
+        CALLGL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+
+        for (GpuTimer& timer : m_GpuTimers)
+            timer.Poll();
+
+        // both draw the same picture, so alternating doesn't flicker
+        int current = ++m_Frame & 1;
+        if (!m_Programs[current])
+            current ^= 1;
+        Shader& shader = *m_Programs[current];
+
+        CALLGL(glEnable(GL_BLEND));
+        CALLGL(glBlendFunc(GL_ONE, GL_ONE));
+        m_GpuTimers[current].Begin();
+        Renderer renderer;
+        m_Texture->Bind(0);
+        shader.Bind();
+        shader.SetUniformMat4f("u_MVP", glm::mat4(1.0f));
+        shader.SetUniform1i("u_Texture", 0);
+        for (int layer = 0; layer < m_Layers; ++layer)
+        {
+            // layers are blended additively, keep each one dim
+            float pulse = 0.5f + 0.5f * std::sin(m_Time + layer);
+            shader.SetUniform4f("u_Color", 0.5f / m_Layers, pulse / m_Layers, 1.0f / m_Layers, 1.0f);
+            renderer.Draw(*m_VAO, *m_IndexBuffer, shader);
+        }
+        m_GpuTimers[current].End();
+        CALLGL(glDisable(GL_BLEND));
+    }
+    void TestShaderOptimizer::OnImGuiRender()
+    {
+        ImGui::SliderInt("Full screen layers", &m_Layers, 1, 32);
+        // nothing to compare against, the optimized copy alone says nothing
+        if (!m_Programs[0])
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "as written: %s not found, only the embedded copy runs", ShaderPath);
+        else
+            ImGui::Text("as written: %u bytes, %.3f ms GPU", m_SourceBytes[0], m_GpuTimers[0].GetMs());
+        ImGui::Text("optimized:  %u bytes, %.3f ms GPU", m_SourceBytes[1], m_GpuTimers[1].GetMs());
+        if (m_GpuTimers[0].GetMs() > 0.0 && m_GpuTimers[1].GetMs() > 0.0)
+            ImGui::Text("%.0f%% of the fragment time", 100.0 * m_GpuTimers[1].GetMs() / m_GpuTimers[0].GetMs());
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
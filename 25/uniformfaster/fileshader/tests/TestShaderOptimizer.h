@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../Texture.h"
+#include "../GpuTimer.h"
+
+#include <memory>
+
+namespace test {
+
+	// full screen layers of Material.shader (LIT|TEXTURED) blended on top
+	// of each other, as written next to the copy tools/glsl_optimizer.py
+	// made of it. frames alternate between the two and time each
+	class TestShaderOptimizer : public Test
+	{
+	public:
+		TestShaderOptimizer();
+		~TestShaderOptimizer();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Texture> m_Texture;
+		// 0 from res/shaders, 1 embedded and optimized
+		std::unique_ptr<Shader> m_Programs[2];
+		unsigned int m_SourceBytes[2];
+
+		int m_Layers;
+		float m_Time;
+		unsigned int m_Frame;
+
+		GpuTimer m_GpuTimers[2];
+	};
+} // namespace test
@@ -0,0 +1,108 @@
+#include "TestShaderReflection.h"
+
+#include "../Renderer.h"
+#include "../VertexBufferLayout.h"
+#include "../ShaderReflection.h"
+#include "imgui/imgui.h"
+
+namespace test {
+    TestShaderReflection::TestShaderReflection() :
+        m_Shader(0)
+    {
+        m_ShaderNames = { "Basic", "Sprite", "Mesh", "MeshTextured", "Tilemap", "Material", "Material LIT|TEXTURED|VERTEX_COLOR" };
+        m_Shaders.push_back(std::make_unique<Shader>("res/shaders/Basic.shader"));
+        m_Shaders.push_back(std::make_unique<Shader>("res/shaders/Sprite.shader"));
+        m_Shaders.push_back(std::make_unique<Shader>("res/shaders/Mesh.shader"));
+        m_Shaders.push_back(std::make_unique<Shader>("res/shaders/MeshTextured.shader"));
+        m_Shaders.push_back(std::make_unique<Shader>("res/shaders/Tilemap.shader"));
+        m_Shaders.push_back(std::make_unique<Shader>("res/shaders/Material.shader"));
+        m_Shaders.push_back(std::make_unique<Shader>("res/shaders/Material.shader", std::vector<std::string>{ "LIT", "TEXTURED", "VERTEX_COLOR" }));
+
+        // nothing gets drawn, the arrays only need a buffer to point at
+        m_VertexBuffer = std::make_unique<VertexBuffer>(nullptr, 1024);
+
+        VertexBufferLayout quad;
+        quad.Push<float>(2);
+        quad.Push<float>(2);
+        m_ArrayNames.push_back("vec2 position, vec2 texCoord");
+        m_Arrays.push_back(std::make_unique<VertexArray>());
+        m_Arrays.back()->AddBuffer(*m_VertexBuffer, quad);
+
+        VertexBufferLayout mesh;
+        mesh.Push<float>(3);
+        mesh.Push<float>(3);
+        mesh.Push<float>(2);
+        mesh.Push<unsigned char>(4);
+        m_ArrayNames.push_back("vec3 position, vec3 normal, vec2 texCoord, u8 color");
+        m_Arrays.push_back(std::make_unique<VertexArray>());
+        m_Arrays.back()->AddBuffer(*m_VertexBuffer, mesh);
+
+        // colors read with glVertexAttribIPointer by mistake
+        VertexBufferLayout integerColor;
+        integerColor.Push<float>(3);
+        integerColor.Push<float>(3);
+        integerColor.Push<float>(2);
+        integerColor.PushInteger<unsigned char>(4);
+        m_ArrayNames.push_back("vec3 position, vec3 normal, vec2 texCoord, integer u8 color");
+        m_Arrays.push_back(std::make_unique<VertexArray>());
+        m_Arrays.back()->AddBuffer(*m_VertexBuffer, integerColor);
+
+        VertexBufferLayout tiles;
+        tiles.PushInteger<unsigned char>(2);
+        tiles.PushInteger<unsigned short>(1);
+        m_ArrayNames.push_back("integer u8 corner, integer u16 tile");
+        m_Arrays.push_back(std::make_unique<VertexArray>());
+        m_Arrays.back()->AddBuffer(*m_VertexBuffer, tiles);
+    }
+    TestShaderReflection::~TestShaderReflection()
+    {
+    }
+
+    void TestShaderReflection::OnRender()
+    {
+        CALLGL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+    }
+    void TestShaderReflection::OnImGuiRender()
+    {
+        std::vector<const char*> names;
+        for (const std::string& name : m_ShaderNames)
+            names.push_back(name.c_str());
+        ImGui::Combo("Shader", &m_Shader, names.data(), (int)names.size());
+
+        const ShaderReflection& reflection = m_Shaders[m_Shader]->GetReflection();
+        ImGui::Text("attributes");
+        for (const ShaderAttribute& attribute : reflection.GetAttributes())
+            ImGui::Text("  location %d: %s %s", attribute.location, ShaderReflection::GetTypeName(attribute.type), attribute.name.c_str());
+        ImGui::Text("uniforms");
+        for (const ShaderUniform& uniform : reflection.GetUniforms())
+        {
+            if (uniform.block == -1)
+                ImGui::Text("  location %d: %s %s", uniform.location, ShaderReflection::GetTypeName(uniform.type), uniform.name.c_str());
+            else
+                ImGui::Text("  block %d + %d: %s %s", uniform.block, uniform.offset, ShaderReflection::GetTypeName(uniform.type), uniform.name.c_str());
+        }
+        ImGui::Text("uniform blocks");
+        for (const ShaderUniformBlock& block : reflection.GetUniformBlocks())
+            ImGui::Text("  %s: %d bytes, binding %d", block.name.c_str(), block.size, block.binding);
+        ImGui::Text("samplers");
+        for (const ShaderUniform& sampler : reflection.GetSamplers())
+            ImGui::Text("  %s %s", ShaderReflection::GetTypeName(sampler.type), sampler.name.c_str());
+
+        VertexBufferLayout layout;
+        if (reflection.MakeVertexLayout(layout))
+            ImGui::Text("generated layout: %u attributes, %u byte stride", (unsigned int)layout.GetElements().size(), layout.GetStride());
+        else
+            ImGui::Text("no layout, the input locations have gaps");
+
+        ImGui::Separator();
+        for (size_t i = 0; i < m_Arrays.size(); ++i)
+        {
+            std::vector<std::string> problems = reflection.CheckVertexArray(*m_Arrays[i]);
+            ImGui::Text("%s: %s", m_ArrayNames[i].c_str(), problems.empty() ? "matches" : "");
+            for (const std::string& problem : problems)
+                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.3f, 1.0f), "  %s", problem.c_str());
+        }
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
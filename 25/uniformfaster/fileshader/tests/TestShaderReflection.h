@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../Shader.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace test {
+
+	// lists what every shader in res/shaders reads and checks it against
+	// a few vertex arrays, the same check debug builds run on every draw
+	class TestShaderReflection : public Test
+	{
+	public:
+		TestShaderReflection();
+		~TestShaderReflection();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		std::vector<std::string> m_ShaderNames;
+		std::vector<std::unique_ptr<Shader>> m_Shaders;
+		std::vector<std::string> m_ArrayNames;
+		std::vector<std::unique_ptr<VertexArray>> m_Arrays;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		int m_Shader;
+	};
+} // namespace test
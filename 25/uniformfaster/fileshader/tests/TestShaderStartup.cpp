@@ -0,0 +1,145 @@
+#include "TestShaderStartup.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "../Renderer.h"
+#include "../EmbeddedShaders.h"
+#include "../ShaderPreprocessor.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+struct StartupVertex
+{
+    glm::vec2 position;
+    glm::vec2 texCoord;
+};
+VERTEX_LAYOUT(StartupVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(texCoord));
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    TestShaderStartup::TestShaderStartup() :
+        m_Repeats(50),
+        m_FileOverride(ShaderPreprocessor::HasFileOverride()),
+        m_LoadCount(0),
+        m_FileMs(0.0),
+        m_EmbeddedMs(0.0),
+        m_CompileMs(0.0),
+        m_FileFailures(0)
+    {
+        StartupVertex vertices[] = {
+            { { 352.0f, 142.0f }, { 0.0f, 0.0f } },
+            { { 608.0f, 142.0f }, { 1.0f, 0.0f } },
+            { { 608.0f, 398.0f }, { 1.0f, 1.0f } },
+            { { 352.0f, 398.0f }, { 0.0f, 1.0f } },
+        };
+        unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+        m_VAO = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(vertices, (unsigned int)sizeof(vertices));
+        m_VAO->AddBuffer<StartupVertex>(*m_VertexBuffer);
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+        // checked while compiling, a typo in the path doesn't build
+        m_Shader = std::make_unique<Shader>(EMBEDDED_SHADER("res/shaders/Basic.shader").Path);
+        m_Shader->Bind();
+        m_Shader->SetUniformMat4f("u_MVP", glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f));
+        m_Shader->SetUniform1i("u_Texture", 0);
+        m_Texture = std::make_unique<Texture>("res/textures/Glow.png");
+
+        Measure();
+    }
+    TestShaderStartup::~TestShaderStartup()
+    {
+        ShaderPreprocessor::SetFileOverride(m_FileOverride);
+    }
+
+    void TestShaderStartup::Measure()
+    {
+        bool fileOverride = ShaderPreprocessor::HasFileOverride();
+        m_LoadCount = EmbeddedShaders::Count * m_Repeats;
+        m_FileFailures = 0;
+        m_Stale.clear();
+
+        // files only, a missing one must not quietly come from the executable.
+        // one pass first, timing loads that fail would say nothing
+        ShaderProgramSources sources;
+        for (const EmbeddedShaders::Entry& entry : EmbeddedShaders::Table)
+        {
+            if (!ShaderPreprocessor::ProcessFile(entry.Path, {}, sources))
+                ++m_FileFailures;
+            else if (ShaderPreprocessor::Hash(sources) != entry.SourceHash)
+                // a file edited since the last build, the executable has the old text
+                m_Stale.push_back(entry.Path);
+        }
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < m_Repeats && !m_FileFailures; ++i)
+        {
+            for (const EmbeddedShaders::Entry& entry : EmbeddedShaders::Table)
+                ShaderPreprocessor::ProcessFile(entry.Path, {}, sources);
+        }
+        m_FileMs = m_FileFailures ? 0.0 : Milliseconds(Clock::now() - start).count();
+
+        ShaderPreprocessor::SetFileOverride(false);
+        start = Clock::now();
+        for (int i = 0; i < m_Repeats; ++i)
+        {
+            for (const EmbeddedShaders::Entry& entry : EmbeddedShaders::Table)
+                ShaderPreprocessor::Process(entry.Path, {}, sources);
+        }
+        m_EmbeddedMs = Milliseconds(Clock::now() - start).count();
+        ShaderPreprocessor::SetFileOverride(fileOverride);
+
+        // once each, drivers cache programs they have seen
+        start = Clock::now();
+        for (const EmbeddedShaders::Entry& entry : EmbeddedShaders::Table)
+            Shader shader(entry.Path);
+        m_CompileMs = Milliseconds(Clock::now() - start).count();
+
+        std::cout << "Shader startup: " << m_LoadCount << " loads, files " << m_FileMs << " ms, embedded "
+            << m_EmbeddedMs << " ms, compiling " << EmbeddedShaders::Count << " shaders " << m_CompileMs << " ms" << std::endl;
+    }
+
+    void TestShaderStartup::OnUpdate(float deltatime)
+    {}
+    void TestShaderStartup::OnRender()
+    {
+        CALLGL(glClearColor(0.1f, 0.1f, 0.15f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+        CALLGL(glEnable(GL_BLEND));
+        CALLGL(glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+
+        Renderer renderer;
+        m_Texture->Bind(0);
+        renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+        CALLGL(glDisable(GL_BLEND));
+    }
+    void TestShaderStartup::OnImGuiRender()
+    {
+        bool fileOverride = ShaderPreprocessor::HasFileOverride();
+        if (ImGui::Checkbox("Read res/shaders when there (file override)", &fileOverride))
+            ShaderPreprocessor::SetFileOverride(fileOverride);
+        ImGui::SliderInt("Loads per shader", &m_Repeats, 1, 500);
+        if (ImGui::Button("Measure"))
+            Measure();
+
+        ImGui::Text("%u shaders embedded, %u loads", EmbeddedShaders::Count, m_LoadCount);
+        if (m_FileFailures)
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "from files:    %u of %u not found, working directory without res/shaders?",
+                m_FileFailures, EmbeddedShaders::Count);
+        else
+            ImGui::Text("from files:    %.3f ms (%.1f us each)", m_FileMs, 1000.0 * m_FileMs / m_LoadCount);
+        ImGui::Text("embedded:      %.3f ms (%.1f us each)", m_EmbeddedMs, 1000.0 * m_EmbeddedMs / m_LoadCount);
+        ImGui::Text("compiling all: %.3f ms", m_CompileMs);
+        if (m_Stale.empty() && !m_FileFailures)
+            ImGui::Text("embedded copies match the files");
+        for (const std::string& path : m_Stale)
+            ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "%s changed since the build", path.c_str());
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../Texture.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace test {
+
+	// what startup spends on shaders: getting the sources of every shader
+	// from res/shaders or from the copies embedded in the executable, and
+	// compiling them. also lists embedded shaders older than their files
+	class TestShaderStartup : public Test
+	{
+	public:
+		TestShaderStartup();
+		~TestShaderStartup();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void Measure();
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Shader> m_Shader;
+		std::unique_ptr<Texture> m_Texture;
+
+		int m_Repeats; // every shader loaded this many times, a bigger project
+		bool m_FileOverride;
+
+		unsigned int m_LoadCount;
+		double m_FileMs;
+		double m_EmbeddedMs;
+		double m_CompileMs;
+		unsigned int m_FileFailures;
+		std::vector<std::string> m_Stale;
+	};
+} // namespace test
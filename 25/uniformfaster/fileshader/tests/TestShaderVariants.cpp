@@ -0,0 +1,171 @@
+#include "TestShaderVariants.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "../Renderer.h"
+#include "../VertexBufferLayout.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+struct VariantVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(VariantVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord),
+    VERTEX_ATTRIB(color));
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const char* ShaderPath = "res/shaders/Material.shader";
+
+    // what materials ask for. SKINNED and FOG aren't in the shader and
+    // some sets only differ in order, so they share programs
+    static const char* FeatureSets[] = {
+        "",
+        "LIT",
+        "TEXTURED",
+        "TEXTURED|LIT",
+        "LIT|TEXTURED",
+        "VERTEX_COLOR",
+        "VERTEX_COLOR|LIT",
+        "TEXTURED|VERTEX_COLOR",
+        "TEXTURED|VERTEX_COLOR|LIT",
+        "LIT|VERTEX_COLOR|TEXTURED|LIT",
+        "CHECKER|LIT",
+        "CHECKER|TEXTURED|LIT",
+        "SKINNED|LIT",
+        "FOG|TEXTURED|LIT",
+        "CHECKER|VERTEX_COLOR|LIT|SKINNED",
+    };
+
+    TestShaderVariants::TestShaderVariants() :
+        m_MaterialCount(256),
+        m_Time(0.0f),
+        m_CreateMs(0.0)
+    {
+        // cube with a color per face
+        std::vector<VariantVertex> vertices;
+        std::vector<unsigned int> indices;
+        for (int face = 0; face < 6; ++face)
+        {
+            glm::vec3 n(0.0f), u(0.0f);
+            n[face / 2] = face % 2 ? -1.0f : 1.0f;
+            u[(face / 2 + 1) % 3] = 1.0f;
+            glm::vec3 v = glm::cross(n, u);
+            glm::u8vec4 color(face & 1 ? 255 : 120, face & 2 ? 255 : 120, face & 4 ? 255 : 120, 255);
+            unsigned int base = (unsigned int)vertices.size();
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                glm::vec2 uv(corner & 1, corner >> 1);
+                vertices.push_back({ 0.5f * n + (uv.x - 0.5f) * u + (uv.y - 0.5f) * v, n, uv, color });
+            }
+            indices.insert(indices.end(), { base, base + 1, base + 3, base, base + 3, base + 2 });
+        }
+        m_VertexBuffer = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(VariantVertex)));
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+        m_VAO = std::make_unique<VertexArray>();
+        m_VAO->AddBuffer<VariantVertex>(*m_VertexBuffer);
+        m_Texture = std::make_unique<Texture>("res/textures/ChernoLogo.png");
+
+        CreateMaterials();
+    }
+    TestShaderVariants::~TestShaderVariants()
+    {
+    }
+
+    void TestShaderVariants::CreateMaterials()
+    {
+        // a fresh cache, so every program gets compiled again
+        m_Materials.clear();
+        m_Cache = std::make_unique<ShaderVariantCache>();
+
+        std::mt19937 rng(41);
+        std::uniform_int_distribution<int> pick(0, IM_ARRAYSIZE(FeatureSets) - 1);
+        std::uniform_real_distribution<float> unit(0.3f, 1.0f);
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < m_MaterialCount; ++i)
+        {
+            Material material;
+            material.features = FeatureSets[pick(rng)];
+            material.shader = m_Cache->GetVariant(ShaderPath, material.features);
+            material.textured = material.features.find("TEXTURED") != std::string::npos;
+            material.color = glm::vec4(unit(rng), unit(rng), unit(rng), 1.0f);
+            m_Materials.push_back(material);
+        }
+        m_CreateMs = Milliseconds(Clock::now() - start).count();
+
+        std::cout << "Shader variants: " << m_Cache->GetRequestCount() << " requests, " << m_Cache->GetVariantCount()
+            << " feature sets, " << m_Cache->GetProgramCount() << " programs compiled in " << m_Cache->GetCompileMs()
+            << " ms (" << m_Cache->GetDeduplicatedCount() << " deduplicated)" << std::endl;
+    }
+
+    void TestShaderVariants::OnUpdate(float deltatime)
+    {
+        m_Time += deltatime > 0.0f ? deltatime : 1.0f / 60.0f;
+    }
+
+    void TestShaderVariants::OnRender()
+    {
+        CALLGL(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        CALLGL(glEnable(GL_DEPTH_TEST));
+        CALLGL(glEnable(GL_CULL_FACE));
+
+        int columns = (int)std::ceil(std::sqrt((float)m_Materials.size()));
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), 960.0f / 540.0f, 0.1f, 500.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, columns * 0.9f, columns * 1.6f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 viewProj = proj * view;
+
+        Renderer renderer;
+        m_Texture->Bind(0);
+        for (size_t i = 0; i < m_Materials.size(); ++i)
+        {
+            Material& material = m_Materials[i];
+            // Material.shader couldn't be read
+            if (!material.shader)
+                continue;
+            glm::vec3 position((i % columns - columns * 0.5f) * 1.8f, 0.0f, (i / columns - columns * 0.5f) * 1.8f);
+            glm::mat4 model = glm::rotate(glm::translate(glm::mat4(1.0f), position), m_Time + i * 0.1f, glm::vec3(0.3f, 1.0f, 0.2f));
+
+            material.shader->Bind();
+            material.shader->SetUniformMat4f("u_MVP", viewProj * model);
+            material.shader->SetUniform4f("u_Color", material.color.r, material.color.g, material.color.b, material.color.a);
+            if (material.textured)
+                material.shader->SetUniform1i("u_Texture", 0);
+            renderer.Draw(*m_VAO, *m_IndexBuffer, *material.shader);
+        }
+        CALLGL(glDisable(GL_CULL_FACE));
+        CALLGL(glDisable(GL_DEPTH_TEST));
+    }
+    void TestShaderVariants::OnImGuiRender()
+    {
+        ImGui::SliderInt("Materials", &m_MaterialCount, 16, 1024);
+        if (ImGui::Button("Create materials"))
+            CreateMaterials();
+
+        ImGui::Text("%u variant requests, %u feature sets, %u programs", m_Cache->GetRequestCount(),
+            m_Cache->GetVariantCount(), m_Cache->GetProgramCount());
+        ImGui::Text("%u feature sets shared a program with another", m_Cache->GetDeduplicatedCount());
+        ImGui::Text("%.1f ms preprocessing, %.1f ms compiling, %.1f ms total", m_Cache->GetPreprocessMs(),
+            m_Cache->GetCompileMs(), m_CreateMs);
+        for (const char* features : FeatureSets)
+        {
+            if (Shader* shader = m_Cache->FindVariant(ShaderPath, features))
+                ImGui::Text("  %-34s %016llx", features[0] ? features : "(none)", (unsigned long long)shader->GetSourceHash());
+        }
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
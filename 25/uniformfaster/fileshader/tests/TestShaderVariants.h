@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../Texture.h"
+#include "../ShaderVariantCache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace test {
+
+	// a grid of cubes whose materials ask for random feature sets of
+	// Material.shader, in any order and with features it doesn't have.
+	// the cache compiles each distinct program once
+	class TestShaderVariants : public Test
+	{
+	public:
+		TestShaderVariants();
+		~TestShaderVariants();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		struct Material
+		{
+			std::string features;
+			Shader* shader;
+			bool textured;
+			glm::vec4 color;
+		};
+
+		void CreateMaterials();
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Texture> m_Texture;
+		std::unique_ptr<ShaderVariantCache> m_Cache;
+		std::vector<Material> m_Materials;
+
+		int m_MaterialCount;
+		float m_Time;
+		double m_CreateMs;
+	};
+} // namespace test
@@ -0,0 +1,228 @@
+#include "TestStaticBatching.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "../Renderer.h"
+#include "../Frustum.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const float ObjectSpacing = 2.5f;
+
+    enum MeshKind { CrateMesh, PillarMesh, TreeMesh, MeshCount };
+    enum MaterialKind { CrateMaterial, StoneMaterial, FoliageMaterial };
+
+    TestStaticBatching::TestStaticBatching() :
+        m_GridSize(120),
+        m_ChunkSize(40.0f),
+        m_UseBatching(true),
+        m_Culling(true),
+        m_Time(0.0f),
+        m_DrawCalls(0),
+        m_CpuMs(0.0)
+    {
+        m_TexturedShader = std::make_unique<Shader>("res/shaders/MeshTextured.shader");
+        m_ColorShader = std::make_unique<Shader>("res/shaders/Mesh.shader");
+        m_CrateTexture = std::make_unique<Texture>("res/textures/ChernoLogo.png");
+        m_StoneTexture = std::make_unique<Texture>("res/textures/Gradient.png");
+        BuildMeshes();
+        BuildScene();
+    }
+    TestStaticBatching::~TestStaticBatching()
+    {
+    }
+
+    void TestStaticBatching::BuildMeshes()
+    {
+        m_Meshes.resize(MeshCount);
+
+        // unit cube, 4 vertices per face for flat normals
+        Mesh& crate = m_Meshes[CrateMesh];
+        for (int face = 0; face < 6; ++face)
+        {
+            glm::vec3 n(0.0f);
+            n[face / 2] = face % 2 ? -1.0f : 1.0f;
+            glm::vec3 u(0.0f), v(0.0f);
+            u[(face / 2 + 1) % 3] = 1.0f;
+            v = glm::cross(n, u);
+            unsigned int base = (unsigned int)crate.vertices.size();
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                glm::vec2 uv(corner & 1, corner >> 1);
+                glm::vec3 p = 0.5f * n + (uv.x - 0.5f) * u + (uv.y - 0.5f) * v;
+                crate.vertices.push_back({ p, n, uv, glm::u8vec4(255) });
+            }
+            crate.indices.insert(crate.indices.end(), { base, base + 1, base + 3, base, base + 3, base + 2 });
+        }
+
+        // pillar and tree are both cones of rings around the y axis
+        auto lathe = [](Mesh& mesh, const std::vector<glm::vec2>& profile, int segments, glm::u8vec4 color) {
+            for (size_t ring = 0; ring < profile.size(); ++ring)
+            {
+                for (int s = 0; s <= segments; ++s)
+                {
+                    float a = s * 6.2831853f / segments;
+                    glm::vec3 dir(std::cos(a), 0.0f, std::sin(a));
+                    glm::vec2 slope = ring + 1 < profile.size() ? profile[ring + 1] - profile[ring] : profile[ring] - profile[ring - 1];
+                    glm::vec3 n = glm::normalize(dir * slope.y - glm::vec3(0.0f, slope.x, 0.0f));
+                    mesh.vertices.push_back({ dir * profile[ring].x + glm::vec3(0.0f, profile[ring].y, 0.0f), n,
+                        glm::vec2((float)s / segments, profile[ring].y), color });
+                }
+            }
+            unsigned int stride = segments + 1;
+            for (unsigned int ring = 0; ring + 1 < profile.size(); ++ring)
+            {
+                for (unsigned int s = 0; s < (unsigned int)segments; ++s)
+                {
+                    unsigned int a = ring * stride + s, b = a + stride;
+                    mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+                }
+            }
+        };
+        lathe(m_Meshes[PillarMesh], { { 0.45f, 0.0f }, { 0.35f, 0.2f }, { 0.3f, 2.6f }, { 0.45f, 2.8f }, { 0.0f, 2.9f } }, 12, glm::u8vec4(255));
+        lathe(m_Meshes[TreeMesh], { { 0.15f, 0.0f }, { 0.15f, 0.6f }, { 0.9f, 0.6f }, { 0.5f, 1.4f }, { 0.7f, 1.4f }, { 0.0f, 2.6f } }, 8,
+            glm::u8vec4(70, 150, 60, 255));
+
+        for (Mesh& mesh : m_Meshes)
+        {
+            mesh.radius = 0.0f;
+            for (const StaticBatch::Vertex& vertex : mesh.vertices)
+                mesh.radius = std::max(mesh.radius, glm::length(vertex.position));
+            mesh.vertexBuffer = std::make_unique<VertexBuffer>(mesh.vertices.data(), (unsigned int)(mesh.vertices.size() * sizeof(StaticBatch::Vertex)));
+            mesh.indexBuffer = std::make_unique<IndexBuffer>(mesh.indices.data(), (unsigned int)mesh.indices.size());
+            mesh.vao = std::make_unique<VertexArray>();
+            mesh.vao->AddBuffer<StaticBatch::Vertex>(*mesh.vertexBuffer);
+        }
+    }
+
+    void TestStaticBatching::BuildScene()
+    {
+        std::mt19937 rng(39);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        m_Objects.clear();
+        m_Batch = std::make_unique<StaticBatch>();
+        for (int z = 0; z < m_GridSize; ++z)
+        {
+            for (int x = 0; x < m_GridSize; ++x)
+            {
+                Object object;
+                float pick = unit(rng);
+                object.mesh = pick < 0.5f ? CrateMesh : pick < 0.7f ? PillarMesh : TreeMesh;
+                object.material = object.mesh == CrateMesh ? CrateMaterial : object.mesh == PillarMesh ? StoneMaterial : FoliageMaterial;
+
+                glm::vec3 position((x + unit(rng) * 0.5f) * ObjectSpacing, 0.0f, (z + unit(rng) * 0.5f) * ObjectSpacing);
+                float scale = 0.6f + unit(rng) * 0.8f;
+                if (object.mesh == CrateMesh)
+                    position.y = 0.5f * scale;
+                object.model = glm::translate(glm::mat4(1.0f), position);
+                object.model = glm::rotate(object.model, unit(rng) * 6.2831853f, glm::vec3(0.0f, 1.0f, 0.0f));
+                object.model = glm::scale(object.model, glm::vec3(scale));
+                object.center = position;
+                object.radius = m_Meshes[object.mesh].radius * scale;
+                m_Objects.push_back(object);
+
+                const Mesh& mesh = m_Meshes[object.mesh];
+                Shader& shader = object.material == FoliageMaterial ? *m_ColorShader : *m_TexturedShader;
+                const Texture* texture = object.material == CrateMaterial ? m_CrateTexture.get() :
+                    object.material == StoneMaterial ? m_StoneTexture.get() : nullptr;
+                m_Batch->Add(mesh.vertices.data(), (unsigned int)mesh.vertices.size(), mesh.indices.data(), (unsigned int)mesh.indices.size(),
+                    object.model, shader, texture);
+            }
+        }
+        m_Batch->Build(m_ChunkSize);
+
+        const StaticBatch::Stats& stats = m_Batch->GetStats();
+        std::cout << "Static batching: " << stats.objectCount << " objects -> " << stats.batchCount << " batches ("
+            << m_ChunkSize << " unit chunks) in " << stats.buildMs << " ms, "
+            << stats.sourceBytes / 1024.0 << " KB of meshes -> " << stats.batchBytes / (1024.0 * 1024.0) << " MB batched" << std::endl;
+    }
+
+    void TestStaticBatching::OnUpdate(float deltatime)
+    {
+        m_Time += deltatime > 0.0f ? deltatime : 1.0f / 60.0f;
+    }
+
+    void TestStaticBatching::OnRender()
+    {
+        CALLGL(glClearColor(0.45f, 0.6f, 0.8f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        CALLGL(glEnable(GL_DEPTH_TEST));
+        CALLGL(glEnable(GL_CULL_FACE));
+
+        m_GpuTimer.Poll();
+
+        // circle over the town looking down at it
+        float extent = m_GridSize * ObjectSpacing;
+        glm::vec3 center(extent * 0.5f, 0.0f, extent * 0.5f);
+        float angle = m_Time * 0.15f;
+        glm::vec3 eye = center + glm::vec3(std::cos(angle) * extent * 0.3f, 12.0f, std::sin(angle) * extent * 0.3f);
+        glm::vec3 target = center + glm::vec3(std::cos(angle + 1.2f) * extent * 0.4f, 0.0f, std::sin(angle + 1.2f) * extent * 0.4f);
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), 960.0f / 540.0f, 0.1f, 400.0f);
+        glm::mat4 viewProj = proj * glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+        Frustum frustum(viewProj);
+
+        Renderer renderer;
+        m_GpuTimer.Begin();
+        Clock::time_point start = Clock::now();
+        m_DrawCalls = 0;
+        if (m_UseBatching)
+        {
+            m_DrawCalls = m_Batch->Draw(renderer, viewProj, m_Culling ? &frustum : nullptr);
+        }
+        else
+        {
+            unsigned int boundMaterial = (unsigned int)-1;
+            for (const Object& object : m_Objects)
+            {
+                if (m_Culling && !frustum.IsSphereVisible(object.center, object.radius))
+                    continue;
+
+                Shader& shader = object.material == FoliageMaterial ? *m_ColorShader : *m_TexturedShader;
+                if (object.material != boundMaterial)
+                {
+                    shader.Bind();
+                    if (object.material != FoliageMaterial)
+                    {
+                        (object.material == CrateMaterial ? m_CrateTexture : m_StoneTexture)->Bind(0);
+                        shader.SetUniform1i("u_Texture", 0);
+                    }
+                    boundMaterial = object.material;
+                }
+                const Mesh& mesh = m_Meshes[object.mesh];
+                shader.SetUniformMat4f("u_MVP", viewProj * object.model);
+                renderer.Draw(*mesh.vao, *mesh.indexBuffer, shader);
+                ++m_DrawCalls;
+            }
+        }
+        m_CpuMs = Milliseconds(Clock::now() - start).count();
+        m_GpuTimer.End();
+        CALLGL(glDisable(GL_CULL_FACE));
+        CALLGL(glDisable(GL_DEPTH_TEST));
+    }
+    void TestStaticBatching::OnImGuiRender()
+    {
+        bool rebuild = ImGui::SliderInt("Objects per side", &m_GridSize, 10, 250);
+        rebuild |= ImGui::SliderFloat("Chunk size", &m_ChunkSize, 5.0f, 200.0f);
+        if (rebuild)
+            BuildScene();
+        ImGui::Checkbox("Static batching", &m_UseBatching);
+        ImGui::Checkbox("Frustum culling", &m_Culling);
+
+        const StaticBatch::Stats& stats = m_Batch->GetStats();
+        ImGui::Text("%u objects in %u batches, built in %.1f ms", stats.objectCount, stats.batchCount, stats.buildMs);
+        ImGui::Text("memory: %.1f KB of meshes, %.2f MB batched (%.0fx)", stats.sourceBytes / 1024.0,
+            stats.batchBytes / (1024.0 * 1024.0), (double)stats.batchBytes / stats.sourceBytes);
+        ImGui::Text("%u draw calls, %.3f ms CPU submit, %.3f ms GPU", m_DrawCalls, m_CpuMs, m_GpuTimer.GetMs());
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
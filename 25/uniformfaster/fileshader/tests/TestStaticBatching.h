@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../Texture.h"
+#include "../StaticBatch.h"
+#include "../GpuTimer.h"
+
+#include <memory>
+#include <vector>
+
+namespace test {
+
+	// a town of crates, pillars and trees that never move, drawn one
+	// Renderer::Draw per object or merged by StaticBatch into a draw per
+	// material and chunk. both paths frustum cull
+	class TestStaticBatching : public Test
+	{
+	public:
+		TestStaticBatching();
+		~TestStaticBatching();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		struct Mesh
+		{
+			std::vector<StaticBatch::Vertex> vertices;
+			std::vector<unsigned int> indices;
+			std::unique_ptr<VertexBuffer> vertexBuffer;
+			std::unique_ptr<IndexBuffer> indexBuffer;
+			std::unique_ptr<VertexArray> vao;
+			float radius;
+		};
+
+		struct Object
+		{
+			unsigned int mesh;
+			unsigned int material; // MaterialKind: crate or stone texture, or untextured foliage
+			glm::mat4 model;
+			glm::vec3 center;
+			float radius;
+		};
+
+		void BuildMeshes();
+		void BuildScene();
+
+		std::vector<Mesh> m_Meshes;
+		std::vector<Object> m_Objects;
+		std::unique_ptr<Shader> m_TexturedShader;
+		std::unique_ptr<Shader> m_ColorShader;
+		std::unique_ptr<Texture> m_CrateTexture;
+		std::unique_ptr<Texture> m_StoneTexture;
+		std::unique_ptr<StaticBatch> m_Batch;
+
+		int m_GridSize; // objects per side
+		float m_ChunkSize;
+		bool m_UseBatching;
+		bool m_Culling;
+		float m_Time;
+
+		unsigned int m_DrawCalls;
+		double m_CpuMs;
+
+		GpuTimer m_GpuTimer;
+	};
+} // namespace test
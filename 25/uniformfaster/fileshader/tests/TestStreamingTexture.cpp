@@ -0,0 +1,136 @@
+#include "TestStreamingTexture.h"
+
+#include <algorithm>
+
+#include "../Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test {
+    TestStreamingTexture::TestStreamingTexture() :
+        m_Resolution(0),
+        m_UploadsPerFrame(1),
+        m_DirtyRectOnly(false),
+        m_Frame(0),
+        m_WindowStart(std::chrono::steady_clock::now()),
+        m_WindowStartBytes(0),
+        m_MBPerSecond(0.0),
+        m_CpuMsPerUpload(0.0)
+    {
+        // whole window
+        float positions[] = {
+              0.0f,   0.0f, 0.0f, 0.0f,
+            960.0f,   0.0f, 1.0f, 0.0f,
+            960.0f, 540.0f, 1.0f, 1.0f,
+              0.0f, 540.0f, 0.0f, 1.0f,
+        };
+        unsigned int indices[] = {
+            0,1,2,
+            2,3,0,
+        };
+
+        m_VAO = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(positions, _countof(positions) * sizeof(float));
+
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        m_VAO->AddBuffer(*m_VertexBuffer, layout);
+
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, _countof(indices));
+
+        m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader");
+        m_Shader->Bind();
+        m_Shader->SetUniformMat4f("u_MVP", glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f));
+        m_Shader->SetUniform1i("u_Texture", 0);
+
+        CreateTexture();
+    }
+    TestStreamingTexture::~TestStreamingTexture()
+    {}
+
+    void TestStreamingTexture::CreateTexture()
+    {
+        m_Texture.reset();
+        if (m_Resolution == 0)
+            m_Texture = std::make_unique<StreamingTexture>(1920, 1080);
+        else
+            m_Texture = std::make_unique<StreamingTexture>(3840, 2160);
+
+        m_WindowStart = std::chrono::steady_clock::now();
+        m_WindowStartBytes = 0;
+        m_MBPerSecond = 0.0;
+    }
+
+    void TestStreamingTexture::OnUpdate(float deltatime)
+    {
+        int width = m_Texture->GetWidth();
+        int height = m_Texture->GetHeight();
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < m_UploadsPerFrame; ++i, ++m_Frame)
+        {
+            // moving bars, or a single 256x256 block walking across the image
+            int x = 0, y = 0, w = width, h = height;
+            if (m_DirtyRectOnly)
+            {
+                w = h = 256;
+                x = (m_Frame * 16) % (width - w);
+                y = (m_Frame * 9) % (height - h);
+            }
+
+            unsigned int* pixels = (unsigned int*)m_Texture->Map(x, y, w, h);
+            if (pixels)
+            {
+                for (int row = 0; row < h; ++row)
+                {
+                    unsigned int shade = ((row + y + m_Frame * 4) / 32 % 2) ? 0xFF : 0x40;
+                    unsigned int color = 0xFF000000 | (shade << 16) | ((m_Frame & 0xFF) << 8) | (255 - shade);
+                    std::fill(pixels + row * w, pixels + (row + 1) * w, color);
+                }
+            }
+            m_Texture->Unmap();
+        }
+        std::chrono::duration<double, std::milli> cpu = std::chrono::steady_clock::now() - start;
+        m_CpuMsPerUpload = cpu.count() / m_UploadsPerFrame;
+
+        // sustained rate over the last second
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_WindowStart;
+        if (elapsed.count() >= 1.0)
+        {
+            unsigned long long bytes = m_Texture->GetBytesUploaded() - m_WindowStartBytes;
+            m_MBPerSecond = bytes / (1024.0 * 1024.0) / elapsed.count();
+            m_WindowStart = std::chrono::steady_clock::now();
+            m_WindowStartBytes = m_Texture->GetBytesUploaded();
+        }
+    }
+    void TestStreamingTexture::OnRender()
+    {
+        CALLGL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+
+        Renderer renderer;
+        m_Texture->Bind();
+        renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+    }
+    void TestStreamingTexture::OnImGuiRender()
+    {
+        int resolution = m_Resolution;
+        ImGui::RadioButton("1920x1080", &resolution, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("3840x2160", &resolution, 1);
+        if (resolution != m_Resolution)
+        {
+            m_Resolution = resolution;
+            CreateTexture();
+        }
+        ImGui::SliderInt("Uploads per frame", &m_UploadsPerFrame, 1, 16);
+        ImGui::Checkbox("Dirty rect only (256x256)", &m_DirtyRectOnly);
+
+        ImGui::Text("%u PBO slots, %u stalls", m_Texture->GetSlotCount(), m_Texture->GetStalls());
+        ImGui::Text("Upload %.1f MB/s, CPU %.3f ms per upload", m_MBPerSecond, m_CpuMsPerUpload);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../StreamingTexture.h"
+
+#include <chrono>
+#include <memory>
+
+namespace test {
+
+	// fills a StreamingTexture every frame and measures sustained upload MB/s
+	class TestStreamingTexture : public Test
+	{
+	public:
+		TestStreamingTexture();
+		~TestStreamingTexture();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void CreateTexture();
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Shader> m_Shader;
+		std::unique_ptr<StreamingTexture> m_Texture;
+
+		int m_Resolution; // 0: 1920x1080, 1: 3840x2160
+		int m_UploadsPerFrame;
+		bool m_DirtyRectOnly;
+		unsigned int m_Frame;
+
+		std::chrono::steady_clock::time_point m_WindowStart;
+		unsigned long long m_WindowStartBytes;
+		double m_MBPerSecond;
+		double m_CpuMsPerUpload;
+	};
+} // namespace test
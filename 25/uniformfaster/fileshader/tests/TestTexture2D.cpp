@@ -3,6 +3,7 @@
 
 
 #include "../Renderer.h"
+#include "../ShaderReflection.h"
 #include "imgui/imgui.h"
 
 #include "glm/glm.hpp"
@@ -31,7 +32,7 @@ namespace test {
         //CALLGL(glBlendFunc(GL_ONE, GL_ZERO));
 
         CALLGL(glEnable(GL_BLEND));
-        CALLGL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+        CALLGL(glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)); // textures are premultiplied
 
 
         
@@ -40,9 +41,19 @@ namespace test {
         
 
 
+        // Shader
+        m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader");
+
+        // the layout comes from the shader's inputs (vec2 position, vec2 texCoord)
+        // instead of Push calls that have to be kept in sync with it
         VertexBufferLayout layout;
-        layout.Push<float>(2); // a vertex has 2 points
-        layout.Push<float>(2); // a vertex has 2 points
+        if (!m_Shader->GetReflection().MakeVertexLayout(layout) || layout.GetElements().empty())
+        {
+            // gaps in the inputs or a shader that didn't link, the quad's own layout
+            layout = VertexBufferLayout();
+            layout.Push<float>(2);
+            layout.Push<float>(2);
+        }
         m_VAO->AddBuffer(*m_VertexBuffer, layout);
 
 
@@ -51,8 +62,6 @@ namespace test {
         // IndexBuffer ib(indices, _countof(indices));
         m_IndexBuffer = std::make_unique<IndexBuffer>(indices, _countof(indices));
 
-        // Shader
-        m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader");
         m_Shader->Bind();
         m_Shader->SetUniform4f("u_Color", 0.8f, 0.3f, 0.8f, 1.0f);
 
@@ -0,0 +1,68 @@
+#include "TestTextureMemory.h"
+
+#include "../Renderer.h"
+#include "imgui/imgui.h"
+
+namespace test {
+	TestTextureMemory::TestTextureMemory() :
+		m_Paths{
+			"res/textures/ChernoLogo.png", // rgba
+			"res/textures/Gradient.png",   // rgb, 125 wide so rows are not 4 byte aligned
+			"res/textures/Glow.png",       // gray + alpha
+			"res/textures/Mask.png",       // gray
+		},
+		m_TotalBytes(0),
+		m_TotalBytesRGBA8(0)
+	{
+		std::cout << "Texture memory (own channels vs RGBA8)" << std::endl;
+		for (const auto& path : m_Paths)
+		{
+			m_Textures.push_back(std::make_unique<Texture>(path));
+			const Texture& texture = *m_Textures.back();
+
+			unsigned int rgba8 = texture.GetWidth() * texture.GetHeight() * 4;
+			m_TotalBytes += texture.GetSizeInBytes();
+			m_TotalBytesRGBA8 += rgba8;
+
+			std::cout << "  " << path << " " <<
+				Texture::GetInternalFormatName(texture.GetInternalFormat()) << " " <<
+				texture.GetSizeInBytes() << " / " << rgba8 << " bytes" << std::endl;
+		}
+		std::cout << "  total " << m_TotalBytes << " / " << m_TotalBytesRGBA8 << " bytes" << std::endl;
+	}
+	TestTextureMemory::~TestTextureMemory()
+	{}
+
+	void TestTextureMemory::OnRender()
+	{
+		CALLGL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+	}
+	void TestTextureMemory::OnImGuiRender()
+	{
+		for (unsigned int i = 0; i < m_Textures.size(); ++i)
+		{
+			const Texture& texture = *m_Textures[i];
+			ImGui::Text("%s", m_Paths[i].c_str());
+			ImGui::Text("  %dx%d %s: %.1f KB (RGBA8 %.1f KB)",
+				texture.GetWidth(), texture.GetHeight(),
+				Texture::GetInternalFormatName(texture.GetInternalFormat()),
+				texture.GetSizeInBytes() / 1024.0f,
+				texture.GetWidth() * texture.GetHeight() * 4 / 1024.0f);
+		}
+		ImGui::Separator();
+		ImGui::Text("Total %.1f KB, RGBA8 %.1f KB (%.0f%%)",
+			m_TotalBytes / 1024.0f,
+			m_TotalBytesRGBA8 / 1024.0f,
+			m_TotalBytesRGBA8 ? 100.0f * m_TotalBytes / m_TotalBytesRGBA8 : 0.0f);
+
+		TexturePool& pool = TexturePool::Get();
+		ImGui::Separator();
+		ImGui::Text("Pool: %u allocations, %u reused", pool.GetAllocations(), pool.GetReuses());
+		ImGui::Text("Pool: live %.1f KB, idle %u textures %.1f KB / %.1f KB budget",
+			pool.GetLiveBytes() / 1024.0f,
+			pool.GetIdleCount(),
+			pool.GetIdleBytes() / 1024.0f,
+			pool.GetIdleBudget() / 1024.0f);
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../Texture.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace test {
+
+	// loads a mixed set of textures and compares how much GPU memory
+	// they take with their own channel count against forced RGBA8
+	class TestTextureMemory : public Test
+	{
+	public:
+		TestTextureMemory();
+		~TestTextureMemory();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		std::vector<std::string> m_Paths;
+		std::vector<std::unique_ptr<Texture>> m_Textures;
+		unsigned int m_TotalBytes;
+		unsigned int m_TotalBytesRGBA8;
+	};
+} // namespace test
@@ -0,0 +1,97 @@
+#include "TestTextureResidency.h"
+
+#include "../Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test {
+    static const int TextureCount = 64;
+
+    TestTextureResidency::TestTextureResidency() :
+        m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_FirstVisible(0),
+        m_TileSize(100),
+        m_BudgetMB(8)
+    {
+        // unit quad, scaled to the tile size in the model matrix
+        float positions[] = {
+            0.0f, 0.0f, 0.0f, 0.0f,
+            1.0f, 0.0f, 1.0f, 0.0f,
+            1.0f, 1.0f, 1.0f, 1.0f,
+            0.0f, 1.0f, 0.0f, 1.0f,
+        };
+        unsigned int indices[] = {
+            0,1,2,
+            2,3,0,
+        };
+
+        m_VAO = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(positions, _countof(positions) * sizeof(float));
+
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        m_VAO->AddBuffer(*m_VertexBuffer, layout);
+
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, _countof(indices));
+
+        m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader");
+        m_Shader->Bind();
+        m_Shader->SetUniform1i("u_Texture", 0);
+
+        // the same few files stand in for a large asset set, every
+        // registration is tracked and loaded on its own
+        const char* paths[] = {
+            "res/textures/ChernoLogo.png",
+            "res/textures/Gradient.png",
+            "res/textures/Glow.png",
+            "res/textures/Mask.png",
+        };
+        m_Residency = std::make_unique<TextureResidency>(m_BudgetMB * 1024 * 1024);
+        for (int i = 0; i < TextureCount; ++i)
+            m_Handles.push_back(m_Residency->Register(paths[i % _countof(paths)]));
+    }
+    TestTextureResidency::~TestTextureResidency()
+    {}
+
+    void TestTextureResidency::OnUpdate(float deltatime)
+    {
+        m_Residency->SetBudget(m_BudgetMB * 1024 * 1024);
+        m_Residency->Update();
+    }
+    void TestTextureResidency::OnRender()
+    {
+        CALLGL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+
+        Renderer renderer;
+        int columns = 900 / (m_TileSize + 8);
+        int rows = 500 / (m_TileSize + 8);
+        for (int i = 0; i < columns * rows; ++i)
+        {
+            int index = (m_FirstVisible + i) % TextureCount;
+            m_Residency->Bind(m_Handles[index], m_TileSize);
+
+            glm::vec3 position(30.0f + (i % columns) * (m_TileSize + 8), 20.0f + (i / columns) * (m_TileSize + 8), 0.0f);
+            glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3((float)m_TileSize, (float)m_TileSize, 1.0f));
+            m_Shader->Bind();
+            m_Shader->SetUniformMat4f("u_MVP", m_Proj * model);
+            renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+        }
+    }
+    void TestTextureResidency::OnImGuiRender()
+    {
+        ImGui::SliderInt("First visible", &m_FirstVisible, 0, TextureCount - 1);
+        ImGui::SliderInt("Tile size", &m_TileSize, 16, 480);
+        ImGui::SliderInt("Budget (MB)", &m_BudgetMB, 1, 64);
+
+        ImGui::Text("Resident %u / %u, %.2f MB", m_Residency->GetResidentCount(), m_Residency->GetCount(),
+            m_Residency->GetResidentBytes() / (1024.0f * 1024.0f));
+        ImGui::Text("Evicted and kept for reuse %.2f MB", m_Residency->GetIdleBytes() / (1024.0f * 1024.0f));
+        ImGui::Text("Loading %u, loads %u, evictions %u", m_Residency->GetPendingCount(),
+            m_Residency->GetLoads(), m_Residency->GetEvictions());
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
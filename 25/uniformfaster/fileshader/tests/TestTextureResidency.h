@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../TextureResidency.h"
+
+#include <memory>
+#include <vector>
+
+namespace test {
+
+	// a grid showing a window into a larger set of textures, scrolling it
+	// makes the residency manager load and evict under its budget
+	class TestTextureResidency : public Test
+	{
+	public:
+		TestTextureResidency();
+		~TestTextureResidency();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Shader> m_Shader;
+		std::unique_ptr<TextureResidency> m_Residency;
+		std::vector<TextureResidency::Handle> m_Handles;
+
+		glm::mat4 m_Proj;
+		int m_FirstVisible;
+		int m_TileSize;
+		int m_BudgetMB;
+	};
+} // namespace test
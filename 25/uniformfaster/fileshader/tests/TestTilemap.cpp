@@ -0,0 +1,174 @@
+#include "TestTilemap.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "../Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const int MapSizes[] = { 1024, 2048, 4096 };
+    static const char* MapSizeNames[] = { "1024 x 1024", "2048 x 2048", "4096 x 4096" };
+
+    enum TileKind { Empty, Water, Sand, Grass, Forest, Stone, Snow, Road, House, TileKindCount };
+    static const int TileSize = 16;
+
+    TestTilemap::TestTilemap() :
+        m_Rng(40),
+        m_MapSizeIndex(2),
+        m_ChunkSize(64),
+        m_UseArray(false),
+        m_TilesAcross(160.0f),
+        m_EditsPerFrame(200),
+        m_Pan(true),
+        m_Time(0.0f),
+        m_GenerateMs(0.0),
+        m_DrawCalls(0),
+        m_EditMs(0.0),
+        m_CpuMs(0.0)
+    {
+        m_Shader = std::make_unique<Shader>("res/shaders/Tilemap.shader");
+        BuildMap();
+    }
+    TestTilemap::~TestTilemap()
+    {
+    }
+
+    // smooth noise from a hashed lattice, 0..1
+    static float ValueNoise(float x, float y)
+    {
+        auto hash = [](int ix, int iy) {
+            unsigned int h = (unsigned int)ix * 374761393u + (unsigned int)iy * 668265263u;
+            h = (h ^ (h >> 13)) * 1274126177u;
+            return (h ^ (h >> 16)) / 4294967295.0f;
+        };
+        int ix = (int)std::floor(x), iy = (int)std::floor(y);
+        float fx = x - ix, fy = y - iy;
+        fx = fx * fx * (3.0f - 2.0f * fx);
+        fy = fy * fy * (3.0f - 2.0f * fy);
+        float a = hash(ix, iy) + (hash(ix + 1, iy) - hash(ix, iy)) * fx;
+        float b = hash(ix, iy + 1) + (hash(ix + 1, iy + 1) - hash(ix, iy + 1)) * fx;
+        return a + (b - a) * fy;
+    }
+
+    void TestTilemap::BuildMap()
+    {
+        int size = MapSizes[m_MapSizeIndex];
+        m_Map = std::make_unique<Tilemap>(size, size, m_ChunkSize);
+        BuildTileSet();
+
+        Clock::time_point start = Clock::now();
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                float height = 0.6f * ValueNoise(x / 96.0f, y / 96.0f) + 0.3f * ValueNoise(x / 24.0f, y / 24.0f) +
+                    0.1f * ValueNoise(x / 6.0f, y / 6.0f);
+                unsigned short tile = height < 0.42f ? Water : height < 0.46f ? Sand : height < 0.6f ? Grass :
+                    height < 0.7f ? Forest : height < 0.8f ? Stone : Snow;
+                // a road every 128 tiles
+                if ((x % 128 == 0 || y % 128 == 0) && tile != Water)
+                    tile = Road;
+                m_Map->SetTile(x, y, tile);
+            }
+        }
+        m_GenerateMs = Milliseconds(Clock::now() - start).count();
+        std::cout << "Tilemap " << size << "x" << size << " in " << m_Map->GetChunkCount() << " chunks of "
+            << m_ChunkSize << ", generated in " << m_GenerateMs << " ms" << std::endl;
+    }
+
+    void TestTilemap::BuildTileSet()
+    {
+        // flat colors with some grain, houses get a roof
+        static const unsigned char colors[TileKindCount - 1][3] = {
+            { 40, 90, 200 }, { 220, 200, 140 }, { 80, 170, 70 }, { 30, 110, 40 },
+            { 130, 130, 130 }, { 240, 240, 250 }, { 110, 80, 50 }, { 190, 60, 50 },
+        };
+        std::vector<unsigned char> pixels((TileKindCount - 1) * TileSize * TileSize * 4);
+        std::uniform_int_distribution<int> grain(-12, 12);
+        for (int tile = 0; tile < TileKindCount - 1; ++tile)
+        {
+            for (int y = 0; y < TileSize; ++y)
+            {
+                for (int x = 0; x < TileSize; ++x)
+                {
+                    unsigned char* p = &pixels[((tile * TileSize + y) * TileSize + x) * 4];
+                    bool roof = tile + 1 == House && std::abs(x - TileSize / 2) < TileSize / 2 - 2 - std::abs(y - TileSize / 2) / 2;
+                    int g = grain(m_Rng);
+                    for (int c = 0; c < 3; ++c)
+                        p[c] = (unsigned char)glm::clamp((roof ? colors[tile][c] / 2 : colors[tile][c]) + g, 0, 255);
+                    p[3] = 255;
+                }
+            }
+        }
+        m_Map->SetTileSet(pixels.data(), TileSize, TileKindCount - 1,
+            m_UseArray ? Tilemap::TileSampling::Array : Tilemap::TileSampling::Atlas);
+    }
+
+    void TestTilemap::OnUpdate(float deltatime)
+    {
+        m_Time += deltatime > 0.0f ? deltatime : 1.0f / 60.0f;
+    }
+
+    void TestTilemap::OnRender()
+    {
+        CALLGL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_GpuTimer.Poll();
+
+        // drift across the whole map
+        float size = (float)m_Map->GetWidth();
+        glm::vec2 center(size * 0.5f, size * 0.5f);
+        if (m_Pan)
+            center += glm::vec2(std::cos(m_Time * 0.05f), std::sin(m_Time * 0.07f)) * size * 0.4f;
+        glm::vec2 half(m_TilesAcross * 0.5f, m_TilesAcross * 0.5f * 540.0f / 960.0f);
+        glm::mat4 viewProj = glm::ortho(center.x - half.x, center.x + half.x, center.y - half.y, center.y + half.y, -1.0f, 1.0f);
+
+        // builders at work, mostly where we're looking
+        Clock::time_point start = Clock::now();
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        for (int i = 0; i < m_EditsPerFrame; ++i)
+        {
+            glm::vec2 p = center + glm::vec2(unit(m_Rng), unit(m_Rng)) * half * (i % 4 ? 1.0f : 20.0f);
+            int x = (int)p.x, y = (int)p.y;
+            if (x >= 0 && y >= 0 && x < m_Map->GetWidth() && y < m_Map->GetHeight() && m_Map->GetTile(x, y) != Water)
+                m_Map->SetTile(x, y, m_Map->GetTile(x, y) == House ? Grass : House);
+        }
+        m_EditMs = Milliseconds(Clock::now() - start).count();
+
+        Renderer renderer;
+        m_GpuTimer.Begin();
+        start = Clock::now();
+        m_DrawCalls = m_Map->Draw(renderer, *m_Shader, viewProj);
+        m_CpuMs = Milliseconds(Clock::now() - start).count();
+        m_GpuTimer.End();
+    }
+    void TestTilemap::OnImGuiRender()
+    {
+        if (ImGui::Combo("Map size", &m_MapSizeIndex, MapSizeNames, IM_ARRAYSIZE(MapSizeNames)) |
+            ImGui::SliderInt("Chunk size", &m_ChunkSize, 16, 127))
+            BuildMap();
+        if (ImGui::Checkbox("Texture array (atlas otherwise)", &m_UseArray))
+            BuildTileSet();
+        ImGui::SliderFloat("Tiles across", &m_TilesAcross, 16.0f, 2048.0f, "%.0f");
+        ImGui::SliderInt("Edits per frame", &m_EditsPerFrame, 0, 5000);
+        ImGui::Checkbox("Pan", &m_Pan);
+
+        const Tilemap::FrameStats& stats = m_Map->GetFrameStats();
+        ImGui::Text("%u chunks, %.1f MB of vertex buffers built, generated in %.0f ms", m_Map->GetChunkCount(),
+            m_Map->GetResidentBytes() / (1024.0 * 1024.0), m_GenerateMs);
+        ImGui::Text("%u visible chunks, %u draw calls", stats.visibleChunks, m_DrawCalls);
+        ImGui::Text("%u chunks built, %u re-uploaded, %.1f KB uploaded", stats.builtChunks, stats.updatedChunks, stats.uploadedBytes / 1024.0);
+        ImGui::Text("%.3f ms edits, %.3f ms CPU draw, %.3f ms GPU", m_EditMs, m_CpuMs, m_GpuTimer.GetMs());
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
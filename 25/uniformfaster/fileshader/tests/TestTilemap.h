@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../Tilemap.h"
+#include "../GpuTimer.h"
+
+#include <memory>
+#include <random>
+
+namespace test {
+
+	// a generated island map of up to 4096x4096 tiles, panned and zoomed
+	// with an orthographic camera while tiles get painted every frame
+	class TestTilemap : public Test
+	{
+	public:
+		TestTilemap();
+		~TestTilemap();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void BuildMap();
+		void BuildTileSet();
+
+		std::unique_ptr<Tilemap> m_Map;
+		std::unique_ptr<Shader> m_Shader;
+		std::mt19937 m_Rng;
+
+		int m_MapSizeIndex;
+		int m_ChunkSize;
+		bool m_UseArray;
+		float m_TilesAcross; // zoom
+		int m_EditsPerFrame;
+		bool m_Pan;
+		float m_Time;
+		double m_GenerateMs;
+
+		unsigned int m_DrawCalls;
+		double m_EditMs;
+		double m_CpuMs;
+
+		GpuTimer m_GpuTimer;
+	};
+} // namespace test
@@ -0,0 +1,135 @@
+#include "TestUniformUploads.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "../Renderer.h"
+#include "../GLBackend.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+struct UniformQuadVertex
+{
+    glm::vec2 position;
+    glm::vec2 texCoord;
+};
+VERTEX_LAYOUT(UniformQuadVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(texCoord));
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const glm::vec4 Palette[] = {
+        { 1.0f, 0.35f, 0.3f, 1.0f },
+        { 0.3f, 0.8f, 0.4f, 1.0f },
+        { 0.35f, 0.5f, 1.0f, 1.0f },
+        { 1.0f, 0.85f, 0.3f, 1.0f },
+    };
+    static const unsigned int PaletteSize = sizeof(Palette) / sizeof(Palette[0]);
+
+    TestUniformUploads::TestUniformUploads() :
+        m_QuadCount(4000),
+        m_Shadowing(Shader::IsUniformShadowing()),
+        m_Deferred(false),
+        m_SortByColor(false),
+        m_Time(0.0f),
+        m_CpuMs(0.0)
+    {
+        UniformQuadVertex vertices[] = {
+            { { -6.0f, -6.0f }, { 0.0f, 0.0f } },
+            { {  6.0f, -6.0f }, { 1.0f, 0.0f } },
+            { {  6.0f,  6.0f }, { 1.0f, 1.0f } },
+            { { -6.0f,  6.0f }, { 0.0f, 1.0f } },
+        };
+        unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+        m_VAO = std::make_unique<VertexArray>();
+        m_VertexBuffer = std::make_unique<VertexBuffer>(vertices, (unsigned int)sizeof(vertices));
+        m_VAO->AddBuffer<UniformQuadVertex>(*m_VertexBuffer);
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+        m_Shader = std::make_unique<Shader>("res/shaders/ColorQuad.shader");
+        m_Texture = std::make_unique<Texture>("res/textures/Glow.png");
+        BuildQuads();
+    }
+    TestUniformUploads::~TestUniformUploads()
+    {
+        Shader::SetUniformShadowing(true);
+    }
+
+    void TestUniformUploads::BuildQuads()
+    {
+        std::mt19937 rng(44);
+        std::uniform_real_distribution<float> x(10.0f, 950.0f), y(10.0f, 530.0f);
+        std::uniform_int_distribution<unsigned int> color(0, PaletteSize - 1);
+
+        m_Quads.resize(m_QuadCount);
+        for (Quad& quad : m_Quads)
+            quad = { { x(rng), y(rng) }, color(rng) };
+        // same quads, only the order changes, runs of equal colors skip their uploads
+        if (m_SortByColor)
+            std::stable_sort(m_Quads.begin(), m_Quads.end(), [](const Quad& a, const Quad& b) { return a.color < b.color; });
+    }
+
+    void TestUniformUploads::OnUpdate(float deltatime)
+    {
+        m_Time += deltatime;
+    }
+    void TestUniformUploads::OnRender()
+    {
+        CALLGL(glClearColor(0.05f, 0.05f, 0.1f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+        CALLGL(glEnable(GL_BLEND));
+        CALLGL(glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+
+        m_GpuTimer.Poll();
+
+        Shader::SetUniformShadowing(m_Shadowing);
+        m_Shader->SetDeferredUniforms(m_Deferred);
+        glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+        float wobble = 4.0f * std::sin(m_Time * 2.0f);
+
+        Renderer renderer;
+        m_GpuTimer.Begin();
+        Clock::time_point start = Clock::now();
+        m_Texture->Bind(0);
+        m_Shader->Bind();
+        for (const Quad& quad : m_Quads)
+        {
+            // written the way a naive draw loop does, everything every draw
+            m_Shader->SetUniform1i("u_Texture", 0);
+            const glm::vec4& color = Palette[quad.color];
+            m_Shader->SetUniform4f("u_Color", color.r, color.g, color.b, color.a);
+            glm::vec3 position(quad.position.x, quad.position.y + wobble, 0.0f);
+            m_Shader->SetUniformMat4f("u_MVP", glm::translate(proj, position));
+            renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+        }
+        m_CpuMs = Milliseconds(Clock::now() - start).count();
+        m_GpuTimer.End();
+        CALLGL(glDisable(GL_BLEND));
+    }
+    void TestUniformUploads::OnImGuiRender()
+    {
+        bool rebuild = ImGui::SliderInt("Quads", &m_QuadCount, 100, 20000);
+        rebuild |= ImGui::Checkbox("Sort by color", &m_SortByColor);
+        if (rebuild)
+            BuildQuads();
+        ImGui::Checkbox("Shadow uniform values", &m_Shadowing);
+        ImGui::Checkbox("Defer uploads to the draw", &m_Deferred);
+
+        // counted in the last finished frame
+        unsigned int issued = GLBackend::GetFrameUniformUploads();
+        unsigned int skipped = GLBackend::GetFrameSkippedUniformUploads();
+        ImGui::Text("uniform uploads: %u issued, %u skipped (%.0f%%)", issued, skipped,
+            issued + skipped ? 100.0 * skipped / (issued + skipped) : 0.0);
+        ImGui::Text("%d draw calls, %.3f ms CPU submit, %.3f ms GPU", m_QuadCount, m_CpuMs, m_GpuTimer.GetMs());
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
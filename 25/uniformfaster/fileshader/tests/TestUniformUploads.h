@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../Texture.h"
+#include "../GpuTimer.h"
+
+#include <memory>
+#include <vector>
+
+namespace test {
+
+	// a few thousand quads, one Renderer::Draw each with u_MVP, u_Color and
+	// u_Texture set every time. the shader's shadow copy drops the uploads
+	// of values the program already holds
+	class TestUniformUploads : public Test
+	{
+	public:
+		TestUniformUploads();
+		~TestUniformUploads();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		struct Quad
+		{
+			glm::vec2 position;
+			unsigned int color; // index into the palette
+		};
+
+		void BuildQuads();
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Shader> m_Shader;
+		std::unique_ptr<Texture> m_Texture;
+		std::vector<Quad> m_Quads;
+
+		int m_QuadCount;
+		bool m_Shadowing;
+		bool m_Deferred;
+		bool m_SortByColor;
+		float m_Time;
+
+		double m_CpuMs;
+
+		GpuTimer m_GpuTimer;
+	};
+} // namespace test
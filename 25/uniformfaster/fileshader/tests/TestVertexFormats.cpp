@@ -0,0 +1,222 @@
+#include "TestVertexFormats.h"
+
+#include <cmath>
+#include <vector>
+
+#include "../Renderer.h"
+#include "../VertexPacking.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+// 36 bytes
+struct FloatVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(FloatVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord),
+    VERTEX_ATTRIB(color));
+
+// 24 bytes
+struct HalfVertex
+{
+    Half4 position;
+    Half4 normal;
+    Half2 texCoord;
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(HalfVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord),
+    VERTEX_ATTRIB(color));
+
+// 20 bytes, position is normalized so the mesh has to fit in [-1, 1]
+struct PackedVertex
+{
+    glm::i16vec4 position;
+    PackedNormal normal;
+    glm::u16vec2 texCoord;
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(PackedVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord),
+    VERTEX_ATTRIB(color));
+
+namespace test {
+    static const char* FormatNames[] = { "float", "half float", "packed" };
+
+    TestVertexFormats::TestVertexFormats() :
+        m_VertexBytes{},
+        m_GridSize(512),
+        m_Format(Float),
+        m_DrawsPerFrame(4),
+        m_Strips(false),
+        m_GpuMs{}
+    {
+        m_Shader = std::make_unique<Shader>("res/shaders/Mesh.shader");
+        BuildMesh();
+    }
+    TestVertexFormats::~TestVertexFormats()
+    {
+    }
+
+    void TestVertexFormats::BuildMesh()
+    {
+        // wavy grid in [-1, 1]
+        int n = m_GridSize;
+        unsigned int vertexCount = n * n;
+        std::vector<glm::vec3> positions(vertexCount);
+        std::vector<glm::vec3> normals(vertexCount);
+        std::vector<glm::vec2> texCoords(vertexCount);
+        std::vector<glm::u8vec4> colors(vertexCount);
+        for (int y = 0; y < n; ++y)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                float u = (float)x / (n - 1);
+                float v = (float)y / (n - 1);
+                float px = u * 2.0f - 1.0f;
+                float pz = v * 2.0f - 1.0f;
+                float h = 0.1f * std::sin(px * 12.0f) * std::cos(pz * 9.0f);
+                float dx = 0.1f * 12.0f * std::cos(px * 12.0f) * std::cos(pz * 9.0f);
+                float dz = -0.1f * 9.0f * std::sin(px * 12.0f) * std::sin(pz * 9.0f);
+
+                unsigned int i = y * n + x;
+                positions[i] = glm::vec3(px, h, pz);
+                normals[i] = glm::normalize(glm::vec3(-dx, 1.0f, -dz));
+                texCoords[i] = glm::vec2(u, v);
+                colors[i] = glm::u8vec4((unsigned char)(u * 255), 180, (unsigned char)(v * 255), 255);
+            }
+        }
+
+        // 32 bit on the CPU, IndexBuffer stores 16 bit up to 255x255
+        std::vector<unsigned int> indices;
+        if (m_Strips)
+        {
+            indices.reserve((n - 1) * (2 * n + 1));
+            for (int y = 0; y < n - 1; ++y)
+            {
+                for (int x = 0; x < n; ++x)
+                {
+                    unsigned int i = y * n + x;
+                    indices.insert(indices.end(), { i, i + n });
+                }
+                indices.push_back(0xFFFFFFFF);
+            }
+        }
+        else
+        {
+            indices.reserve((n - 1) * (n - 1) * 6);
+            for (int y = 0; y < n - 1; ++y)
+            {
+                for (int x = 0; x < n - 1; ++x)
+                {
+                    unsigned int i = y * n + x;
+                    indices.insert(indices.end(), { i, i + n, i + 1, i + 1, i + n, i + n + 1 });
+                }
+            }
+        }
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size(), m_Strips);
+
+        {
+            std::vector<FloatVertex> vertices(vertexCount);
+            for (unsigned int i = 0; i < vertexCount; ++i)
+                vertices[i] = { positions[i], normals[i], texCoords[i], colors[i] };
+            m_VertexBytes[Float] = vertexCount * sizeof(FloatVertex);
+            m_VertexBuffer[Float] = std::make_unique<VertexBuffer>(vertices.data(), m_VertexBytes[Float]);
+            m_VAO[Float] = std::make_unique<VertexArray>();
+            m_VAO[Float]->AddBuffer<FloatVertex>(*m_VertexBuffer[Float]);
+        }
+        {
+            // pack every stream in one go, then interleave
+            std::vector<glm::vec4> positions4(vertexCount), normals4(vertexCount);
+            for (unsigned int i = 0; i < vertexCount; ++i)
+            {
+                positions4[i] = glm::vec4(positions[i], 1.0f);
+                normals4[i] = glm::vec4(normals[i], 0.0f);
+            }
+            std::vector<Half4> halfPositions(vertexCount), halfNormals(vertexCount);
+            std::vector<Half2> halfTexCoords(vertexCount);
+            VertexPacking::PackHalf(&positions4[0].x, &halfPositions[0].x, vertexCount * 4);
+            VertexPacking::PackHalf(&normals4[0].x, &halfNormals[0].x, vertexCount * 4);
+            VertexPacking::PackHalf(&texCoords[0].x, &halfTexCoords[0].x, vertexCount * 2);
+
+            std::vector<HalfVertex> vertices(vertexCount);
+            for (unsigned int i = 0; i < vertexCount; ++i)
+                vertices[i] = { halfPositions[i], halfNormals[i], halfTexCoords[i], colors[i] };
+            m_VertexBytes[HalfFloat] = vertexCount * sizeof(HalfVertex);
+            m_VertexBuffer[HalfFloat] = std::make_unique<VertexBuffer>(vertices.data(), m_VertexBytes[HalfFloat]);
+            m_VAO[HalfFloat] = std::make_unique<VertexArray>();
+            m_VAO[HalfFloat]->AddBuffer<HalfVertex>(*m_VertexBuffer[HalfFloat]);
+
+            std::vector<glm::i16vec4> snormPositions(vertexCount);
+            std::vector<PackedNormal> packedNormals(vertexCount);
+            std::vector<glm::u16vec2> unormTexCoords(vertexCount);
+            VertexPacking::PackSnorm16(&positions4[0].x, &snormPositions[0].x, vertexCount * 4);
+            VertexPacking::PackNormals(normals.data(), packedNormals.data(), vertexCount);
+            VertexPacking::PackUnorm16(&texCoords[0].x, &unormTexCoords[0].x, vertexCount * 2);
+
+            std::vector<PackedVertex> packed(vertexCount);
+            for (unsigned int i = 0; i < vertexCount; ++i)
+                packed[i] = { snormPositions[i], packedNormals[i], unormTexCoords[i], colors[i] };
+            m_VertexBytes[Packed] = vertexCount * sizeof(PackedVertex);
+            m_VertexBuffer[Packed] = std::make_unique<VertexBuffer>(packed.data(), m_VertexBytes[Packed]);
+            m_VAO[Packed] = std::make_unique<VertexArray>();
+            m_VAO[Packed]->AddBuffer<PackedVertex>(*m_VertexBuffer[Packed]);
+        }
+    }
+
+    void TestVertexFormats::OnRender()
+    {
+        CALLGL(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        CALLGL(glEnable(GL_DEPTH_TEST));
+
+        // last frame's result, never wait for the GPU here
+        if (m_GpuTimer.Poll())
+            m_GpuMs[m_Format] = m_GpuTimer.GetMs() / m_DrawsPerFrame;
+
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), 960.0f / 540.0f, 0.1f, 10.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 1.2f, 2.2f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        m_Shader->Bind();
+        m_Shader->SetUniformMat4f("u_MVP", proj * view);
+
+        Renderer renderer;
+        m_GpuTimer.Begin();
+        for (int i = 0; i < m_DrawsPerFrame; ++i)
+            renderer.Draw(*m_VAO[m_Format], *m_IndexBuffer, *m_Shader, m_Strips ? GL_TRIANGLE_STRIP : GL_TRIANGLES);
+        m_GpuTimer.End();
+        CALLGL(glDisable(GL_DEPTH_TEST));
+    }
+    void TestVertexFormats::OnImGuiRender()
+    {
+        if (ImGui::SliderInt("Grid size", &m_GridSize, 16, 1024))
+            BuildMesh();
+        if (ImGui::Checkbox("Triangle strips", &m_Strips))
+            BuildMesh();
+        ImGui::Combo("Format", &m_Format, FormatNames, FormatCount);
+        ImGui::SliderInt("Draws per frame", &m_DrawsPerFrame, 1, 32);
+
+        ImGui::Text("%d vertices, %d triangles", m_GridSize * m_GridSize, 2 * (m_GridSize - 1) * (m_GridSize - 1));
+        ImGui::Text("%u indices, %u bit, %.2f MB", m_IndexBuffer->GetCount(), m_IndexBuffer->GetIndexSize() * 8,
+            m_IndexBuffer->GetSizeInBytes() / (1024.0f * 1024.0f));
+        for (int i = 0; i < FormatCount; ++i)
+        {
+            ImGui::Text("%-10s %2u bytes/vertex %7.2f MB, %.3f ms per draw", FormatNames[i],
+                m_VertexBytes[i] / (m_GridSize * m_GridSize),
+                m_VertexBytes[i] / (1024.0f * 1024.0f),
+                m_GpuMs[i]);
+        }
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../GpuTimer.h"
+
+#include <memory>
+
+namespace test {
+
+	// one large mesh in full float, half float and packed/normalized
+	// integer vertex formats, compares memory and GPU draw time
+	class TestVertexFormats : public Test
+	{
+	public:
+		TestVertexFormats();
+		~TestVertexFormats();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		enum Format { Float, HalfFloat, Packed, FormatCount };
+
+		void BuildMesh();
+
+		std::unique_ptr<VertexArray> m_VAO[FormatCount];
+		std::unique_ptr<VertexBuffer> m_VertexBuffer[FormatCount];
+		unsigned int m_VertexBytes[FormatCount];
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Shader> m_Shader;
+
+		int m_GridSize;
+		int m_Format;
+		int m_DrawsPerFrame;
+		// one triangle strip per row, rows split by the restart index
+		bool m_Strips;
+
+		GpuTimer m_GpuTimer;
+		double m_GpuMs[FormatCount];
+	};
+} // namespace test
@@ -0,0 +1,116 @@
+#include "TestVertexLayout.h"
+
+#include <chrono>
+#include <vector>
+
+#include "../Renderer.h"
+#include "../VertexArray.h"
+#include "../VertexBufferLayout.h"
+#include "imgui/imgui.h"
+
+struct MeshVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(MeshVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord),
+    VERTEX_ATTRIB(color));
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    TestVertexLayout::TestVertexLayout() :
+        m_MeshCount(1000),
+        m_RuntimeLayoutMs(0.0),
+        m_RuntimeSetupMs(0.0),
+        m_StaticLayoutMs(0.0),
+        m_StaticSetupMs(0.0)
+    {
+        MeshVertex vertices[3] = {};
+        m_VertexBuffer = std::make_unique<VertexBuffer>(vertices, sizeof(vertices));
+    }
+    TestVertexLayout::~TestVertexLayout()
+    {}
+
+    void TestVertexLayout::Run()
+    {
+        std::vector<std::unique_ptr<VertexArray>> vaos;
+        vaos.reserve(m_MeshCount * 2);
+
+        // only describing the layout, no GL
+        {
+            Clock::time_point start = Clock::now();
+            unsigned int check = 0;
+            for (int i = 0; i < m_MeshCount; ++i)
+            {
+                VertexBufferLayout layout;
+                layout.Push<float>(3);
+                layout.Push<float>(3);
+                layout.Push<float>(2);
+                layout.Push<unsigned char>(4);
+                check += layout.GetStride();
+            }
+            m_RuntimeLayoutMs = Milliseconds(Clock::now() - start).count();
+
+            start = Clock::now();
+            for (int i = 0; i < m_MeshCount; ++i)
+                check += VertexLayout<MeshVertex>::Stride;
+            m_StaticLayoutMs = Milliseconds(Clock::now() - start).count();
+            ASSERT_GL(check == 2 * m_MeshCount * sizeof(MeshVertex));
+        }
+
+        // layout plus VAO creation and attribute setup, what loading a mesh costs
+        {
+            Clock::time_point start = Clock::now();
+            for (int i = 0; i < m_MeshCount; ++i)
+            {
+                VertexBufferLayout layout;
+                layout.Push<float>(3);
+                layout.Push<float>(3);
+                layout.Push<float>(2);
+                layout.Push<unsigned char>(4);
+                vaos.push_back(std::make_unique<VertexArray>());
+                vaos.back()->AddBuffer(*m_VertexBuffer, layout);
+            }
+            CALLGL(glFinish());
+            m_RuntimeSetupMs = Milliseconds(Clock::now() - start).count();
+
+            start = Clock::now();
+            for (int i = 0; i < m_MeshCount; ++i)
+            {
+                vaos.push_back(std::make_unique<VertexArray>());
+                vaos.back()->AddBuffer<MeshVertex>(*m_VertexBuffer);
+            }
+            CALLGL(glFinish());
+            m_StaticSetupMs = Milliseconds(Clock::now() - start).count();
+        }
+
+        std::cout << "VAO setup for " << m_MeshCount << " meshes:"
+            << " runtime layout " << m_RuntimeSetupMs << " ms (layout only " << m_RuntimeLayoutMs << " ms),"
+            << " static layout " << m_StaticSetupMs << " ms (layout only " << m_StaticLayoutMs << " ms)" << std::endl;
+    }
+
+    void TestVertexLayout::OnRender()
+    {
+        CALLGL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+    }
+    void TestVertexLayout::OnImGuiRender()
+    {
+        ImGui::SliderInt("Meshes", &m_MeshCount, 100, 20000);
+        if (ImGui::Button("Run"))
+            Run();
+
+        ImGui::Text("VertexBufferLayout: %.3f ms (layout only %.3f ms)", m_RuntimeSetupMs, m_RuntimeLayoutMs);
+        ImGui::Text("VERTEX_LAYOUT:      %.3f ms (layout only %.3f ms)", m_StaticSetupMs, m_StaticLayoutMs);
+        if (m_MeshCount > 0)
+            ImGui::Text("per mesh %.2f us vs %.2f us",
+                1000.0 * m_RuntimeSetupMs / m_MeshCount, 1000.0 * m_StaticSetupMs / m_MeshCount);
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexBuffer.h"
+
+#include <memory>
+
+namespace test {
+
+	// VAO setup cost for many meshes, runtime VertexBufferLayout
+	// against a VERTEX_LAYOUT table
+	class TestVertexLayout : public Test
+	{
+	public:
+		TestVertexLayout();
+		~TestVertexLayout();
+
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void Run();
+
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		int m_MeshCount;
+		double m_RuntimeLayoutMs;
+		double m_RuntimeSetupMs;
+		double m_StaticLayoutMs;
+		double m_StaticSetupMs;
+	};
+} // namespace test
@@ -0,0 +1,254 @@
+#include "TestVertexPulling.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "../Renderer.h"
+#include "../GLBackend.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+// what the vertex array path fetches, 28 bytes. the pulled vertex is
+// padded to 32 so it splits into two uvec4 texels
+struct AttribMeshVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(AttribMeshVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(color));
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const char* ModeNames[] = { "vertex arrays", "pulled from texture buffers", "pulled from storage buffers" };
+    static const unsigned int MeshCount = 12;
+    static const float ObjectSpacing = 2.0f;
+    static const int MaxObjects = 40000;
+
+    TestVertexPulling::TestVertexPulling() :
+        m_ObjectCount(10000),
+        m_MaxTextureObjects(std::min(MaxObjects, (int)(PullBuffer::GetMaxTextureBufferTexels() / 2))),
+        m_Mode(TextureBuffers),
+        m_SortByMesh(false),
+        m_Time(0.0f),
+        m_MeshChanges(0),
+        m_CpuMs(0.0)
+    {
+        m_AttribShader = std::make_unique<Shader>("res/shaders/AttribMesh.shader");
+        m_PulledShader = std::make_unique<Shader>("res/shaders/PulledMesh.shader");
+        if (Shader::HasCompute())
+        {
+            // GL 4.3 may allow no storage blocks in vertex shaders at all
+            // (GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS 0), it doesn't link then
+            m_StorageShader = std::make_unique<Shader>("res/shaders/PulledMeshStorage.shader");
+            if (!m_StorageShader->IsLinked())
+                m_StorageShader.reset();
+        }
+        BuildMeshes();
+        BuildObjects();
+    }
+    TestVertexPulling::~TestVertexPulling()
+    {
+    }
+
+    void TestVertexPulling::BuildMeshes()
+    {
+        std::mt19937 rng(49);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        // lathed around the y axis, each with its own profile and segment count
+        static const int Segments[MeshCount] = { 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 32, 48 };
+        m_Meshes.resize(MeshCount);
+        m_TextureGeometry = std::make_unique<PulledGeometry>();
+        m_StorageGeometry = std::make_unique<PulledGeometry>();
+        for (unsigned int m = 0; m < MeshCount; ++m)
+        {
+            Mesh& mesh = m_Meshes[m];
+            std::vector<glm::vec2> profile = { { 0.2f + 0.4f * unit(rng), 0.0f } };
+            int rings = 2 + m % 5;
+            for (int ring = 1; ring < rings; ++ring)
+                profile.push_back({ 0.1f + 0.5f * unit(rng), profile.back().y + 0.2f + 0.4f * unit(rng) });
+            profile.push_back({ 0.0f, profile.back().y + 0.3f });
+
+            int segments = Segments[m];
+            glm::u8vec4 color(128 + rng() % 128, 128 + rng() % 128, 128 + rng() % 128, 255);
+            for (size_t ring = 0; ring < profile.size(); ++ring)
+            {
+                for (int s = 0; s <= segments; ++s)
+                {
+                    float a = s * 6.2831853f / segments;
+                    glm::vec3 dir(std::cos(a), 0.0f, std::sin(a));
+                    glm::vec2 slope = ring + 1 < profile.size() ? profile[ring + 1] - profile[ring] : profile[ring] - profile[ring - 1];
+                    glm::vec3 n = glm::normalize(dir * slope.y - glm::vec3(0.0f, slope.x, 0.0f));
+                    mesh.vertices.push_back({ dir * profile[ring].x + glm::vec3(0.0f, profile[ring].y, 0.0f), n, color, 0 });
+                }
+            }
+            unsigned int stride = segments + 1;
+            for (unsigned int ring = 0; ring + 1 < profile.size(); ++ring)
+            {
+                for (unsigned int s = 0; s < (unsigned int)segments; ++s)
+                {
+                    unsigned int a = ring * stride + s, b = a + stride;
+                    mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+                }
+            }
+
+            // a buffer pair and a vertex array per mesh, the usual way
+            std::vector<AttribMeshVertex> attribVertices;
+            for (const PulledGeometry::Vertex& vertex : mesh.vertices)
+                attribVertices.push_back({ vertex.position, vertex.normal, vertex.color });
+            mesh.vertexBuffer = std::make_unique<VertexBuffer>(attribVertices.data(), (unsigned int)(attribVertices.size() * sizeof(AttribMeshVertex)));
+            mesh.indexBuffer = std::make_unique<IndexBuffer>(mesh.indices.data(), (unsigned int)mesh.indices.size());
+            mesh.vao = std::make_unique<VertexArray>();
+            mesh.vao->AddBuffer<AttribMeshVertex>(*mesh.vertexBuffer);
+
+            m_TextureGeometry->AddMesh(mesh.vertices.data(), (unsigned int)mesh.vertices.size(), mesh.indices.data(), (unsigned int)mesh.indices.size());
+            m_StorageGeometry->AddMesh(mesh.vertices.data(), (unsigned int)mesh.vertices.size(), mesh.indices.data(), (unsigned int)mesh.indices.size());
+        }
+        m_TextureGeometry->Build(false);
+        if (m_StorageShader)
+            m_StorageGeometry->Build(true);
+        else
+            m_StorageGeometry.reset();
+    }
+
+    void TestVertexPulling::BuildObjects()
+    {
+        std::mt19937 rng(50);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        int side = (int)std::ceil(std::sqrt((float)m_ObjectCount));
+        m_Objects.resize(m_ObjectCount);
+        for (int i = 0; i < m_ObjectCount; ++i)
+        {
+            Object& object = m_Objects[i];
+            object.mesh = rng() % MeshCount;
+            glm::vec3 position(((i % side) - side * 0.5f) * ObjectSpacing, 0.0f, ((i / side) - side * 0.5f) * ObjectSpacing);
+            object.positionScale = glm::vec4(position, 0.6f + 0.6f * unit(rng));
+            object.color = glm::vec4(0.6f + 0.4f * unit(rng), 0.6f + 0.4f * unit(rng), 0.6f + 0.4f * unit(rng), 1.0f);
+        }
+        // the vertex array path switches less, the pulled ones don't care
+        if (m_SortByMesh)
+            std::stable_sort(m_Objects.begin(), m_Objects.end(), [](const Object& a, const Object& b) { return a.mesh < b.mesh; });
+
+        std::vector<glm::vec4> texels;
+        texels.reserve(m_Objects.size() * 2);
+        for (const Object& object : m_Objects)
+        {
+            texels.push_back(object.positionScale);
+            texels.push_back(object.color);
+        }
+        unsigned int size = (unsigned int)(texels.size() * sizeof(glm::vec4));
+        m_TextureInstances = std::make_unique<PullBuffer>(texels.data(), size, GL_RGBA32F, false);
+        if (m_StorageShader)
+            m_StorageInstances = std::make_unique<PullBuffer>(texels.data(), size, GL_RGBA32F, true);
+    }
+
+    void TestVertexPulling::OnUpdate(float deltatime)
+    {
+        m_Time += deltatime > 0.0f ? deltatime : 1.0f / 60.0f;
+    }
+
+    void TestVertexPulling::OnRender()
+    {
+        CALLGL(glClearColor(0.1f, 0.1f, 0.14f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        CALLGL(glEnable(GL_DEPTH_TEST));
+        CALLGL(glEnable(GL_CULL_FACE));
+
+        m_GpuTimer.Poll();
+
+        // high above the field so every object is drawn
+        float extent = std::sqrt((float)m_ObjectCount) * ObjectSpacing;
+        float angle = m_Time * 0.1f;
+        glm::vec3 eye(std::cos(angle) * extent * 0.6f, extent * 0.7f, std::sin(angle) * extent * 0.6f);
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), 960.0f / 540.0f, 0.5f, extent * 3.0f);
+        glm::mat4 viewProj = proj * glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        Renderer renderer;
+        m_GpuTimer.Begin();
+        Clock::time_point start = Clock::now();
+        m_MeshChanges = 0;
+        unsigned int lastMesh = (unsigned int)-1;
+        if (m_Mode == VertexArrays)
+        {
+            Shader& shader = *m_AttribShader;
+            shader.Bind();
+            shader.SetUniformMat4f("u_ViewProjection", viewProj);
+            shader.SetUniform1i("u_Instances", 2);
+            m_TextureInstances->Bind(2);
+            for (unsigned int i = 0; i < m_Objects.size(); ++i)
+            {
+                const Mesh& mesh = m_Meshes[m_Objects[i].mesh];
+                m_MeshChanges += m_Objects[i].mesh != lastMesh;
+                lastMesh = m_Objects[i].mesh;
+                shader.SetUniform1i("u_InstanceBase", i);
+                renderer.Draw(*mesh.vao, *mesh.indexBuffer, shader);
+            }
+        }
+        else
+        {
+            bool storage = m_Mode == StorageBuffers;
+            Shader& shader = storage ? *m_StorageShader : *m_PulledShader;
+            const PulledGeometry& geometry = storage ? *m_StorageGeometry : *m_TextureGeometry;
+            shader.Bind();
+            shader.SetUniformMat4f("u_ViewProjection", viewProj);
+            if (!storage)
+            {
+                shader.SetUniform1i("u_Vertices", 0);
+                shader.SetUniform1i("u_Indices", 1);
+                shader.SetUniform1i("u_Instances", 2);
+            }
+            geometry.Bind();
+            (storage ? m_StorageInstances : m_TextureInstances)->Bind(2);
+            for (unsigned int i = 0; i < m_Objects.size(); ++i)
+            {
+                m_MeshChanges += m_Objects[i].mesh != lastMesh;
+                lastMesh = m_Objects[i].mesh;
+                shader.SetUniform1i("u_InstanceBase", i);
+                geometry.Draw(renderer, shader, m_Objects[i].mesh);
+            }
+        }
+        m_CpuMs = Milliseconds(Clock::now() - start).count();
+        m_GpuTimer.End();
+        CALLGL(glActiveTexture(GL_TEXTURE0));
+        CALLGL(glDisable(GL_CULL_FACE));
+        CALLGL(glDisable(GL_DEPTH_TEST));
+    }
+    void TestVertexPulling::OnImGuiRender()
+    {
+        // vertex arrays read the objects from the texture buffer too, past
+        // GL_MAX_TEXTURE_BUFFER_SIZE they would fetch zeros
+        int maxObjects = m_Mode == StorageBuffers ? MaxObjects : m_MaxTextureObjects;
+        bool rebuild = ImGui::SliderInt("Objects", &m_ObjectCount, 1000, maxObjects);
+        rebuild |= ImGui::Checkbox("Sort by mesh", &m_SortByMesh);
+        if (ImGui::Combo("Vertex fetch", &m_Mode, ModeNames, m_StorageShader ? ModeCount : StorageBuffers) &&
+            m_Mode != StorageBuffers && m_ObjectCount > m_MaxTextureObjects)
+        {
+            m_ObjectCount = m_MaxTextureObjects;
+            rebuild = true;
+        }
+        if (rebuild)
+            BuildObjects();
+        if (!m_StorageShader)
+            ImGui::Text("storage buffers need GL 4.3 and vertex shader storage blocks, texture buffers only");
+
+        bool vertexArrays = m_Mode == VertexArrays;
+        ImGui::Text("%u draw calls, %u mesh changes, %u vertex array switches", (unsigned int)m_Objects.size(), m_MeshChanges,
+            vertexArrays ? m_MeshChanges : 1);
+        // counted in the last finished frame
+        ImGui::Text("%u binds, %u uniform uploads", GLBackend::GetFrameBinds(), GLBackend::GetFrameUniformUploads());
+        ImGui::Text("%.3f ms CPU submit, %.3f ms GPU", m_CpuMs, m_GpuTimer.GetMs());
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+#include "../VertexPulling.h"
+#include "../GpuTimer.h"
+
+#include <memory>
+#include <vector>
+
+namespace test {
+
+	// thousands of objects made of a dozen different meshes, a draw each.
+	// through vertex arrays every mesh change is a VAO switch, with vertex
+	// pulling all meshes come out of the same buffers and the vertex array
+	// never changes
+	class TestVertexPulling : public Test
+	{
+	public:
+		TestVertexPulling();
+		~TestVertexPulling();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		enum Mode { VertexArrays, TextureBuffers, StorageBuffers, ModeCount };
+
+		struct Mesh
+		{
+			std::vector<PulledGeometry::Vertex> vertices;
+			std::vector<unsigned int> indices;
+			std::unique_ptr<VertexBuffer> vertexBuffer;
+			std::unique_ptr<IndexBuffer> indexBuffer;
+			std::unique_ptr<VertexArray> vao;
+		};
+
+		struct Object
+		{
+			unsigned int mesh;
+			glm::vec4 positionScale;
+			glm::vec4 color;
+		};
+
+		void BuildMeshes();
+		void BuildObjects();
+
+		std::vector<Mesh> m_Meshes;
+		std::vector<Object> m_Objects;
+		std::unique_ptr<PulledGeometry> m_TextureGeometry;
+		std::unique_ptr<PulledGeometry> m_StorageGeometry;
+		// the objects in draw order, two texels each
+		std::unique_ptr<PullBuffer> m_TextureInstances;
+		std::unique_ptr<PullBuffer> m_StorageInstances;
+		std::unique_ptr<Shader> m_AttribShader;
+		std::unique_ptr<Shader> m_PulledShader;
+		std::unique_ptr<Shader> m_StorageShader;
+
+		int m_ObjectCount;
+		// what the texture buffer of two texels an object holds
+		int m_MaxTextureObjects;
+		int m_Mode;
+		bool m_SortByMesh;
+		float m_Time;
+
+		unsigned int m_MeshChanges;
+		double m_CpuMs;
+
+		GpuTimer m_GpuTimer;
+	};
+} // namespace test
@@ -0,0 +1,183 @@
+#include "TestVertexStreams.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "../Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+// everything in one buffer, 36 bytes
+struct InterleavedVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(InterleavedVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord),
+    VERTEX_ATTRIB(color));
+
+// uploaded once, 32 bytes
+struct StaticVertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+};
+VERTEX_LAYOUT(StaticVertex,
+    VERTEX_ATTRIB(position),
+    VERTEX_ATTRIB(normal),
+    VERTEX_ATTRIB(texCoord));
+
+// rewritten every frame, 4 bytes at location 3
+struct ColorVertex
+{
+    glm::u8vec4 color;
+};
+VERTEX_LAYOUT(ColorVertex,
+    VERTEX_ATTRIB(color));
+
+namespace test {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    static const char* ModeNames[] = { "interleaved", "split streams", "swapped color buffers" };
+
+    TestVertexStreams::TestVertexStreams() :
+        m_ColorBinding(0),
+        m_GridSize(512),
+        m_Mode(SplitStreams),
+        m_Time(0.0f),
+        m_Frame(0),
+        m_BytesPerFrame(0),
+        m_UploadMs(0.0)
+    {
+        m_Shader = std::make_unique<Shader>("res/shaders/Mesh.shader");
+        BuildMesh();
+    }
+    TestVertexStreams::~TestVertexStreams()
+    {}
+
+    void TestVertexStreams::BuildMesh()
+    {
+        int n = m_GridSize;
+        unsigned int vertexCount = n * n;
+        std::vector<StaticVertex> vertices(vertexCount);
+        for (int y = 0; y < n; ++y)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                float u = (float)x / (n - 1);
+                float v = (float)y / (n - 1);
+                vertices[y * n + x] = { glm::vec3(u * 2.0f - 1.0f, 0.0f, v * 2.0f - 1.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(u, v) };
+            }
+        }
+
+        std::vector<unsigned int> indices;
+        indices.reserve((n - 1) * (n - 1) * 6);
+        for (int y = 0; y < n - 1; ++y)
+        {
+            for (int x = 0; x < n - 1; ++x)
+            {
+                unsigned int i = y * n + x;
+                indices.insert(indices.end(), { i, i + n, i + 1, i + 1, i + n, i + n + 1 });
+            }
+        }
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+        m_Colors.assign(vertexCount, 0);
+        m_InterleavedData.resize(vertexCount * sizeof(InterleavedVertex));
+        InterleavedVertex* interleaved = (InterleavedVertex*)m_InterleavedData.data();
+        for (unsigned int i = 0; i < vertexCount; ++i)
+            interleaved[i] = { vertices[i].position, vertices[i].normal, vertices[i].texCoord, glm::u8vec4(255) };
+
+        m_InterleavedBuffer = std::make_unique<VertexBuffer>(m_InterleavedData.data(), (unsigned int)m_InterleavedData.size(), GL_DYNAMIC_DRAW);
+        m_InterleavedVAO = std::make_unique<VertexArray>();
+        m_InterleavedVAO->AddBuffer<InterleavedVertex>(*m_InterleavedBuffer);
+
+        m_StaticBuffer = std::make_unique<VertexBuffer>(vertices.data(), vertexCount * (unsigned int)sizeof(StaticVertex));
+        for (auto& buffer : m_ColorBuffer)
+            buffer = std::make_unique<VertexBuffer>(m_Colors.data(), vertexCount * (unsigned int)sizeof(ColorVertex), GL_DYNAMIC_DRAW);
+        m_StreamVAO = std::make_unique<VertexArray>();
+        m_StreamVAO->AddBuffer<StaticVertex>(*m_StaticBuffer);
+        m_ColorBinding = m_StreamVAO->AddBuffer<ColorVertex>(*m_ColorBuffer[0], 3);
+    }
+
+    void TestVertexStreams::UpdateColors()
+    {
+        // rings moving out from the center
+        int n = m_GridSize;
+        for (int y = 0; y < n; ++y)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                float dx = (float)x / (n - 1) - 0.5f;
+                float dy = (float)y / (n - 1) - 0.5f;
+                float wave = 0.5f + 0.5f * std::sin(std::sqrt(dx * dx + dy * dy) * 60.0f - m_Time * 4.0f);
+                unsigned char r = (unsigned char)(wave * 255.0f);
+                unsigned char b = (unsigned char)(255 - r);
+                m_Colors[y * n + x] = r | (160u << 8) | (b << 16) | (255u << 24);
+            }
+        }
+    }
+
+    void TestVertexStreams::OnUpdate(float deltatime)
+    {
+        m_Time += deltatime > 0.0f ? deltatime : 1.0f / 60.0f;
+        UpdateColors();
+
+        // only the upload is timed, filling m_Colors is the same for every mode
+        Clock::time_point start = Clock::now();
+        unsigned int vertexCount = (unsigned int)m_Colors.size();
+        if (m_Mode == Interleaved)
+        {
+            InterleavedVertex* interleaved = (InterleavedVertex*)m_InterleavedData.data();
+            for (unsigned int i = 0; i < vertexCount; ++i)
+                memcpy(&interleaved[i].color, &m_Colors[i], sizeof(ColorVertex));
+            m_InterleavedBuffer->Update(m_InterleavedData.data(), (unsigned int)m_InterleavedData.size());
+            m_BytesPerFrame = (unsigned int)m_InterleavedData.size();
+        }
+        else
+        {
+            // swapped: write the buffer the last frame didn't draw from
+            VertexBuffer& colors = *m_ColorBuffer[m_Mode == SwappedStreams ? (m_Frame & 1) : 0];
+            colors.Update(m_Colors.data(), vertexCount * (unsigned int)sizeof(ColorVertex));
+            m_StreamVAO->SetBuffer(m_ColorBinding, colors);
+            m_BytesPerFrame = vertexCount * (unsigned int)sizeof(ColorVertex);
+        }
+        m_UploadMs = Milliseconds(Clock::now() - start).count();
+        ++m_Frame;
+    }
+
+    void TestVertexStreams::OnRender()
+    {
+        CALLGL(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+        CALLGL(glClear(GL_COLOR_BUFFER_BIT));
+
+        glm::mat4 proj = glm::perspective(glm::radians(45.0f), 960.0f / 540.0f, 0.1f, 10.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 1.6f, 1.8f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        m_Shader->Bind();
+        m_Shader->SetUniformMat4f("u_MVP", proj * view);
+
+        Renderer renderer;
+        renderer.Draw(m_Mode == Interleaved ? *m_InterleavedVAO : *m_StreamVAO, *m_IndexBuffer, *m_Shader);
+    }
+    void TestVertexStreams::OnImGuiRender()
+    {
+        if (ImGui::SliderInt("Grid size", &m_GridSize, 16, 1024))
+            BuildMesh();
+        ImGui::Combo("Mode", &m_Mode, ModeNames, ModeCount);
+
+        ImGui::Text("%s", VertexArray::HasAttribBinding() ? "ARB_vertex_attrib_binding" : "glVertexAttribPointer (3.3)");
+        ImGui::Text("%d vertices, %.2f MB uploaded per frame, %.3f ms", m_GridSize * m_GridSize,
+            m_BytesPerFrame / (1024.0f * 1024.0f), m_UploadMs);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    }
+}
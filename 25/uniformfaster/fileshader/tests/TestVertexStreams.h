@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Test.h"
+
+#include "../VertexArray.h"
+#include "../VertexBuffer.h"
+#include "../VertexBufferLayout.h"
+
+#include <memory>
+#include <vector>
+
+namespace test {
+
+	// a grid whose colors change every frame, re-uploading the whole
+	// interleaved vertex buffer against only the separate color stream
+	class TestVertexStreams : public Test
+	{
+	public:
+		TestVertexStreams();
+		~TestVertexStreams();
+
+		void OnUpdate(float deltatime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		enum Mode { Interleaved, SplitStreams, SwappedStreams, ModeCount };
+
+		void BuildMesh();
+		void UpdateColors();
+
+		// Interleaved: one buffer with everything
+		std::unique_ptr<VertexArray> m_InterleavedVAO;
+		std::unique_ptr<VertexBuffer> m_InterleavedBuffer;
+		// SplitStreams/SwappedStreams: static positions, normals and
+		// texcoords plus a dynamic color stream, two for swapping
+		std::unique_ptr<VertexArray> m_StreamVAO;
+		std::unique_ptr<VertexBuffer> m_StaticBuffer;
+		std::unique_ptr<VertexBuffer> m_ColorBuffer[2];
+		unsigned int m_ColorBinding;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Shader> m_Shader;
+
+		std::vector<unsigned char> m_InterleavedData;
+		std::vector<unsigned int> m_Colors;
+
+		int m_GridSize;
+		int m_Mode;
+		float m_Time;
+		unsigned int m_Frame;
+		unsigned int m_BytesPerFrame;
+		double m_UploadMs;
+	};
+} // namespace test
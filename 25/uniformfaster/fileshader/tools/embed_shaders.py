@@ -0,0 +1,198 @@
+"""Writes EmbeddedShaders.generated.inl from res/shaders.
+
+Runs as the pre-build event of fileshader.vcxproj:
+
+    python tools/embed_shaders.py <project dir> [--no-optimize]
+
+Every .shader file is split per stage with its #includes resolved, the same
+text ShaderPreprocessor::Process makes from the file before it adds the
+defines (the "#pragma defines" marker stays in), then run through
+glsl_optimizer.py unless --no-optimize is given. The output is only
+rewritten when it changed, so an untouched shader doesn't rebuild anything.
+"""
+
+import os
+import sys
+
+import glsl_optimizer
+
+SHADER_DIR = "res/shaders"
+OUTPUT = "EmbeddedShaders.generated.inl"
+# ShaderPreprocessor.cpp
+DEFINES_MARKER = "#pragma defines"
+MAX_INCLUDE_DEPTH = 32
+# MSVC fails on string literals over 64KB, even when pieced together
+MAX_STAGE_SIZE = 60000
+
+
+def read_lines(root, path):
+    with open(os.path.join(root, path), "r", newline=None) as f:
+        text = f.read()
+    lines = text.split("\n")
+    # getline doesn't return the empty piece after the last newline
+    if lines and lines[-1] == "":
+        lines.pop()
+    return lines
+
+
+def get_directory(path):
+    slash = max(path.rfind("/"), path.rfind("\\"))
+    return "" if slash < 0 else path[:slash + 1]
+
+
+def get_include_path(line):
+    trimmed = line.lstrip(" \t")
+    if not trimmed.startswith("#include"):
+        return ""
+    first = trimmed.find('"')
+    second = -1 if first < 0 else trimmed.find('"', first + 1)
+    if second < 0:
+        return ""
+    return trimmed[first + 1:second]
+
+
+def get_file_index(files, path):
+    if path not in files:
+        files.append(path)
+    return files.index(path)
+
+
+def append_include(root, path, out, included, files, depth):
+    if path in included:
+        return
+    included.add(path)
+    if depth > MAX_INCLUDE_DEPTH:
+        raise RuntimeError("shader includes nested too deep at '%s'" % path)
+    file_index = get_file_index(files, path)
+    out.append("#line 1 %d" % file_index)
+    for number, line in enumerate(read_lines(root, path), 1):
+        include = get_include_path(line)
+        if not include:
+            out.append(line)
+            continue
+        append_include(root, get_directory(path) + include, out, included, files, depth + 1)
+        out.append("#line %d %d" % (number + 1, file_index))
+
+
+def split_shader(root, path):
+    files = [path]
+    stages = [[], [], []]
+    included = [set(), set(), set()]
+    stage = -1
+    for number, line in enumerate(read_lines(root, path), 1):
+        if "#shader" in line:
+            if "vertex" in line:
+                stage = 0
+            elif "fragment" in line:
+                stage = 1
+            elif "compute" in line:
+                stage = 2
+            continue
+        if stage < 0:
+            continue
+        out = stages[stage]
+        include = get_include_path(line)
+        if include:
+            append_include(root, get_directory(path) + include, out, included[stage], files, 1)
+            out.append("#line %d 0" % (number + 1))
+        elif line.lstrip(" \t").startswith("#version"):
+            out.append(line)
+            out.append(DEFINES_MARKER)
+            out.append("#line %d 0" % (number + 1))
+        else:
+            out.append(line)
+    return ["".join(l + "\n" for l in lines) for lines in stages], files
+
+
+def fnv1a(stages):
+    """ShaderPreprocessor::Hash of the stages without defines"""
+    value = 14695981039346656037
+    # the compute stage only counts when there is one
+    for stage in stages[:2] + [s for s in stages[2:] if s]:
+        for byte in stage.replace(DEFINES_MARKER + "\n", "").encode("utf-8"):
+            value = ((value ^ byte) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+        value = ((value ^ 0xFF) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+def quote(text):
+    text = text.replace("\\", "\\\\").replace('"', '\\"')
+    return '"' + text.replace("\t", "\\t").replace("\n", "\\n") + '"'
+
+
+def write_literal(out, source, path):
+    if len(source) > MAX_STAGE_SIZE:
+        raise RuntimeError("'%s' has a stage over %d bytes" % (path, MAX_STAGE_SIZE))
+    if not source:
+        out.append('\t\t""')
+        return
+    # a literal per line, adjacent literals are joined by the compiler
+    lines = source.split("\n")[:-1]
+    out.extend("\t\t" + quote(line + "\n") for line in lines)
+
+
+def generate(root, optimize):
+    shaders = []
+    for directory, _, names in os.walk(os.path.join(root, SHADER_DIR)):
+        for name in names:
+            if name.endswith(".shader"):
+                path = os.path.relpath(os.path.join(directory, name), root).replace("\\", "/")
+                shaders.append(path)
+    shaders.sort()
+    if not shaders:
+        raise RuntimeError("no shaders in " + SHADER_DIR)
+
+    out = ["// generated by tools/embed_shaders.py from %s, don't edit" % SHADER_DIR,
+           "// included by EmbeddedShaders.h inside namespace EmbeddedShaders", ""]
+    entries = []
+    report = []
+    for index, path in enumerate(shaders):
+        stages, files = split_shader(root, path)
+        # caught here rather than as a Shader that never links at run time
+        for stage in stages:
+            for token in glsl_optimizer.find_reserved(stage):
+                raise RuntimeError("'%s' line %d uses the reserved word '%s'"
+                                   % (files[token.file], token.line, token.text))
+        source_hash = fnv1a(stages)
+        sources = [glsl_optimizer.optimize(s) if s and optimize else s for s in stages]
+        report.append("  %s %d -> %d bytes" % (path, sum(len(s) for s in stages), sum(len(s) for s in sources)))
+        out.append("inline constexpr const char* Files%d[] = { %s };" % (index, ", ".join(quote(f) for f in files)))
+        entry = ["\t{", "\t\t%s," % quote(path)]
+        # vertex, fragment, compute
+        for source in sources:
+            write_literal(entry, source, path)
+            entry[-1] += ","
+        entry.append("\t\tFiles%d, %d," % (index, len(files)))
+        entry.append("\t\t0x%016Xull" % source_hash)
+        entry.append("\t},")
+        entries.extend(entry)
+    out.append("")
+    out.append("inline constexpr Entry Table[] = {")
+    out.extend(entries)
+    out.append("};")
+    return "\n".join(out) + "\n", report
+
+
+def main():
+    args = [a for a in sys.argv[1:] if not a.startswith("--")]
+    root = args[0] if args else os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+    text, report = generate(root, "--no-optimize" not in sys.argv)
+    output = os.path.join(root, OUTPUT)
+    if os.path.exists(output):
+        with open(output, "r", newline=None) as f:
+            if f.read() == text:
+                return 0
+    with open(output, "w") as f:
+        f.write(text)
+    print("embedded shaders written to " + OUTPUT)
+    print("\n".join(report))
+    return 0
+
+
+if __name__ == "__main__":
+    try:
+        sys.exit(main())
+    except (OSError, RuntimeError) as error:
+        # file(line): error format shows up in the Visual Studio error list
+        print("embed_shaders.py(1): error: %s" % error)
+        sys.exit(1)
@@ -0,0 +1,551 @@
+"""Source level GLSL optimizer for embed_shaders.py.
+
+Works on one stage as ShaderPreprocessor splits it (includes resolved,
+#line directives in, defines still to come) and returns equivalent GLSL:
+
+  - comments and whitespace gone, #line kept exact so driver errors still
+    point at the right file and line
+  - functions nobody calls and uniforms and global consts nobody reads
+    removed
+  - arithmetic on two literals folded ("2.0 * 3.14159" -> "6.28318")
+  - functions that are a single return statement inlined at their calls
+
+The defines aren't known yet, so preprocessor lines are kept as they are
+and everything they mention counts as used. Anything it isn't sure about
+is left alone, the driver's own compiler still runs afterwards.
+"""
+
+import re
+
+DEFINES_MARKER = "#pragma defines"
+
+TOKEN = re.compile(r"""
+    (?P<space>[ \t\r]+)
+  | (?P<comment>//[^\n]*|/\*.*?\*/)
+  | (?P<newline>\n)
+  | (?P<number>(?:\d+\.\d*|\.\d+)(?:[eE][+-]?\d+)?[fF]?|\d+[eE][+-]?\d+[fF]?|0[xX][0-9a-fA-F]+[uU]?|\d+[uU]?)
+  | (?P<name>[A-Za-z_]\w*)
+  | (?P<op><<=|>>=|\+\+|--|<<|>>|<=|>=|==|!=|&&|\|\||\^\^|\+=|-=|\*=|/=|%=|&=|\|=|\^=|[^\s])
+""", re.VERBOSE | re.DOTALL)
+
+LINE_DIRECTIVE = re.compile(r"#\s*line\s+(\d+)(?:\s+(\d+))?")
+CONDITIONAL_OPEN = re.compile(r"#\s*if")
+CONDITIONAL_CLOSE = re.compile(r"#\s*endif")
+IDENTIFIER = re.compile(r"[A-Za-z_]\w*")
+
+BASIC_TYPES = {
+    "float", "vec2", "vec3", "vec4", "int", "ivec2", "ivec3", "ivec4",
+    "uint", "uvec2", "uvec3", "uvec4", "bool", "bvec2", "bvec3", "bvec4",
+    "mat2", "mat3", "mat4", "mat2x2", "mat2x3", "mat2x4", "mat3x2", "mat3x3",
+    "mat3x4", "mat4x2", "mat4x3", "mat4x4",
+}
+
+# what an inlined expression may use besides its parameters and globals
+BUILTIN_FUNCTIONS = {
+    "radians", "degrees", "sin", "cos", "tan", "asin", "acos", "atan", "sinh",
+    "cosh", "tanh", "asinh", "acosh", "atanh", "pow", "exp", "log", "exp2",
+    "log2", "sqrt", "inversesqrt", "abs", "sign", "floor", "trunc", "round",
+    "roundEven", "ceil", "fract", "mod", "modf", "min", "max", "clamp", "mix",
+    "step", "smoothstep", "isnan", "isinf", "length", "distance", "dot",
+    "cross", "normalize", "faceforward", "reflect", "refract",
+    "matrixCompMult", "outerProduct", "transpose", "determinant", "inverse",
+    "lessThan", "lessThanEqual", "greaterThan", "greaterThanEqual", "equal",
+    "notEqual", "any", "all", "not", "texture", "textureLod", "texelFetch",
+    "textureSize", "true", "false",
+}
+
+QUALIFIERS = {
+    "layout", "in", "out", "uniform", "const", "flat", "smooth", "noperspective",
+    "centroid", "invariant", "precision", "struct",
+}
+
+# reserved for future use since GLSL 1.30, a compile error as a name
+RESERVED_WORDS = {
+    "common", "partition", "active", "asm", "class", "union", "enum", "typedef",
+    "template", "this", "resource", "goto", "inline", "noinline", "public",
+    "static", "extern", "external", "interface", "long", "short", "half",
+    "fixed", "unsigned", "superp", "input", "output", "hvec2", "hvec3", "hvec4",
+    "fvec2", "fvec3", "fvec4", "sampler3DRect", "filter", "sizeof", "cast",
+    "namespace", "using",
+}
+
+ASSIGNMENTS = {"=", "+=", "-=", "*=", "/=", "%=", "<<=", ">>=", "&=", "|=", "^="}
+# tokens an expression can start after, so "a - 1.0 + 2.0" isn't folded
+EXPRESSION_START = {"(", ",", "[", "{", "?", ":", ";", "return"} | ASSIGNMENTS
+
+
+class Token:
+    __slots__ = ("text", "kind", "file", "line")
+
+    def __init__(self, text, kind, file, line):
+        self.text = text
+        self.kind = kind  # "name", "number", "op" or "directive"
+        self.file = file
+        self.line = line
+
+    def like(self, text, kind=None):
+        return Token(text, kind or self.kind, self.file, self.line)
+
+
+def tokenize(source):
+    tokens = []
+    file, line = 0, 1
+    for source_line in source.split("\n"):
+        stripped = source_line.strip()
+        if stripped.startswith("#"):
+            match = LINE_DIRECTIVE.match(stripped)
+            if match:
+                # numbers the line after it
+                line = int(match.group(1))
+                if match.group(2):
+                    file = int(match.group(2))
+                continue
+            # "#endif // LIT" -> "#endif"
+            directive = re.sub(r"\s*(//.*|/\*.*?\*/)\s*$", "", stripped)
+            tokens.append(Token(directive, "directive", file, line))
+            line += 1
+            continue
+        for match in TOKEN.finditer(source_line):
+            kind = match.lastgroup
+            if kind in ("space", "comment", "newline"):
+                continue
+            tokens.append(Token(match.group(), kind, file, line))
+        line += 1
+    return tokens
+
+
+def strip_block_comments(source):
+    # block comments can span lines, keep the newlines so line numbers hold
+    return re.sub(r"/\*.*?\*/", lambda m: "\n" * m.group().count("\n"), source, flags=re.DOTALL)
+
+
+# top level items: a declaration up to its ";", a function up to its "}"
+# or a single preprocessor line
+
+class Item:
+    def __init__(self, tokens, conditional):
+        self.tokens = tokens
+        self.conditional = conditional
+        self.kind = "other"
+        self.names = []
+        self.removed = False
+        directive = tokens[0].kind == "directive"
+        if directive:
+            self.kind = "directive"
+            return
+        texts = [t.text for t in tokens]
+        if "{" in texts and ")" in texts and texts[-1] == "}" and texts[texts.index("{") - 1] == ")":
+            paren = texts.index("(")
+            self.kind = "function"
+            self.names = [texts[paren - 1]]
+        elif "{" in texts:
+            self.kind = "other"  # struct or interface block
+        elif "uniform" in texts or (texts[0] == "const" and "=" in texts):
+            self.kind = "uniform" if "uniform" in texts else "const"
+            self.names = declared_names(tokens)
+        elif len(texts) > 3 and texts[2] == "(" and "=" not in texts and texts[0] not in QUALIFIERS:
+            # a prototype, removed with its function
+            self.kind = "prototype"
+            self.names = [texts[1]]
+
+
+def declared_names(tokens):
+    """the names in "uniform vec4 a, b[2];" or "const float c = 1.0, d = 2.0;" """
+    names = []
+    depth = 0
+    expect_name = False
+    texts = [t.text for t in tokens]
+    for i, text in enumerate(texts):
+        if depth == 0:
+            # the first declarator is the token before the first "=", "[", "," or ";"
+            if text in ("=", "[", ",", ";") and not names:
+                names.append(texts[i - 1])
+            elif expect_name and tokens[i].kind == "name":
+                names.append(text)
+                expect_name = False
+            if text == ",":
+                expect_name = True
+        if text in ("(", "["):
+            depth += 1
+        elif text in (")", "]"):
+            depth -= 1
+    return names
+
+
+def split_items(tokens):
+    items = []
+    current = []
+    depth = 0
+    conditional = 0
+    for token in tokens:
+        if token.kind == "directive" and depth == 0 and not current:
+            if CONDITIONAL_CLOSE.match(token.text):
+                conditional -= 1
+            items.append(Item([token], conditional > 0))
+            if CONDITIONAL_OPEN.match(token.text):
+                conditional += 1
+            continue
+        current.append(token)
+        if token.text == "{":
+            depth += 1
+        elif token.text == "}":
+            depth -= 1
+            texts = [t.text for t in current]
+            # a function ends at its brace, struct and blocks at the ";" after it
+            if depth == 0 and texts[texts.index("{") - 1] == ")":
+                items.append(Item(current, conditional > 0))
+                current = []
+        elif token.text == ";" and depth == 0:
+            items.append(Item(current, conditional > 0))
+            current = []
+    if current:
+        items.append(Item(current, conditional > 0))
+    return items
+
+
+def identifiers(item):
+    """the names an item mentions, not counting what it declares"""
+    found = []
+    declaring = set(item.names)
+    for i, token in enumerate(item.tokens):
+        if token.kind == "directive":
+            found.extend(IDENTIFIER.findall(token.text))
+        elif token.kind == "name":
+            if i > 0 and item.tokens[i - 1].text == ".":
+                continue  # a field or swizzle
+            if token.text in declaring:
+                declaring.discard(token.text)
+                continue
+            found.append(token.text)
+    return found
+
+
+def remove_unused(items):
+    while True:
+        used = set()
+        for item in items:
+            if not item.removed:
+                used.update(identifiers(item))
+        changed = False
+        for item in items:
+            if item.removed or item.kind not in ("function", "prototype", "uniform", "const"):
+                continue
+            if "main" in item.names:
+                continue
+            if not any(name in used for name in item.names):
+                item.removed = True
+                changed = True
+        if not changed:
+            return
+
+
+# constant folding
+
+def parse_number(text):
+    """(value, is_float) or None for what isn't worth folding"""
+    if text[-1] in "uU" or text.lower().startswith("0x"):
+        return None
+    if re.fullmatch(r"\d+", text):
+        return int(text), False
+    return float(text.rstrip("fF")), True
+
+
+def format_float(value):
+    text = repr(value)
+    if "inf" in text or "nan" in text:
+        return None
+    if "e" not in text and "." not in text:
+        text += ".0"
+    return text
+
+
+def fold_constants(tokens):
+    changed = True
+    while changed:
+        changed = False
+        for i in range(len(tokens) - 2):
+            a, op, b = tokens[i], tokens[i + 1], tokens[i + 2]
+            # "x * (4.5)" -> "x * 4.5", not the parentheses of a call
+            if a.text == "(" and op.kind == "number" and b.text == ")" and i > 0:
+                if tokens[i - 1].kind == "op" and tokens[i - 1].text not in (")", "]"):
+                    tokens[i:i + 3] = [op]
+                    changed = True
+                    break
+            if a.kind != "number" or b.kind != "number" or op.text not in "+-*/" or len(op.text) != 1:
+                continue
+            before = tokens[i - 1].text if i > 0 else ";"
+            after = tokens[i + 3].text if i + 3 < len(tokens) else ";"
+            if after in (".", "[", "++", "--"):
+                continue
+            if op.text in "*/":
+                # "x / 2.0 * 3.0" is (x / 2.0) * 3.0, "x * -2.0 * 3.0" the same
+                if before in ("+", "-"):
+                    if i > 1 and tokens[i - 2].text in ("*", "/", "%"):
+                        continue
+                elif before not in EXPRESSION_START:
+                    continue
+            elif before not in EXPRESSION_START or after in ("*", "/", "%"):
+                continue
+            left, right = parse_number(a.text) or (None, None), parse_number(b.text) or (None, None)
+            if left[0] is None or right[0] is None or left[1] != right[1]:
+                continue
+            is_float = left[1]
+            if op.text == "/" and (not is_float or right[0] == 0.0):
+                continue
+            value = {"+": lambda x, y: x + y, "-": lambda x, y: x - y,
+                     "*": lambda x, y: x * y, "/": lambda x, y: x / y}[op.text](left[0], right[0])
+            if is_float:
+                text = format_float(value)
+            else:
+                text = str(value) if -2 ** 31 <= value < 2 ** 31 else None
+            if text is None:
+                continue
+            if text.startswith("-"):
+                # keep "a = -1.0" from turning into "a=-1.0" next to another "-"
+                if before in ("-", "+"):
+                    continue
+                tokens[i:i + 3] = [a.like("-", "op"), a.like(text[1:], "number")]
+            else:
+                tokens[i:i + 3] = [a.like(text, "number")]
+            changed = True
+            break
+    return tokens
+
+
+# inlining
+
+def parse_inline_function(item):
+    """(name, return type, [(type, name)], expression tokens) or None"""
+    texts = [t.text for t in item.tokens]
+    if item.conditional or texts[0] not in BASIC_TYPES:
+        return None
+    if len(texts) < 8 or texts[2] != "(":
+        return None
+    close = texts.index(")")
+    body = texts[close + 1:]
+    if body[:2] != ["{", "return"] or body[-2:] != [";", "}"] or body.count(";") != 1:
+        return None
+    params = []
+    if close > 3 and not (close == 4 and texts[3] == "void"):
+        for param in " ".join(texts[3:close]).split(" , "):
+            words = param.split(" ")
+            if words[0] == "in":
+                words = words[1:]
+            if len(words) != 2 or words[0] not in BASIC_TYPES:
+                return None  # out, inout, arrays, structs
+            params.append((words[0], words[1]))
+    expression = item.tokens[close + 3:-2]
+    if any(t.kind == "directive" for t in expression):
+        return None
+    return texts[1], texts[0], params, expression
+
+
+def find_locals(items):
+    """names declared inside any function, they could hide a global"""
+    names = set()
+    for item in items:
+        if item.kind != "function":
+            continue
+        tokens = item.tokens
+        for i in range(1, len(tokens)):
+            if tokens[i].kind == "name" and tokens[i - 1].text in BASIC_TYPES and i > 1:
+                names.add(tokens[i].text)
+    return names
+
+
+def inline_functions(items):
+    """true when a call was inlined"""
+    functions = {}
+    defined = {}
+    globals_ = set()
+    for item in items:
+        if item.removed:
+            continue
+        for name in item.names:
+            defined[name] = defined.get(name, 0) + 1
+        if item.kind in ("uniform", "const"):
+            globals_.update(item.names)
+        elif item.kind == "other":
+            # inputs and outputs: the name before the ";"
+            texts = [t.text for t in item.tokens]
+            if texts[-1] == ";" and ("in" in texts or "out" in texts) and "{" not in texts:
+                globals_.add(texts[-2])
+    safe_globals = globals_ - find_locals(items)
+
+    for item in items:
+        if item.removed or item.kind != "function" or item.names[0] == "main":
+            continue
+        parsed = parse_inline_function(item)
+        if not parsed or defined.get(parsed[0]) != 1:
+            continue
+        name, return_type, params, expression = parsed
+        param_names = {p[1] for p in params}
+        ok = True
+        for i, token in enumerate(expression):
+            if token.kind != "name" or token.text in param_names:
+                continue
+            if i > 0 and expression[i - 1].text == ".":
+                continue
+            if token.text not in BUILTIN_FUNCTIONS and token.text not in BASIC_TYPES and token.text not in safe_globals:
+                ok = False
+                break
+        if ok:
+            functions[name] = (return_type, params, expression)
+
+    inlined = False
+    for item in items:
+        if item.removed or item.kind != "function" or not functions:
+            continue
+        body = [t.text for t in item.tokens].index("{")
+        for _ in range(64):
+            if not inline_one_call(item.tokens, body, functions):
+                break
+            inlined = True
+    return inlined
+
+
+def split_arguments(tokens, open_index):
+    """the argument token lists and the index of the closing parenthesis"""
+    args = [[]]
+    depth = 0
+    for i in range(open_index + 1, len(tokens)):
+        text = tokens[i].text
+        if tokens[i].kind == "directive":
+            return None, None
+        if text in ("(", "[", "{"):
+            depth += 1
+        elif text in (")", "]", "}"):
+            if depth == 0:
+                return ([] if args == [[]] else args), i
+            depth -= 1
+        elif text == "," and depth == 0:
+            args.append([])
+            continue
+        args[-1].append(tokens[i])
+    return None, None
+
+
+def inline_one_call(tokens, start, functions):
+    for i in range(start, len(tokens) - 1):
+        token = tokens[i]
+        if token.kind != "name" or token.text not in functions or tokens[i + 1].text != "(":
+            continue
+        if tokens[i - 1].text == "." or tokens[i - 1].text in BASIC_TYPES:
+            continue
+        return_type, params, expression = functions[token.text]
+        args, close = split_arguments(tokens, i + 1)
+        if args is None or len(args) != len(params):
+            continue
+        # an argument with side effects has to run exactly once
+        if any(t.text in ASSIGNMENTS or t.text in ("++", "--") for a in args for t in a):
+            continue
+        uses = {}
+        for t in expression:
+            if t.kind == "name":
+                uses[t.text] = uses.get(t.text, 0) + 1
+        # an argument used twice would be evaluated twice
+        if any(uses.get(p[1], 0) > 1 and len(a) > 1 for p, a in zip(params, args)):
+            continue
+        replacement = [token.like(return_type, "name"), token.like("(", "op")]
+        names = {p[1]: (p[0], a) for p, a in zip(params, args)}
+        for j, t in enumerate(expression):
+            if t.kind == "name" and t.text in names and not (j > 0 and expression[j - 1].text == "."):
+                param_type, arg = names[t.text]
+                if param_type == "float" and len(arg) == 1 and arg[0].kind == "number" and "." in arg[0].text:
+                    replacement.append(token.like(arg[0].text, "number"))
+                else:
+                    # the call would have converted it, "float f(float x)" called with an int
+                    replacement.append(token.like(param_type, "name"))
+                    replacement.append(token.like("(", "op"))
+                    replacement.extend(token.like(a.text, a.kind) for a in arg)
+                    replacement.append(token.like(")", "op"))
+            else:
+                replacement.append(token.like(t.text, t.kind))
+        replacement.append(token.like(")", "op"))
+        tokens[i:close + 1] = replacement
+        return True
+    return False
+
+
+# output
+
+def is_word(c):
+    return c.isalnum() or c == "_"
+
+
+def needs_space(previous, text):
+    if previous is None:
+        return False
+    if is_word(previous[-1]) and (is_word(text[0]) or (text[0] == "." and len(text) > 1)):
+        return True
+    return previous[-1] + text[0] in ("++", "--", "+=", "-=", "//", "/*", "&&", "||", "==",
+                                      "<<", ">>", "<=", ">=", "!=", "^^", "*=", "/=", "&=", "|=", "^=", "%=")
+
+
+def write(tokens):
+    out = []
+    line = []
+    previous = None
+    # (file, line) in the sources of the output line being written
+    position = None
+    force_line = False
+    for token in tokens:
+        place = (token.file, token.line)
+        if line and place == position and token.kind != "directive":
+            if needs_space(previous, token.text):
+                line.append(" ")
+            line.append(token.text)
+            previous = token.text
+            continue
+        if line:
+            out.append("".join(line))
+            line = []
+            position = (position[0], position[1] + 1)
+
+        if position is None:
+            # #version has to come first, numbering starts after it
+            position = place
+        elif force_line or place != position:
+            gap = place[1] - position[1]
+            if not force_line and place[0] == position[0] and 0 < gap <= 2:
+                out.extend([""] * gap)
+            else:
+                out.append("#line %d %d" % (place[1], place[0]))
+            position = place
+            force_line = False
+
+        if token.kind == "directive":
+            out.append(token.text)
+            position = (position[0], position[1] + 1)
+            # the defines replace the marker, the lines after it are numbered again
+            force_line = token.text == DEFINES_MARKER
+            continue
+        line = [token.text]
+        previous = token.text
+    if line:
+        out.append("".join(line))
+    return "".join(l + "\n" for l in out)
+
+
+def find_reserved(source):
+    """the tokens of a stage that use a reserved word, which no driver links"""
+    return [t for t in tokenize(strip_block_comments(source))
+            if t.kind == "name" and t.text in RESERVED_WORDS]
+
+
+def optimize(source):
+    tokens = tokenize(strip_block_comments(source))
+    if not tokens:
+        return source
+    items = split_items(tokens)
+    remove_unused(items)
+    # a function is only inlined once the calls in it are, go until nothing changes
+    for _ in range(8):
+        if not inline_functions(items):
+            break
+        remove_unused(items)
+    result = []
+    for item in items:
+        if not item.removed:
+            result.extend(item.tokens)
+    return write(fold_constants(result))